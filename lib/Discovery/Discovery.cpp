@@ -0,0 +1,122 @@
+/*!
+* @brief Class to make each rotator findable on the LAN, and to broadcast its status
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <ESPmDNS.h>
+#include "Discovery.h"
+#include "Status.h"
+#include "Easycomm.h"
+
+static const char SERVICE[] = "satnogs-rot";	//< mDNS service, _satnogs-rot._tcp on the web server port
+
+/*! @brief class constructor; names the board, mDNS starts once WiFi connects
+*/
+Discovery::Discovery()
+{
+	uint8_t _mac[6];
+	WiFi.macAddress (_mac);
+	snprintf (name, sizeof(name), HOST_PREFIX "%02x%02x%02x", _mac[3], _mac[4], _mac[5]);
+	started = false;
+	last_beacon = last_txt = millis();
+	txt_cal[0] = txt_point[0] = '\0';
+}
+
+/*! @brief call periodically from loop() to start mDNS, refresh the TXT records and send beacons
+*/
+void Discovery::service()
+{
+	if (WiFi.status() != WL_CONNECTED) {
+	    return;
+	}
+	if (!started) {
+	    begin();
+	}
+	uint32_t _now = millis();
+	if (_now - last_txt >= TXT_INTERVAL) {
+	    last_txt = _now;
+	    updateTxt();
+	}
+	if (BEACON_INTERVAL > 0 && _now - last_beacon >= BEACON_INTERVAL) {
+	    last_beacon = _now;
+	    sendBeacon();
+	}
+}
+
+/*! @brief start the mDNS responder and advertise our services
+*
+* The responder follows WiFi reconnects by itself, so this only runs once.
+*/
+void Discovery::begin()
+{
+	if (!MDNS.begin (name)) {
+	    Serial.println ("Error setting up MDNS responder!");
+	    return;							//< try again next service()
+	}
+	started = true;
+	Serial.printf ("mDNS responder started as %s.local\n", name);
+	MDNS.addService ("http", "tcp", 80);
+	MDNS.addService (SERVICE, "tcp", 80);
+	MDNS.addServiceTxt (SERVICE, "tcp", "fw", FIRMWARE_VERSION);
+	char _port[8];
+	snprintf (_port, sizeof(_port), "%u", ROTCTL_PORT);
+	MDNS.addServiceTxt (SERVICE, "tcp", "rotctl", _port);
+	char _beacon[24];
+	IPAddress _group (BEACON_GROUP);
+	snprintf (_beacon, sizeof(_beacon), "%u.%u.%u.%u:%u", _group[0], _group[1], _group[2], _group[3], BEACON_PORT);
+	MDNS.addServiceTxt (SERVICE, "tcp", "beacon", BEACON_INTERVAL > 0 ? _beacon : "none");
+	updateTxt();
+}
+
+/*! @brief advertise calibration state and pointing, if changed since last time
+*
+* Each change makes the responder announce again, so pointing is only as fine as a browser
+* listing rotators needs; collectors wanting more listen to the beacon.
+*/
+void Discovery::updateTxt()
+{
+	StatusRecord _s;
+	buildStatus (_s);
+	char _cal[sizeof(txt_cal)], _point[sizeof(txt_point)];
+	snprintf (_cal, sizeof(_cal), "sensor=%s gimbal=%s",
+		    !(_s.flags & ST_SENSOR_FOUND) ? "none" : (_s.flags & ST_SENSOR_CALOK) ? "ok" : "no",
+		    (_s.flags & ST_CALIBRATING) ? "running" : (_s.flags & ST_GIMBAL_CALOK) ? "ok" : "no");
+	snprintf (_point, sizeof(_point), "%.0f,%.0f", _s.az, _s.el);
+	if (strcmp (_cal, txt_cal) != 0) {
+	    strcpy (txt_cal, _cal);
+	    MDNS.addServiceTxt (SERVICE, "tcp", "cal", txt_cal);
+	}
+	if (strcmp (_point, txt_point) != 0) {
+	    strcpy (txt_point, _point);
+	    MDNS.addServiceTxt (SERVICE, "tcp", "azel", txt_point);
+	}
+}
+
+/*! @brief send one status beacon: the StatusRecord, then our hostname with its EOS
+*
+* Readers find the hostname at StatusRecord.size, so it stays put as the record grows.
+*/
+void Discovery::sendBeacon()
+{
+	StatusRecord _s;
+	buildStatus (_s);
+	if (udp.beginPacket (IPAddress (BEACON_GROUP), BEACON_PORT)) {
+	    udp.write ((const uint8_t *)&_s, sizeof(_s));
+	    udp.write ((const uint8_t *)name, strlen (name) + 1);
+	    udp.endPacket();
+	}
+}
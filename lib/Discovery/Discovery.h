@@ -0,0 +1,61 @@
+/*!
+* @brief Class to make each rotator findable on the LAN, and to broadcast its status
+*
+* Advertises a hostname unique to the board, from the last three bytes of its MAC address,
+* and a _satnogs-rot._tcp service whose TXT records carry the firmware version, rotctl port, calibration
+* state and pointing. A StatusRecord is also sent to a multicast group every BEACON_INTERVAL,
+* so one collector can watch a whole fleet without polling each web server.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DISCOVERY_H
+#define _DISCOVERY_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#define FIRMWARE_VERSION  "1.1"				///<  advertised in the fw TXT record
+#define HOST_PREFIX       "satnogs-rot-"	///<  hostname is this and 6 hex digits of MAC, e.g. satnogs-rot-a1b2c3.local
+#define BEACON_GROUP      239,255,13,81		///<  multicast group for the status beacon, organization-local scope
+#define BEACON_PORT       13810				///<  UDP port of the status beacon
+#define BEACON_INTERVAL   5000				///<  milliseconds between status beacons, 0 for none
+
+class Discovery {
+
+    public:
+	Discovery();
+	void service();
+	const char *hostname() { return (name); };
+
+    private:
+	static const uint16_t TXT_INTERVAL = 10000;	// ms between checks for changed TXT records
+	char name[24];						//< our hostname, without .local
+	bool started;						//< mDNS is running
+	uint32_t last_beacon;				//< millis() of the last beacon
+	uint32_t last_txt;					//< millis() of the last TXT record check
+	char txt_cal[32];					//< TXT values as last advertised, to only update changes;
+	char txt_point[24];					//<   txt_cal holds up to "sensor=none gimbal=running"
+	WiFiUDP udp;
+	void begin();
+	void updateTxt();
+	void sendBeacon();
+};
+
+extern Discovery *discovery;
+
+#endif // _DISCOVERY_H
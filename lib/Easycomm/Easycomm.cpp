@@ -17,202 +17,904 @@
 * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include <stdarg.h>
 #include "Easycomm.h"
 #include "Gimbal.h"
 #include "NV.h"
 #include "Webpage.h"
 #include "Sensor.h"
+#include "Tracker.h"
+#include "Status.h"
+#include "Metrics.h"
+#include "Power.h"
 
-char buffer[BUFFER_SIZE];
+char buffer[BUFFER_SIZE];   //< last complete command, for the web page
+static const char EC_VERSION[] = "SatNOGS-v2.2";   //< reported to VE and to rotctld's get_info
 
-/*! @brief Read new commands on USB serial interface
+//< rotctld's long command names, as "\\get_pos", and the letters they stand for
+static const struct {
+    const char *name;
+    char letter;
+} HAMLIB_NAMES[] = {
+    { "get_pos", 'p' }, { "set_pos", 'P' }, { "stop", 'S' }, { "park", 'K' }, { "move", 'M' },
+    { "reset", 'R' }, { "get_info", '_' }, { "dump_state", '1' }, { "quit", 'q' },
+};
+//< hamlib rot_move() directions
+enum {
+    ROT_MOVE_UP = 2, ROT_MOVE_DOWN = 4, ROT_MOVE_LEFT = 8, ROT_MOVE_RIGHT = 16, ROT_MOVE_CCW = 32, ROT_MOVE_CW = 64,
+};
+
+/*! @brief class constructor
+ */
+Easycomm::Easycomm()
+{
+    n_history = 0;
+    next_history = 0;
+    have_input = false;
+    task = NULL;
+    dropped = 0;
+    for (uint8_t i = 0; i < N_LINKS; i++) {
+        links[i].port = NULL;
+        links[i].line_len = 0;
+        links[i].session = 0;
+        links[i].quit = false;
+        links[i].last = 0;
+    }
+    links[0].port = &Serial;
+    cur = &links[0];
+    links_lock = xSemaphoreCreateMutex();
+    server = new WiFiServer(ROTCTL_PORT, ROTCTL_SESSIONS);
+    server->setNoDelay(true);
+    server->begin();
+    last_accept = millis();
+    reply_len = 0;
+    have_snapshot = false;
+    buffer[0] = '\0';
+    queue = xQueueCreate(QUEUE_LENGTH, sizeof(Command));
+}
+
+/*! @brief start receiving on the serial port from a dedicated task
+*
+* Without the task, easycomm_process() polls the port itself.
+* @return true if the task is running
+*/
+bool Easycomm::startTask()
+{
+    if (task != NULL) {
+        return (true);
+    }
+    if (queue == NULL || xTaskCreatePinnedToCore(serialTask, "Easycomm", TASK_STACK, this, TASK_PRIORITY, &task, TASK_CORE) != pdPASS) {
+        task = NULL;
+    }
+    return (task != NULL);
+}
+
+/*! @brief body of the serial task, takes whatever has arrived within a tick of its arrival
+*
+* @param arg the Easycomm instance
+*/
+void Easycomm::serialTask(void *arg)
+{
+    Easycomm *_e = (Easycomm *)arg;
+    for (;;) {
+        _e->receiveAll();
+        vTaskDelay(1);
+    }
+}
+
+/*! @brief take everything buffered on the serial port and each TCP session
+*/
+void Easycomm::receiveAll()
+{
+    acceptSessions();
+    for (uint8_t i = 0; i < N_LINKS; i++) {
+        if (links[i].port != NULL && links[i].port->available() > 0) {
+            receiveLink(links[i]);
+        }
+    }
+}
+
+/*! @brief take everything buffered on one link as one burst
+*
+* Every query in the burst is answered from the same Sensor sample, and all the replies
+* go out in one write at the end.
+* @param l the link with bytes waiting
+*/
+void Easycomm::receiveLink(Link &l)
+{
+    uint32_t _t0 = Metrics::start();
+    cur = &l;
+    have_snapshot = false;
+    l.last = millis();
+    while (l.port->available() > 0) {
+        receive(l.port->read());
+    }
+    flushReplies();
+    if (l.quit) {
+        xSemaphoreTake(links_lock, portMAX_DELAY);
+        l.client.stop();
+        l.port = NULL;
+        xSemaphoreGive(links_lock);
+    }
+    metrics->stop(M_SERIAL_RX, _t0);
+}
+
+/*! @brief every ACCEPT_INTERVAL, drop closed TCP sessions and take new ones
+*
+* Nagle is off so each burst of replies goes out at once. With every slot taken, a new
+* connection replaces the session that has been quiet longest, which is most likely a host that
+* went away without closing. A client is only replaced or stopped under links_lock, so a reply
+* execute() is writing to it from loop() never lands on a freed or reused socket.
+*/
+void Easycomm::acceptSessions()
+{
+    uint32_t _now = millis();
+    if (_now - last_accept < ACCEPT_INTERVAL) {
+        return;
+    }
+    last_accept = _now;
+    xSemaphoreTake(links_lock, portMAX_DELAY);
+    for (uint8_t i = 1; i < N_LINKS; i++) {
+        if (links[i].port != NULL && !links[i].client.connected()) {
+            links[i].client.stop();
+            links[i].port = NULL;
+        }
+    }
+    WiFiClient _client;
+    while ((_client = server->available())) {
+        Link *_lp = &links[1];
+        for (uint8_t i = 1; i < N_LINKS; i++) {
+            if (links[i].port == NULL) {
+                _lp = &links[i];
+                break;
+            }
+            if (_now - links[i].last > _now - _lp->last) {
+                _lp = &links[i];
+            }
+        }
+        if (_lp->port != NULL) {
+            _lp->client.stop();
+        }
+        _lp->client = _client;
+        _lp->client.setNoDelay(true);
+        _lp->port = &_lp->client;
+        _lp->line_len = 0;
+        _lp->session++;
+        _lp->quit = false;
+        _lp->last = _now;
+        power->activity();                          //< a host that connects is about to start a pass
+    }
+    xSemaphoreGive(links_lock);
+}
+
+/*! @brief run commands received on USB serial interface
+*
+* Reads the port itself if the serial task is not running, then executes queued commands.
+* Back to back positioning commands are merged so only the latest target moves the Gimbal.
+*/
+void Easycomm::easycomm_process() 
+{
+    if (task == NULL) {
+        receiveAll();
+    }
+    uint32_t _t0 = Metrics::start();
+    Command _c, _move;
+    bool _have_move = false;
+    while (xQueueReceive(queue, &_c, 0) == pdTRUE) {
+        if ((_c.act & ~(ACT_AZ | ACT_EL)) == 0) {
+            //< positioning only: a later AZ or EL replaces an earlier one
+            if (!_have_move) {
+                _move = _c;
+                _have_move = true;
+            }
+            if (_c.act & ACT_AZ) {
+                _move.act |= ACT_AZ;
+                _move.az = _c.az;
+            }
+            if (_c.act & ACT_EL) {
+                _move.act |= ACT_EL;
+                _move.el = _c.el;
+            }
+            continue;
+        }
+        //< anything else runs in order, after the moves that came before it
+        if (_have_move) {
+            execute(_move);
+            _have_move = false;
+        }
+        execute(_c);
+    }
+    if (_have_move) {
+        execute(_move);
+    }
+    metrics->stop(M_EASYCOMM, _t0);
+}
+
+/*! @brief assemble a command line one byte at a time, on the current link
 *
 * '\n' is new-line command terminator for positioning commands 
 * commands like IP, GE are terminated with carriage return '\r'
+* @param c the next byte from the serial port or session
 */
-void Easycomm::easycomm_process() 
+void Easycomm::receive(char c)
+{
+    char *_line = cur->line;
+    if (c == '\n' || c == '\r') {
+        if (cur->line_len == 0) {
+            //< second half of a "\r\n"
+            return;
+        }
+        _line[cur->line_len] = '\0';
+        memcpy(buffer, _line, cur->line_len + 1);
+        dispatch(_line, cur->line_len);
+        cur->line_len = 0;
+    } else {
+        //< Did not get a command terminator, add incoming byte to line
+        _line[cur->line_len++] = c;
+        //< don't overflow line[], leave room for the terminator
+        if (cur->line_len >= BUFFER_SIZE) {
+            metrics->count(C_SERIAL_OVERFLOW, cur->line_len);
+            cur->line_len = 0;
+        }
+    }
+}
+
+/*! @brief split a command line into its Easycomm II/III commands, without copying it
+*
+* Each space-separated token starts with a two-letter command, optionally followed by a number,
+* e.g. "AZ180.0 EL45.0", "AZ EL", "EL30", "SA SE", "IP0".
+* A command this rotator does not have is answered "RPRT -1", as CR and CW are.
+* @param command the line, '\0' terminated
+* @param len strlen(command)
+* @param c receives what the line asks for
+*/
+void Easycomm::parse(char command[], uint16_t len, Command &c)
 {
-    float az_input, el_input;
-    char incomingByte;
-    static uint16_t bufferCnt = 0;
-    //< Read from serial
-    while (Serial.available() > 0) {
-        incomingByte = Serial.read();
-
-        if (incomingByte == '\n' || incomingByte == '\r') {
-            //< process command
-
-            buffer[bufferCnt] = 0;
-            if (buffer[0] == 'A' && buffer[1] == 'Z' && buffer[2] ==  ' ' 
-                    && buffer[3] == 'E' && buffer[4] == 'L') {
-            //< read 'AZ EL ' and do reportPosition() right away
-                reportPosition();
-            } else if (buffer[0] == 'A' && buffer[1] == 'Z') {
-            //< positioning command
-                if (buffer[2] != ' ') {
-                //< There was data after "AZ", get the absolute position in deg for azimuth
-                //< There is a command "AZ EL" (p) that just asks for the current position.
-                    if (readAzEl(&az_input, &el_input, buffer)){
-                        gimbal->moveToAzEl(az_input, el_input);        
-                    }
-                    reportPosition();
-                } else {
-                    //< no az/el goto data, just report position to acknowledge command
-                    reportPosition();
-                }
-            } else if (buffer[0] == 'S' && buffer[1] == 'A' 
-                && buffer[2] == ' ' && buffer[3] == 'S' && buffer[4] == 'E') {
-                //< SA SE: Stop Moving
-                reportPosition();
-            } else if (buffer[0] == 'R' && buffer[1] == 'E' && buffer[2] == 'S' 
-                && buffer[3] == 'E' && buffer[4] == 'T') {
-                //< Reset the rotator, go to home position
-                reportPosition();
-                ESP.restart();
-            } else if (buffer[0] == 'P' && buffer[1] == 'A' 
-                && buffer[2] == 'R' && buffer[3] == 'K') {
-                //< Park the rotator
-                gimbal->moveToAzEl(0.0, 0.0);
-                reportPosition();
-            } else if (buffer[0] == 'V' && buffer[1] == 'E') {
-                //< Get the version of rotator controller
-                Serial.print("VESatNOGS-v2.2\n RPRT 0\n");
-            } else if (buffer[0] == 'I' && buffer[1] == 'P') {
-                //< status command
-                dealWithStatusCommand(buffer[2]);
-
-            } else if (buffer[0] == 'G' && buffer[1] == 'S') {
-                //< Get the status of rotator
-                Serial.print("GS, 0\n RPRT 0\n");
-
-            } else if (buffer[0] == 'G' && buffer[1] == 'E') {
-                //< Get the error of rotator
-                Serial.print("GE, 0\n RPRT 0\n");
+    c.act = 0;
+    c.ask = 0;
+    c.jog_az = c.jog_el = 0;
+    c.hamlib = false;
+    const char *_p = command;
+    const char *_end = command + len;
+    while (_p < _end) {
+        while (*_p == ' ') {
+            _p++;
+        }
+        const char *_tok = _p;
+        while (_p < _end && *_p != ' ') {
+            _p++;
+        }
+        if (_p - _tok < 2) {
+            continue;
+        }
+        float _v;
+        bool _num = parseNumber(_tok + 2, _p, &_v);
+        switch (OPCODE(_tok[0], _tok[1])) {
+        case OPCODE('A', 'Z'):
+            //< AZnnn.n sets azimuth, AZ alone asks for it
+            if (_num) {
+                c.act |= ACT_AZ;
+                c.az = _v;
             }
-            //< After dealing with command, reset the buffer counter & clean the serial buffer
-            bufferCnt = 0;
-        } else {
-            //< Did not get a command terminator, add incoming byte to buffer
-            buffer[bufferCnt] = incomingByte;
-            bufferCnt++;
-            //< don't overflow buffer[]
-            if (bufferCnt >= BUFFER_SIZE) {
-                bufferCnt = 0;
+            c.ask |= ASK_AZ;
+            break;
+        case OPCODE('E', 'L'):
+            //< ELnn.n sets elevation, EL alone asks for it
+            if (_num) {
+                c.act |= ACT_EL;
+                c.el = _v;
             }
+            c.ask |= ASK_EL;
+            break;
+        case OPCODE('S', 'A'):
+        case OPCODE('S', 'E'):
+            //< Stop Moving
+            c.act |= ACT_STOP;
+            c.ask |= ASK_AZ | ASK_EL;
+            break;
+        case OPCODE('M', 'L'):
+        case OPCODE('M', 'R'):
+            c.act |= ACT_JOG;
+            c.jog_az = _tok[1] == 'R' ? 1 : -1;
+            c.ask |= ASK_AZ | ASK_EL;
+            break;
+        case OPCODE('M', 'U'):
+        case OPCODE('M', 'D'):
+            c.act |= ACT_JOG;
+            c.jog_el = _tok[1] == 'U' ? 1 : -1;
+            c.ask |= ASK_AZ | ASK_EL;
+            break;
+        case OPCODE('V', 'E'):
+            //< Get the version of rotator controller
+            c.ask |= ASK_VERSION;
+            break;
+        case OPCODE('I', 'P'):
+            //< status command
+            c.ask |= ASK_STATUS;
+            c.status = _p - _tok > 2 ? _tok[2] : ' ';
+            break;
+        case OPCODE('G', 'S'):
+            //< Get the status of rotator
+            c.ask |= ASK_GS;
+            break;
+        case OPCODE('G', 'E'):
+            //< Get the error of rotator
+            c.ask |= ASK_GE;
+            break;
+        case OPCODE('S', 'B'):
+            //< extension: binary status record, as /status.bin
+            c.ask |= ASK_STATUS_BIN;
+            break;
+        case OPCODE('M', 'T'):
+            //< extension: latency and event counts, as /metrics
+            c.ask |= ASK_METRICS;
+            break;
+        case OPCODE('C', 'R'):
+        case OPCODE('C', 'W'):
+            //< no configuration registers to read or write
+            c.ask |= ASK_UNSUPPORTED;
+            break;
+        case OPCODE('R', 'E'):
+            //< Reset the rotator, go to home position
+            if (_p - _tok == 5 && strncmp(_tok, "RESET", 5) == 0) {
+                c.act |= ACT_RESET;
+            } else {
+                c.ask |= ASK_UNSUPPORTED;
+            }
+            break;
+        case OPCODE('P', 'A'):
+            //< Park the rotator
+            if (_p - _tok == 4 && strncmp(_tok, "PARK", 4) == 0) {
+                c.act |= ACT_PARK;
+                c.ask |= ASK_AZ | ASK_EL;
+            } else {
+                c.ask |= ASK_UNSUPPORTED;
+            }
+            break;
+        case OPCODE('T', 'L'):
+        case OPCODE('Q', 'T'):
+        case OPCODE('T', 'I'):
+            //< onboard tracker extensions TL1, TL2, TLX, QTH, TIM own the rest of the line
+            if (_tok == command) {
+                c.act |= ACT_TRACKER;
+                memcpy(c.text, command, len + 1);
+                return;
+            }
+            c.ask |= ASK_UNSUPPORTED;
+            break;
+        default:
+            //< VL/VR/VU/VD, UP/DN, DM/UM, DR/UR, AO/LO, OP, AN, ST and anything unknown:
+            //< answer, so a host waiting on a reply does not wait out its timeout
+            c.ask |= ASK_UNSUPPORTED;
+            break;
+        }
+    }
+}
+
+/*! @brief parse a line of hamlib's rotctld protocol
+*
+* One letter and its arguments, or the long name after a backslash: p get_pos, P set_pos, S stop,
+* K park, M move, R reset, _ get_info, 1 dump_state, q quit. e.g. "P 180.0 45.0", "\\get_pos".
+* @param command the line, '\0' terminated
+* @param len strlen(command)
+* @param c receives what the line asks for
+*/
+void Easycomm::parseHamlib(char command[], uint16_t len, Command &c)
+{
+    c.act = 0;
+    c.ask = 0;
+    c.jog_az = c.jog_el = 0;
+    c.hamlib = true;
+    c.rprt = 0;
+    const char *_p = command + 1;
+    const char *_end = command + len;
+    char _letter = command[0];
+    if (_letter == '\\') {
+        const char *_name = _p;
+        while (_p < _end && *_p != ' ') {
+            _p++;
+        }
+        _letter = '\0';
+        for (uint8_t i = 0; i < sizeof(HAMLIB_NAMES) / sizeof(HAMLIB_NAMES[0]); i++) {
+            if (strlen(HAMLIB_NAMES[i].name) == (size_t)(_p - _name) && strncmp(HAMLIB_NAMES[i].name, _name, _p - _name) == 0) {
+                _letter = HAMLIB_NAMES[i].letter;
+            }
+        }
+    }
+    //< up to two numeric arguments
+    float _v[2];
+    uint8_t _n = 0;
+    while (_n < 2) {
+        char *_stop;
+        _v[_n] = strtof(_p, &_stop);
+        if (_stop == _p) {
+            break;
+        }
+        _p = _stop;
+        _n++;
+    }
+    switch (_letter) {
+    case 'p':
+        c.ask |= ASK_HL_POS;
+        break;
+    case 'P':
+        if (_n == 2) {
+            c.act |= ACT_AZ | ACT_EL;
+            c.az = fmod(_v[0] + 360, 360);
+            c.el = _v[1];
+        } else {
+            c.rprt = -1;    //< RIG_EINVAL
+        }
+        c.ask |= ASK_RPRT;
+        break;
+    case 'S':
+        c.act |= ACT_STOP;
+        c.ask |= ASK_RPRT;
+        break;
+    case 'K':
+        c.act |= ACT_PARK;
+        c.ask |= ASK_RPRT;
+        break;
+    case 'M': {
+        int _dir = _n > 0 ? (int)_v[0] : 0;
+        c.jog_el = _dir == ROT_MOVE_UP ? 1 : _dir == ROT_MOVE_DOWN ? -1 : 0;
+        c.jog_az = _dir == ROT_MOVE_RIGHT || _dir == ROT_MOVE_CW ? 1 : _dir == ROT_MOVE_LEFT || _dir == ROT_MOVE_CCW ? -1 : 0;
+        if (c.jog_az || c.jog_el) {
+            c.act |= ACT_JOG;
+        } else {
+            c.rprt = -1;
+        }
+        c.ask |= ASK_RPRT;
+        break;
+    }
+    case 'R':
+        //< replies from execute(), just before restarting
+        c.act |= ACT_RESET;
+        break;
+    case '_':
+        c.ask |= ASK_HL_INFO;
+        break;
+    case '1':
+        c.ask |= ASK_HL_STATE;
+        break;
+    case 'q':
+    case 'Q':
+        c.ask |= ASK_QUIT;
+        break;
+    default:
+        c.rprt = -4;        //< RIG_ENIMPL
+        c.ask |= ASK_RPRT;
+        break;
+    }
+}
+
+/*! @brief read a number that must fill [start, end) exactly
+*
+* @param start first character after the command letters
+* @param end one past the last character of the token
+* @param value receives the number
+* @return true if the whole range is a number
+*/
+bool Easycomm::parseNumber(const char *start, const char *end, float *value)
+{
+    if (start >= end) {
+        return false;
+    }
+    char *_stop;
+    *value = strtof(start, &_stop);
+    return (_stop == end);
+}
+
+/*! @brief answer a complete command line, and queue its work for easycomm_process()
+*
+* Runs in the serial task, so it only reads the Sensor; anything touching the Gimbal,
+* the Tracker or the command history goes through the queue.
+* @param command the command line, without terminator
+* @param len strlen(command)
+*/
+void Easycomm::dispatch(char command[], uint16_t len)
+{
+    Command _c;
+    if (command[0] == '\\' || len == 1 || command[1] == ' ') {
+        //< rotctld commands are a single letter or a long name, Easycomm ones two letters
+        parseHamlib(command, len, _c);
+    } else {
+        parse(command, len, _c);
+    }
+    _c.link = cur - links;
+    _c.session = cur->session;
+    metrics->count(C_EC_COMMANDS);
+    power->activity();
+    if (_c.act && xQueueSend(queue, &_c, 0) != pdTRUE) {
+        dropped++;
+        metrics->count(C_EC_DROPPED);
+        if (_c.act & (ACT_RESET | ACT_TRACKER)) {
+            //< these reply from execute(), so say now that they won't happen.
+            //< A dropped positioning command is covered by the host's next one
+            appendReply("RPRT -1\n");
+            return;
+        }
+    }
+    if (_c.ask & (ASK_AZ | ASK_EL)) {
+        snapshot();
+        if ((_c.ask & (ASK_AZ | ASK_EL)) == (ASK_AZ | ASK_EL)) {
+            appendReply("AZ%.1f EL%.1f\n\r\n", snap_az, snap_el);
+        } else if (_c.ask & ASK_AZ) {
+            appendReply("AZ%.1f\n\r\n", snap_az);
+        } else {
+            appendReply("EL%.1f\n\r\n", snap_el);
+        }
+    }
+    if (_c.ask & ASK_VERSION) {
+        appendReply("VE%s\n RPRT 0\n", EC_VERSION);
+    }
+    if (_c.ask & ASK_STATUS) {
+        replyStatus(_c.status);
+    }
+    if (_c.ask & ASK_GS) {
+        appendReply("GS, 0\n RPRT 0\n");
+    }
+    if (_c.ask & ASK_GE) {
+        appendReply("GE, 0\n RPRT 0\n");
+    }
+    if (_c.ask & ASK_STATUS_BIN) {
+        replyStatusRecord();
+    }
+    if (_c.ask & ASK_METRICS) {
+        replyMetrics();
+    }
+    if (_c.ask & ASK_UNSUPPORTED) {
+        appendReply("RPRT -1\n");
+    }
+    if (_c.ask & ASK_HL_POS) {
+        snapshot();
+        appendReply("%f\n%f\n", snap_az, snap_el);
+    }
+    if (_c.ask & ASK_HL_INFO) {
+        appendReply("%s\n", EC_VERSION);
+    }
+    if (_c.ask & ASK_HL_STATE) {
+        //< protocol version 0, then the travel limits: min_az, max_az, min_el, max_el
+        appendReply("0\n0.000000\n360.000000\n0.000000\n90.000000\n");
+    }
+    if (_c.ask & ASK_RPRT) {
+        appendReply("RPRT %d\n", _c.rprt);
+    }
+    if (_c.ask & ASK_QUIT) {
+        cur->quit = true;
+    }
+}
+
+/*! @brief read the Sensor once for all the replies in this burst
+ */
+void Easycomm::snapshot()
+{
+    if (!have_snapshot) {
+        sensor->getAzElT(&snap_az, &snap_el, &snap_temp);
+        have_snapshot = true;
+    }
+}
+
+/*! @brief add to the replies for this burst, as printf()
+*
+* Writes out what is already there first if it would not fit.
+* @param format printf() format
+*/
+void Easycomm::appendReply(const char *format, ...)
+{
+    va_list _args;
+    for (uint8_t _try = 0; _try < 2; _try++) {
+        va_start(_args, format);
+        int _n = vsnprintf(reply + reply_len, REPLY_SIZE - reply_len, format, _args);
+        va_end(_args);
+        if (_n < 0) {
+            return;
+        }
+        if (reply_len + _n < REPLY_SIZE) {
+            reply_len += _n;
+            return;
+        }
+        flushReplies();
+    }
+}
+
+/*! @brief send the replies for this burst in one write, to the link it came from
+ */
+void Easycomm::flushReplies()
+{
+    if (reply_len > 0) {
+        cur->port->write((const uint8_t *)reply, reply_len);
+        reply_len = 0;
+    }
+}
+
+/*! @brief make sure az_input, el_input hold a position, starting from where the Sensor is
+ */
+void Easycomm::currentInput()
+{
+    if (!have_input) {
+        az_input = sensor->getSensorAz();
+        el_input = sensor->getSensorEl();
+        have_input = true;
+    }
+}
+
+/*! @brief carry out a queued command, from loop()
+*
+* @param c the parsed command line
+*/
+void Easycomm::execute(Command &c)
+{
+    if (c.act & ACT_TRACKER) {
+        reportResult(c, tracker->command(c.text));
+        return;
+    }
+    if (c.act & ACT_RESET) {
+        if (c.hamlib) {
+            reportResult(c, true);
+        } else {
+            reportPosition(c);
+        }
+        Serial.flush();
+        if (c.link != 0) {
+            delay(RESET_LINGER);
+        }
+        nv->flush();
+        ESP.restart();
+    }
+    //< the host is pointing us, so it takes over from the onboard tracker
+    tracker->stop();
+    currentInput();
+    if (c.act & ACT_PARK) {
+        clearHistory();
+        az_input = el_input = 0.0;
+        gimbal->moveToAzEl(az_input, el_input);
+    } else if (c.act & (ACT_STOP | ACT_JOG)) {
+        //< a manual move, not part of a trajectory
+        clearHistory();
+        if (c.act & ACT_JOG) {
+            az_input = fmod(az_input + c.jog_az * JOG_STEP + 360, 360);
+            el_input = constrain(el_input + c.jog_el * JOG_STEP, 0.0f, 90.0f);
+            gimbal->moveToAzEl(az_input, el_input);
+        }
+    } else if (c.act & (ACT_AZ | ACT_EL)) {
+        //< a partial command keeps the other axis where it was last sent
+        if (c.act & ACT_AZ) {
+            az_input = c.az;
+        }
+        if (c.act & ACT_EL) {
+            el_input = c.el;
         }
-        //< continue until there is no more data in the Serial buffer
+        recordTarget(az_input, el_input);
+        gimbal->moveToAzEl(az_input, el_input);
     }
 }
 
-/*! @brief parse the rotctl command buffer to extract the desired az, el position
-* @param az_input the azimuth value in the command
-* @param el_input the elevation value in the command
-* @param buffer the message received over the Serial port
-* @return true if we found valid az, el positioning numbers
+/*! @brief add a positioning command to the history used by predict()
+*
+* A command far from where the history says the target should be starts a new trajectory,
+* e.g. the next pass or a manual move.
+* @param az the commanded azimuth
+* @param el the commanded elevation
 */
-bool Easycomm::readAzEl(float *az_input, float *el_input, char buffer[])
+void Easycomm::recordTarget(float az, float el)
 {
-    char _buffcpy[BUFFER_SIZE];
-    memset(_buffcpy, '\0', sizeof(_buffcpy));
-    strcpy(_buffcpy, buffer);
-    char *token;
+    uint32_t _now = millis();
+    float _az_p, _el_p;
+    if (predict(_now, &_az_p, &_el_p)
+            && (fabs(Gimbal::azDist(_az_p, az)) > MAX_JUMP || fabs(_el_p - el) > MAX_JUMP)) {
+        clearHistory();
+    }
+    Target *_tp = &history[next_history];
+    _tp->t = _now;
+    _tp->az = az;
+    _tp->el = el;
+    next_history = (next_history + 1) % N_HISTORY;
+    if (n_history < N_HISTORY) {
+        n_history++;
+    }
+}
 
-    //< get the first token
-    token = strtok(_buffcpy, " ");
-    if (isNumber(token + 2)) {
-        *az_input = atof(token + 2);
+/*! @brief estimate where the host's target will be, from the rate and acceleration of recent commands
+*
+* @param at millis() time to predict for, typically now plus the Gimbal's mechanical latency
+* @param az receives the predicted azimuth, 0..360
+* @param el receives the predicted elevation, 0..90
+* @return true if there are recent commands to predict from
+*/
+bool Easycomm::predict(uint32_t at, float *az, float *el)
+{
+    if (n_history == 0) {
+        return false;
     }
-    //< Get the absolute position in deg for elevation
-    token = strtok(NULL, " ");
-    //< check that the first two chars are "EL" and copy to "data", skipping the "EL"
-    if (token[0] == 'E' && token[1] == 'L') {
-        if (isNumber(token + 2)) {
-            *el_input = atof(token + 2);
-            return true;
+    Target *_newest = &history[(next_history + N_HISTORY - 1) % N_HISTORY];
+    if (millis() - _newest->t > HISTORY_STALE) {
+        return false;
+    }
+    //< times in seconds relative to newest command, az unwrapped around the newest az
+    float _t[N_HISTORY], _az[N_HISTORY], _el[N_HISTORY];
+    for (uint8_t i = 0; i < n_history; i++) {
+        Target *_tp = &history[(next_history + N_HISTORY - n_history + i) % N_HISTORY];
+        _t[i] = -(float)(_newest->t - _tp->t) / 1000;
+        _az[i] = _newest->az + Gimbal::azDist(_newest->az, _tp->az);
+        _el[i] = _tp->el;
+    }
+    int32_t _ahead = at - _newest->t;
+    if (_ahead > MAX_EXTRAPOLATE) {
+        _ahead = MAX_EXTRAPOLATE;
+    }
+    float _at = (float)_ahead / 1000;
+    *az = fmod(fitAt(_t, _az, n_history, _at) + 720, 360);
+    *el = constrain(fitAt(_t, _el, n_history, _at), 0.0f, 90.0f);
+    return true;
+}
+
+/*! @brief least-squares fit of y = a + b*t + c*t*t, evaluated at 'at'
+*
+* Falls back to a straight line when there are only two points or the quadratic is ill-conditioned,
+* and to the newest value with a single point.
+* @param t sample times, seconds, newest last
+* @param y sample values
+* @param n number of samples
+* @param at time to evaluate the fit
+* @return the fitted value at 'at'
+*/
+float Easycomm::fitAt(float t[], float y[], uint8_t n, float at)
+{
+    float _s1 = 0, _s2 = 0, _s3 = 0, _s4 = 0, _sy = 0, _sty = 0, _st2y = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        float _tt = t[i] * t[i];
+        _s1 += t[i];
+        _s2 += _tt;
+        _s3 += _tt * t[i];
+        _s4 += _tt * _tt;
+        _sy += y[i];
+        _sty += t[i] * y[i];
+        _st2y += _tt * y[i];
+    }
+    float _s0 = n;
+    if (n >= 3) {
+        float _det = _s0 * (_s2 * _s4 - _s3 * _s3) - _s1 * (_s1 * _s4 - _s3 * _s2) + _s2 * (_s1 * _s3 - _s2 * _s2);
+        if (fabs(_det) > 1e-6) {
+            float _a = (_sy * (_s2 * _s4 - _s3 * _s3) - _s1 * (_sty * _s4 - _s3 * _st2y) + _s2 * (_sty * _s3 - _s2 * _st2y)) / _det;
+            float _b = (_s0 * (_sty * _s4 - _st2y * _s3) - _sy * (_s1 * _s4 - _s3 * _s2) + _s2 * (_s1 * _st2y - _sty * _s2)) / _det;
+            float _c = (_s0 * (_s2 * _st2y - _s3 * _sty) - _s1 * (_s1 * _st2y - _s3 * _sy) + _s2 * (_s1 * _sty - _s2 * _sy)) / _det;
+            return _a + _b * at + _c * at * at;
         }
     }
-    return false;
+    if (n >= 2) {
+        float _det = _s0 * _s2 - _s1 * _s1;
+        if (fabs(_det) > 1e-6) {
+            float _b = (_s0 * _sty - _s1 * _sy) / _det;
+            float _a = (_sy - _b * _s1) / _s0;
+            return _a + _b * at;
+        }
+    }
+    return y[n - 1];
 }
 
-/*! @brief utility to report whether the input[] is a numeric value
-* @param input the char[] to inspect for numeric characters
-* @return true if all characters in input are numeric
+/*! @brief reply from execute() to a command, in one write, on the link it came from
+*
+* Nothing is sent if that session has since closed. links_lock is held from the check to the
+* end of the write, so the serial task can't stop or replace the client in between.
+* @param c the command
+* @param text the reply
 */
-bool Easycomm::isNumber(char input[]) 
+void Easycomm::replyTo(Command &c, const char *text)
 {
-  for (uint16_t i = 0; input[i] != '\0'; i++) {
-    if (isalpha(input[i]))
-      return false;
+    Link &_l = links[c.link];
+    xSemaphoreTake(links_lock, portMAX_DELAY);
+    if (_l.session == c.session && _l.port != NULL) {
+        _l.port->print(text);
     }
-  return true;
+    xSemaphoreGive(links_lock);
 }
 
 /*! @brief send back the current sensor reading formatted for rotctl
+* @param c the command being answered
 */
-void Easycomm::reportPosition() {
-    Serial.print("AZ");Serial.print(sensor->getSensorAz(), 1);
-    Serial.print(" EL"); Serial.print(sensor->getSensorEl(), 1);
-    Serial.println("\n");   
+void Easycomm::reportPosition(Command &c) {
+    //< one write, so a reply from the other context can't land in the middle
+    char _reply[32];
+    snprintf(_reply, sizeof(_reply), "AZ%.1f EL%.1f\n\r\n", sensor->getSensorAz(), sensor->getSensorEl());
+    replyTo(c, _reply);
 }
 
-/*! @brief generate reply to status rotctl commands starting with 'IP'
+/*! @brief send back the rotctl result code for a command that has no other reply
+* @param c the command being answered
+* @param ok whether the command succeeded
+*/
+void Easycomm::reportResult(Command &c, bool ok) {
+    replyTo(c, ok ? "RPRT 0\n" : "RPRT -1\n");
+}
+
+/*! @brief reply to status rotctl commands starting with 'IP'
 *  most are not relevant
+* @param statusNumber the register asked for
 */
-void Easycomm::dealWithStatusCommand(char statusNumber) 
+void Easycomm::replyStatus(char statusNumber) 
 {
-    String statusString;
-    
     switch (statusNumber) {
     case '0':
         //< Get the inside temperature
-        statusString = String(sensor->getTempC(), DEC);
+        snapshot();
+        appendReply("IP0, %d\nRPRT 0\n", snap_temp);
         break;
     case '1':
         //< Get the status of end-stop, azimuth
-        statusString = "0";
-        break;
     case '2':
         //< Get the status of end-stop, elevation
-        statusString = "0";
+        appendReply("IP%c, 0\nRPRT 0\n", statusNumber);
         break;
     case '3':
         //< Get the current position of azimuth in deg
-        statusString = String(sensor->getSensorAz(), 1);
-      break;
+        snapshot();
+        appendReply("IP3, %.1f\nRPRT 0\n", snap_az);
+        break;
     case '4':
-      //< Get the current position of elevation in deg
-      statusString = String(sensor->getSensorEl(), 1);
+        //< Get the current position of elevation in deg
+        snapshot();
+        appendReply("IP4, %.1f\nRPRT 0\n", snap_el);
         break;
     case '5':
-      //< Get the load of azimuth, in range of 0-1023
-      statusString = "1";
-      break;
+        //< Get the load of azimuth, in range of 0-1023
     case '6':
-      //< Get the load of elevation, in range of 0-1023
-      statusString = "1";
-      break;
+        //< Get the load of elevation, in range of 0-1023
     case '7':
-      //< Get the speed of azimuth in deg/s
-      statusString = "1";
-      break;
+        //< Get the speed of azimuth in deg/s
     case '8':
-      //< Get the speed of elevation in deg/s
-      statusString = "1";
-      break;
+        //< Get the speed of elevation in deg/s
+        appendReply("IP%c, 1\nRPRT 0\n", statusNumber);
+        break;
     default:
-      statusString = "";
-      break;
-  }
-  Serial.print(String("IP") + statusNumber + String(", ") + statusString + String("\nRPRT 0\n"));
+        appendReply("IP%c, \nRPRT 0\n", statusNumber);
+        break;
+    }
+}
+
+/*! @brief reply to SB with the StatusRecord in hex, least significant byte first as in memory
+ */
+void Easycomm::replyStatusRecord()
+{
+    static const char _hex[] = "0123456789abcdef";
+    StatusRecord _s;
+    buildStatus(_s);
+    const uint8_t *_b = (const uint8_t *)&_s;
+    char _text[2 * sizeof(_s) + 1];
+    for (uint8_t i = 0; i < sizeof(_s); i++) {
+        _text[2*i] = _hex[_b[i] >> 4];
+        _text[2*i + 1] = _hex[_b[i] & 0xf];
+    }
+    _text[2 * sizeof(_s)] = '\0';
+    appendReply("SB, %s\nRPRT 0\n", _text);
+}
+
+/*! @brief reply to MT with one line per timed site and per counter
+*
+* "MT, <site> <count> <min> <p99> <max>" in microseconds, then "MT, <event> <total> <per second>"
+*/
+void Easycomm::replyMetrics()
+{
+    for (uint8_t i = 0; i < M_N_SITES; i++) {
+        Metrics::Site _s;
+        metrics->site(i, _s);
+        appendReply("MT, %s %lu %lu %lu %lu\n", Metrics::siteName(i), (unsigned long)_s.count,
+                (unsigned long)(_s.count ? _s.min_us : 0), (unsigned long)Metrics::p99(_s), (unsigned long)_s.max_us);
+    }
+    for (uint8_t i = 0; i < M_N_COUNTERS; i++) {
+        uint32_t _total, _rate;
+        metrics->counter(i, &_total, &_rate);
+        appendReply("MT, %s %lu %lu\n", Metrics::counterName(i), (unsigned long)_total, (unsigned long)_rate);
+    }
+    appendReply("RPRT 0\n");
 }
 
 /*! @brief send latest web values, only report the last rotctl command in the 'buffer'
 *
-* @param client a reference to the WiFiClient
+* @param r the response to add our NAME=VALUE lines to
 * N.B. must match id's in main web page
 */
-void Easycomm::sendNewValues(WiFiClient client)
+void Easycomm::sendNewValues(Response &r)
 {
-    client.print(F("rotctl_message="));
-    client.println(buffer);
+    r.add("rotctl_message", buffer);
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 * 
 * @brief Class to handle Serial port communication with rotctl on Raspberry Pi or PC
 *
+* The same commands are also taken over TCP on ROTCTL_PORT, several sessions at once, so a
+* host can drive rotators over WiFi. Each line may be Easycomm, or hamlib's rotctld protocol
+* as spoken by netrotctl (rotator model 2) and gpredict.
+*
 * @section license License
 * Copyright (c) 2020 Tom Driscoll. 
 * Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
@@ -21,24 +25,128 @@
 #ifndef _EASYCOMM_H
 #define _EASYCOMM_H
 #include <WiFi.h>
+#include "Response.h"
+
+#define ROTCTL_PORT      4533   ///<  TCP port for Easycomm and rotctld sessions, rotctld's default
+#define ROTCTL_SESSIONS  4      ///<  concurrent TCP sessions; a new one replaces the longest idle
 
 class Easycomm {
 
     private:
 
-    #define BUFFER_SIZE   64   //< Set the size of serial port buffer
+    #define BUFFER_SIZE   80   //< Set the size of serial port buffer, room for a TLE line
+    #define OPCODE(a, b)  ((uint16_t)(a) << 8 | (uint8_t)(b))  //< two-letter command packed for switch()
+
+    //< one command line, parsed in place
+    typedef struct {
+        uint8_t act;                                // ACT_ flags, work for easycomm_process()
+        uint16_t ask;                               // ASK_ flags, replies sent as soon as the line is parsed
+        float az, el;                               // positions for ACT_AZ, ACT_EL
+        int8_t jog_az, jog_el;                      // -1, 0 or +1 for ACT_JOG
+        char status;                                // register number for ASK_STATUS
+        int8_t rprt;                                // result code for ASK_RPRT
+        bool hamlib;                                // rotctld line, execute() replies in its format
+        uint8_t link, session;                      // where it came from, for replies from execute()
+        char text[BUFFER_SIZE];                     // whole line, for ACT_TRACKER
+    } Command;
+    enum {
+        ACT_AZ = 1, ACT_EL = 2, ACT_STOP = 4, ACT_JOG = 8, ACT_PARK = 16, ACT_RESET = 32, ACT_TRACKER = 64,
+    };
+    enum {
+        ASK_AZ = 1, ASK_EL = 2, ASK_VERSION = 4, ASK_STATUS = 8, ASK_GS = 16, ASK_GE = 32, ASK_UNSUPPORTED = 64, ASK_STATUS_BIN = 128,
+        ASK_METRICS = 256, ASK_HL_POS = 512, ASK_HL_INFO = 1024, ASK_HL_STATE = 2048, ASK_RPRT = 4096,
+        ASK_QUIT = 8192,
+    };
+    static constexpr float JOG_STEP = 5.0;          // degrees moved by each ML, MR, MU, MD
+
+    float az_input, el_input;                       //< latest commanded position, for partial commands
+    bool have_input;
+
+    //< recent positioning commands, to extrapolate the target trajectory
+    typedef struct {
+        uint32_t t;                                 // millis() when received
+        float az, el;                               // commanded position, degrees
+    } Target;
+    static const uint8_t N_HISTORY = 6;             // commands kept for the fit
+    static const uint16_t HISTORY_STALE = 3000;     // ms after the newest command to stop predicting
+    static const uint16_t MAX_EXTRAPOLATE = 2000;   // ms beyond the newest command to predict at most
+    static constexpr float MAX_JUMP = 10.0;         // degrees off prediction that starts a new trajectory
+    Target history[N_HISTORY];
+    uint8_t n_history, next_history;
 
-    double el_input = 0.0;  //< variable for the elevation position in the command
-    double az_input = 0.0;  //< variable for the azimuth position in the command
-    void reportPosition();
-    void dealWithStatusCommand(char);
-    bool isNumber(char[]);
+    //< serial receive task: assembles lines as bytes arrive and answers queries at once,
+    //< commands that move the Gimbal or change state wait in queue for easycomm_process()
+    static const uint8_t TASK_CORE = 1;             // same core as loop(), preempting it
+    static const uint16_t TASK_STACK = 4096;
+    static const uint8_t TASK_PRIORITY = 3;         // above loop() and Sensor
+    static const uint8_t QUEUE_LENGTH = 8;          // commands waiting for loop()
+    TaskHandle_t task;
+    QueueHandle_t queue;
+    uint32_t dropped;                               // commands lost to a full queue
+
+    //< where commands come from, each assembling its own lines: Serial, then the TCP sessions
+    typedef struct {
+        Stream *port;                               // NULL while a session slot is free
+        WiFiClient client;                          // the session's connection, port points here
+        char line[BUFFER_SIZE];                     // line being assembled
+        uint16_t line_len;
+        uint8_t session;                            // bumped for each connection the slot takes
+        bool quit;                                  // close once the replies are out
+        uint32_t last;                              // millis() of the latest byte received
+    } Link;
+    static const uint8_t N_LINKS = 1 + ROTCTL_SESSIONS;
+    static const uint16_t ACCEPT_INTERVAL = 100;    // ms between checks for new and closed sessions
+    static const uint16_t RESET_LINGER = 100;       // ms for a TCP reply to get out before RESET
+    Link links[N_LINKS];
+    Link *cur;                                      // link whose burst is being received
+    SemaphoreHandle_t links_lock;                   // held by execute() from checking a session to writing to it,
+                                                    // and while the serial task replaces or stops a session's client
+    WiFiServer *server;
+    uint32_t last_accept;
+
+    //< replies to one burst of received lines, written out together by flushReplies()
+    static const uint16_t REPLY_SIZE = 256;
+    char reply[REPLY_SIZE];
+    uint16_t reply_len;
+    bool have_snapshot;                             // snap_ values are valid for this burst
+    float snap_az, snap_el;
+    int8_t snap_temp;
+
+    static void serialTask(void *arg);
+    void receiveAll();
+    void receiveLink(Link &l);
+    void acceptSessions();
+    void receive(char c);
+    void dispatch(char command[], uint16_t len);
+    void execute(Command &c);
+    void parse(char command[], uint16_t len, Command &c);
+    void parseHamlib(char command[], uint16_t len, Command &c);
+    static bool parseNumber(const char *start, const char *end, float *value);
+    void currentInput();
+
+    void replyTo(Command &c, const char *text);
+    void reportPosition(Command &c);
+    void reportResult(Command &c, bool ok);
+    void snapshot();
+    void appendReply(const char *format, ...);
+    void flushReplies();
+    void replyStatus(char status);
+    void replyStatusRecord();
+    void replyMetrics();
+    void recordTarget(float az, float el);
+    float fitAt(float t[], float y[], uint8_t n, float at);
 
     public:
 
-    bool readAzEl(float *az, float *el, char buffer[]);
+    Easycomm();
+    bool predict(uint32_t at, float *az, float *el);
+    void clearHistory() { n_history = 0; };
+
     void easycomm_process();
-	void sendNewValues (WiFiClient);
+    bool startTask();
+    bool taskRunning() { return (task != NULL); };
+    uint32_t droppedCommands() { return (dropped); };
+	void sendNewValues (Response &);
 
 };
 extern Easycomm *easycomm;
@@ -0,0 +1,123 @@
+/*!
+* @brief Compile-time description of the motors, so one source tree builds every mechanical variant
+*
+* Each motor is an Axis: the kind of actuator driving it and its PCA9685 channel. What Gimbal needs
+* to know about a kind lives in its Actuator traits, all constexpr, so the pulse arithmetic folds
+* into the calibration and control code of each build. A variant is chosen with build_flags in its
+* platformio.ini env, e.g. -DGIMBAL_SERVO_FREQ=100 -DGIMBAL_HOME_EL=30.0, rather than a fork.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _AXIS_H
+#define _AXIS_H
+
+#include <Arduino.h>
+
+//< the kinds of actuator an Axis may have; only SERVO_PWM has traits so far
+enum ActuatorKind {
+    SERVO_PWM,							// hobby servo, position set by PCA9685 pulse width
+    STEPPER,							// stepper and driver, position counted in steps
+    CONTINUOUS,							// continuous rotation servo, speed set by pulse width
+};
+
+#ifndef GIMBAL_AZ_STEPPER
+#define GIMBAL_AZ_STEPPER  false		///<  true drives az with a stepper on the STEPPER_ pins; el stays a servo
+#endif
+#ifndef GIMBAL_MOT1_KIND
+#define GIMBAL_MOT1_KIND   (GIMBAL_AZ_STEPPER ? STEPPER : SERVO_PWM)	///<  motor 1 actuator
+#endif
+#ifndef GIMBAL_MOT2_KIND
+#define GIMBAL_MOT2_KIND   SERVO_PWM	///<  motor 2 actuator
+#endif
+#ifndef GIMBAL_MOT1_UNIT
+#define GIMBAL_MOT1_UNIT   0			///<  motor 1 PCA9685 channel
+#endif
+#ifndef GIMBAL_MOT2_UNIT
+#define GIMBAL_MOT2_UNIT   1			///<  motor 2 PCA9685 channel, must follow GIMBAL_MOT1_UNIT
+#endif
+#ifndef GIMBAL_SERVO_FREQ
+#define GIMBAL_SERVO_FREQ  50			///<  servo pulse frequency, Hz; digital servos take up to 333
+#endif
+#ifndef GIMBAL_PWM_ADDR
+#define GIMBAL_PWM_ADDR    0x40		///<  PCA9685 I2C address
+#endif
+#ifndef GIMBAL_HOME_AZ
+#define GIMBAL_HOME_AZ     0.0		///<  degrees az the gimbal is sent to after calibrating
+#endif
+#ifndef GIMBAL_HOME_EL
+#define GIMBAL_HOME_EL     45.0		///<  degrees el the gimbal is sent to after calibrating
+#endif
+
+// stepper az, GIMBAL_AZ_STEPPER only
+#ifndef STEPPER_STEP_PIN
+#define STEPPER_STEP_PIN   32			///<  driver STEP input, pulsed by the RMT peripheral
+#endif
+#ifndef STEPPER_DIR_PIN
+#define STEPPER_DIR_PIN    33			///<  driver DIR input
+#endif
+#ifndef STEPPER_ENABLE_PIN
+#define STEPPER_ENABLE_PIN 27			///<  driver ENABLE input, active low; -1 if always enabled
+#endif
+#ifndef STEPPER_HOME_PIN
+#define STEPPER_HOME_PIN   14			///<  home switch to ground, closed at home; -1 if none
+#endif
+#ifndef STEPPER_STEPS_PER_REV
+#define STEPPER_STEPS_PER_REV  3200	///<  steps per turn of the az shaft, after microstepping and gearing
+#endif
+#ifndef STEPPER_MAX_SPEED
+#define STEPPER_MAX_SPEED  30.0		///<  slew speed, az shaft degrees per second
+#endif
+#ifndef STEPPER_ACCEL
+#define STEPPER_ACCEL      20.0		///<  az shaft degrees per second per second
+#endif
+#ifndef STEPPER_HOME_SPEED
+#define STEPPER_HOME_SPEED 5.0		///<  az shaft degrees per second while looking for the home switch
+#endif
+
+//< what Gimbal needs from a kind of actuator; a kind without a specialization fails to build
+template <ActuatorKind K> struct Actuator;
+
+template <> struct Actuator<SERVO_PWM> {
+	static constexpr uint16_t FREQ = GIMBAL_SERVO_FREQ;			// Hz
+	static constexpr float US_PER_COUNT = 1e6f / FREQ / 4096;	// usec per count @ 12 bit resolution
+	static constexpr uint16_t MAX_US = 1e6f / FREQ;				// longest pulse that fits in the frame
+
+	/*! @brief PCA9685 OFF count for a pulse width, to the nearest count
+	* @param us pulse width in microseconds
+	*/
+	static constexpr uint16_t toCounts (uint16_t us) { return ((uint16_t)(us / US_PER_COUNT + 0.5f)); }
+};
+
+template <> struct Actuator<STEPPER> {
+	static constexpr float STEPS_PER_DEG = STEPPER_STEPS_PER_REV / 360.0f;
+	static constexpr float MAX_SPEED = STEPPER_MAX_SPEED * STEPS_PER_DEG;		// steps per second
+	static constexpr float ACCEL = STEPPER_ACCEL * STEPS_PER_DEG;				// steps per second per second
+	static constexpr float HOME_SPEED = STEPPER_HOME_SPEED * STEPS_PER_DEG;	// steps per second
+};
+
+//< one motor: its actuator, and the PCA9685 channel driving it (unused by a stepper)
+template <ActuatorKind K, uint8_t UNIT> struct Axis {
+	typedef Actuator<K> actuator;
+	static constexpr ActuatorKind kind = K;
+	static constexpr uint8_t unit = UNIT;
+};
+
+//< this build's motors
+typedef Axis<GIMBAL_MOT1_KIND, GIMBAL_MOT1_UNIT> Motor1;
+typedef Axis<GIMBAL_MOT2_KIND, GIMBAL_MOT2_UNIT> Motor2;
+
+#endif // _AXIS_H
@@ -0,0 +1,114 @@
+/*!
+* @brief Recursive least-squares estimate of how the two motors move the antenna in az and el
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "CalEstimator.h"
+
+/*! @brief class constructor; J is 0 and knows nothing until some samples
+ */
+CalEstimator::CalEstimator()
+{
+	clear ();
+}
+
+/*! @brief forget J and the confidence in it, so the next samples alone make J
+*/
+void CalEstimator::clear()
+{
+	for (uint8_t i = 0; i < 2; i++) {
+	    for (uint8_t j = 0; j < 2; j++) {
+		    J[i][j] = 0;
+	    }
+	}
+	reset ();
+}
+
+/*! @brief forget the confidence in J, not J itself
+*
+* The default lets the next samples overwrite J outright, as calibration wants; a small p0 says
+* J, from set(), is already good to that.
+* @param p0 variance of each J term per unit residual variance, 1/usec^2, at most P_MAX
+*/
+void CalEstimator::reset(float p0)
+{
+	P[0][0] = P[1][1] = fminf(p0, P_MAX);
+	P[0][1] = P[1][0] = 0;
+	var[AZ] = var[EL] = VAR_INIT;
+	n = 0;
+}
+
+/*! @brief take one move as a sample
+*
+* A residual more than OUTLIER standard errors from the prediction, such as a move the sensor
+* didn't see settle or someone bumping the mount, leaves everything as it was, unless gate is false.
+* @param dpos0 change in motor 0 position, usec
+* @param dpos1 change in motor 1 position, usec
+* @param daz change in az it made, degrees
+* @param del change in el it made, degrees
+* @param gate false to take the sample however far it is from the prediction, as calibration's moves
+* @return false if the sample was not believed
+*/
+bool CalEstimator::update(float dpos0, float dpos1, float daz, float del, bool gate)
+{
+	float _x[2] = { dpos0, dpos1 };
+	float _px[2] = { P[0][0] * _x[0] + P[0][1] * _x[1], P[1][0] * _x[0] + P[1][1] * _x[1] };
+	float _den = LAMBDA + _x[0] * _px[0] + _x[1] * _px[1];
+	float _e[2] = { daz - (J[AZ][0] * _x[0] + J[AZ][1] * _x[1]), del - (J[EL][0] * _x[0] + J[EL][1] * _x[1]) };
+	//< the prediction error of either row has variance var * _den / LAMBDA
+	for (uint8_t r = 0; gate && r < 2; r++) {
+	    if (_e[r] * _e[r] * LAMBDA > OUTLIER * OUTLIER * var[r] * _den) {
+		    return (false);
+	    }
+	}
+	float _k[2] = { _px[0] / _den, _px[1] / _den };
+	for (uint8_t r = 0; r < 2; r++) {
+	    J[r][0] += _k[0] * _e[r];
+	    J[r][1] += _k[1] * _e[r];
+	    var[r] += VAR_GAIN * (_e[r] * _e[r] * LAMBDA / _den - var[r]);
+	}
+	//< P = (P - k x'P) / LAMBDA, kept symmetric and bounded
+	float _p00 = (P[0][0] - _k[0] * _px[0]) / LAMBDA;
+	float _p01 = (P[0][1] - _k[0] * _px[1]) / LAMBDA;
+	float _p11 = (P[1][1] - _k[1] * _px[1]) / LAMBDA;
+	P[0][0] = fminf(_p00, P_MAX);
+	P[1][1] = fminf(_p11, P_MAX);
+	P[0][1] = P[1][0] = constrain(_p01, -sqrtf(P[0][0] * P[1][1]), sqrtf(P[0][0] * P[1][1]));
+	n++;
+	return (true);
+}
+
+/*! @brief standard error of one term of J, degrees per usec
+* @param axis AZ or EL
+* @param motn motor number
+*/
+float CalEstimator::stdErr(uint8_t axis, uint8_t motn)
+{
+	return (sqrtf(P[motn][motn] * var[axis]));
+}
+
+/*! @brief standard error of one term of J as a fraction of the larger of its motor's two terms
+*
+* A motor that barely moves an axis has a term near 0 there, so its error is measured against the axis it does move.
+* @param axis AZ or EL
+* @param motn motor number
+*/
+float CalEstimator::relErr(uint8_t axis, uint8_t motn)
+{
+	float _big = fmaxf(fabsf(J[AZ][motn]), fabsf(J[EL][motn]));
+	return (_big > 0 ? stdErr(axis, motn) / _big : 1);
+}
@@ -0,0 +1,57 @@
+/*!
+* @brief Recursive least-squares estimate of how the two motors move the antenna in az and el
+*
+* The model is the 2x2 coupling J, degrees of az and el per usec of each motor, so a move of
+* dpos usec turns the antenna by J dpos. Every move the gimbal makes is a sample; the estimate
+* follows slow drift, from temperature or the mount sagging, thru a forgetting factor. Both rows
+* share the regressors, so one 2x2 covariance P serves both; scaled by each row's residual
+* variance it gives the standard error of every term.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _CALESTIMATOR_H
+#define _CALESTIMATOR_H
+
+#include <Arduino.h>
+
+class CalEstimator {
+
+    public:
+	enum { AZ, EL };						//< rows of J
+	CalEstimator();
+	void clear ();
+	void reset (float p0 = P_MAX);
+	void set (uint8_t axis, uint8_t motn, float gain) { J[axis][motn] = gain; };
+	bool update (float dpos0, float dpos1, float daz, float del, bool gate = true);
+	float gain (uint8_t axis, uint8_t motn) { return (J[axis][motn]); };
+	float stdErr (uint8_t axis, uint8_t motn);
+	float relErr (uint8_t axis, uint8_t motn);
+	uint32_t samples() { return (n); };
+
+    private:
+	static constexpr float LAMBDA = 0.998;		// forgetting factor per sample; ~500 samples remembered
+	static constexpr float P_MAX = 1e-2;		// largest P term, 1/usec^2, so an idle motor can't wind it up
+	static constexpr float VAR_INIT = 0.25;		// residual variance before any are seen, degrees^2
+	static constexpr float VAR_GAIN = 0.05;		// fraction of each new squared residual taken into var
+	static constexpr float OUTLIER = 4;			// residuals beyond this many standard errors are not believed
+	float J[2][2];								// [AZ or EL][motor], degrees per usec
+	float P[2][2];								// covariance of either row of J, per unit residual variance
+	float var[2];								// residual variance of each row, degrees^2
+	uint32_t n;									// samples taken since reset()
+};
+
+#endif // _CALESTIMATOR_H
@@ -35,6 +35,8 @@
 #include "NV.h"
 #include "Webpage.h"
 #include "Sensor.h"
+#include "Metrics.h"
+#include "I2CBus.h"
 //use pin 21 to read the PCA9685 OE. This pin has a pull-down resistor built into it
 #define PCA9685OEPin 21
 
@@ -45,22 +47,22 @@ Gimbal::Gimbal()
 	// set up PCA9685 OE monitor pin
 	pinMode(PCA9685OEPin, INPUT);
 	//< first confirm whether controller is present
-	Wire.begin();
-	Wire.beginTransmission(I2C_ADDR);
-	gimbal_found = (Wire.endTransmission() == 0);
+	TwoWire &_wire = i2cbus->wire(I2C_PWM);
+	_wire.beginTransmission(I2C_ADDR);
+	gimbal_found = (_wire.endTransmission() == 0);
 	if (!gimbal_found && gimbal->DEBUG_GIMBAL) {
 		Serial.println(F("PWM controller not found"));
 		return;
 	}
 
 	//< instantiate PWM controller
-	pwm = new Adafruit_PWMServoDriver(I2C_ADDR);
+	pwm = new Adafruit_PWMServoDriver(I2C_ADDR, _wire);
 	pwm->begin();
-	pwm->setPWMFreq(SERVO_FREQ);
+	pwm->setPWMFreq(Servo::FREQ);
 
 	//< record axis assignments
-	motor[0].servo_num = MOT1_UNIT;
-	motor[1].servo_num = MOT2_UNIT;
+	motor[0].servo_num = Motor1::unit;
+	motor[1].servo_num = Motor2::unit;
 
 	//< initalize each motor state
 	nv->get();
@@ -82,11 +84,33 @@ Gimbal::Gimbal()
 
 	//< initalize to arbitrary, but at least defined, state
 	init_step = 0;
-	best_azmotor = 0;
+	assignAxes(0);
 	last_update = 0;
 	prevfast_az = prevfast_el = -1000;
 	prevstop_az = prevstop_el = -1000;
+	closed_loop = CLOSED_LOOP_TRACKING;
+	have_target = false;
+	az_loop.target = el_loop.target = 0;
+	last_track = 0;
 	isCalibrating = false;
+	cal_phase = CAL_IDLE;
+	cal_start = cal_wait = 0;
+	defer_motor = NMOTORS;
+	defer_pos = 0;
+	home_moves = 0;
+	az_zero = el_zero = 0;
+	have_zero = false;
+	plan_active = plan_flip = false;
+	plan_az = 0;
+	learn_ok = false;
+	learn_t = 0;
+	last_save = 0;
+	resting = false;
+	last_motion = 0;
+#if GIMBAL_AZ_STEPPER
+	az_offset = 0;
+	have_offset = false;
+#endif
 	installCalibration();
 }
 
@@ -102,11 +126,36 @@ void Gimbal::resetInitStep()
 * @param az_t "target" azimuth in degrees
 * @param el_t "target" elevation in degrees
 *
-* This function blocks while reading Sensor.
+* If not calibrated this starts calibration instead, and targets are ignored until it finishes.
+* In closed-loop mode this just records the target for track().
+* Otherwise this function blocks while reading Sensor, unless the Sensor task is publishing samples.
 * Make sure sensor is connected before calling!
 */
 void Gimbal::moveToAzEl(float az_t, float el_t)
 {
+	//< calibration owns the motors until it finishes
+	if (isCalibrating) {
+		return;
+	}
+	if (!calibrated()) {
+		startCalibration();
+		return;
+	}
+	//< a new target brings the outputs back from rest() at once
+	if (az_t != az_loop.target || el_t != el_loop.target) {
+		last_motion = millis();
+		wake();
+	}
+	//< kept in either mode, for status
+	az_loop.target = az_t;
+	el_loop.target = el_t;
+	if (resting) {
+		return;
+	}
+	if (closed_loop) {
+		have_target = true;
+		return;
+	}
 	uint32_t _now = millis();
 	//< only update every UPD_PERIOD
 	if (_now < last_update + UPD_PERIOD) {
@@ -117,13 +166,16 @@ void Gimbal::moveToAzEl(float az_t, float el_t)
 	}
 	last_update = _now;
 	//< read current sensor orientation
-	//< this blocks main->loop() especially while calibrating
-	sensor->readAzElT();
+	//< without the Sensor task this blocks main->loop()
+	if (!sensor->taskRunning()) {
+		sensor->readAzElT();
+	}
 	//< get sensor azimuth angle in degrees
 	float _az_s = sensor->getSensorAz();
 	//< get sensor elevation angle in degrees
 	float _el_s = sensor->getSensorEl();
-	if (_az_s < 0 || _az_s > 360 || _el_s < 0 || _el_s > 90) {
+	//< hold still while the Sensor is flagged invalid
+	if (!sensor->valid() || _az_s < 0 || _az_s > 360 || _el_s < 0 || _el_s > 90) {
 		return;
 	}
 	if (gimbal->DEBUG_GIMBAL) {
@@ -135,13 +187,8 @@ void Gimbal::moveToAzEl(float az_t, float el_t)
 	}
 	//< only check further when motion has stopped as evidenced by stable sensor values
 	if (fabs(azDist(prevfast_az, _az_s)) < MAX_SETTLE && fabs(_el_s - prevfast_el) < MAX_SETTLE) {
-		//< seek target if calibrated, else calibrate
-		if (calibrated()) {
-			seekTarget(az_t, el_t, _az_s, _el_s);
-		} else {
-			calibrate(_az_s, _el_s);
-		}
-		//< preserve sensor angles for next stopped iteration; only for calibration or re-calibration
+		seekTarget(az_t, el_t, _az_s, _el_s);
+		//< preserve sensor angles for next stopped iteration; only for re-calibration
 		prevstop_az = _az_s;
 		prevstop_el = _el_s;
 	}
@@ -160,9 +207,393 @@ void Gimbal::moveToAzEl(float az_t, float el_t)
 	}
 }
 
+/*! @brief run one tick of the closed-loop controller towards the latest moveToAzEl() target
+*
+* Call this at a fixed rate from loop(). Each axis is driven by a PI loop using the motor
+* with the most effect in that axis, as in seekTarget(), and is commanded every tick
+* rather than waiting for the gimbal to settle.
+*/
+void Gimbal::track()
+{
+#if GIMBAL_AZ_STEPPER
+	stepper->service();					//< every tick, calibrating and homing too
+#endif
+	if (!closed_loop || !have_target || !gimbal_found || !calibrated() || isCalibrating || resting) {
+		return;
+	}
+	uint32_t _now = millis();
+	uint32_t _dt_ms = _now - last_track;
+	last_track = _now;
+	if (!sensor->taskRunning()) {
+		sensor->readAzElT();
+	}
+	float _az_s = sensor->getSensorAz();
+	float _el_s = sensor->getSensorEl();
+	//< hold still while the Sensor is flagged invalid, and learn nothing from it
+	if (!sensor->valid() || _az_s < 0 || _az_s > 360 || _el_s < 0 || _el_s > 90) {
+		learn_ok = false;
+		return;
+	}
+	MotorInfo *azmip = &motor[best_azmotor];
+	MotorInfo *elmip = &motor[best_elmotor];
+	//< start again from the last commanded positions if we haven't run in a while
+	float _dt = _dt_ms / 1000.0;
+	if (_dt_ms > TRACK_STALE) {
+		resetLoop(az_loop, azmip);
+		resetLoop(el_loop, elmip);
+		_dt = 0;
+		learn_ok = false;
+	}
+	//< errors in mount angles: past the zenith el counts on beyond 90, and a plan unwraps az
+#if GIMBAL_AZ_STEPPER
+	float _az_raw = _az_s;					//< stepAz() works from the sensor's own az
+#endif
+	float _el_raw = _el_s;
+	toMount(_az_s, _el_s);
+	float _az_err, _el_err;
+	if (plan_active) {
+		float _az_t = az_loop.target + (plan_flip ? 180 : 0);
+		plan_az = wrapNear(plan_az, _az_t);
+		_az_err = plan_az - _az_s;			//< the plan's wrap keeps this inside the az motor's reach
+		_el_err = (plan_flip ? 180 - el_loop.target : el_loop.target) - _el_s;
+	} else {
+		_az_err = wrapNear(_az_s, az_loop.target) - _az_s;
+		_el_err = el_loop.target - _el_s;
+	}
+	//< the motion since the last sample refines the calibration, before this tick adds to it;
+	//< not while slewing, the sensor lags and a sample would take the lag for a scale error
+	if (fabs(_az_err) > LEARN_MAX_ERR || fabs(_el_err) > LEARN_MAX_ERR) {
+		learn_ok = false;
+	} else if (!learn_ok || _now - learn_t >= LEARN_PERIOD) {
+		learn(_az_s, _el_s, _el_raw);
+	}
+	if (gimbal->DEBUG_GIMBAL) {
+		Serial.print(F("Track err (az, el): ("));
+		Serial.print(_az_err, 2); Serial.print(F(", ")); Serial.print(_el_err, 2); Serial.println(F(")"));
+	}
+	uint16_t _pos[NMOTORS];
+	bool _swing = false;
+#if GIMBAL_AZ_STEPPER
+	//< the stepper plans its own moves, and turns as far as it needs: no limits, no swing
+	stepAz(_az_raw, az_loop.target);
+	_pos[0] = motor[0].pos;
+#else
+	//< at an Az limit and still pushing into it: swing back to near opposite limit, as seekTarget() does;
+	//< a plan was checked to stay clear of them, so it has no swing
+	if (plan_active) {
+		_pos[best_azmotor] = stepLoop(az_loop, azmip, _az_err, azmip->az_scale, _dt);
+	} else if (azmip->atmin && _az_err * azmip->az_scale < 0) {
+		_pos[best_azmotor] = azmip->min + 0.9 * (azmip->max - azmip->min);
+		_swing = true;
+	} else if (azmip->atmax && _az_err * azmip->az_scale > 0) {
+		_pos[best_azmotor] = azmip->min + 0.1 * (azmip->max - azmip->min);
+		_swing = true;
+	} else {
+		_pos[best_azmotor] = stepLoop(az_loop, azmip, _az_err, azmip->az_scale, _dt);
+	}
+#endif
+	_pos[best_elmotor] = stepLoop(el_loop, elmip, _el_err, elmip->el_scale, _dt);
+	//< both axes in one write, and none at all if neither moved
+	if (_pos[0] != motor[0].pos || _pos[1] != motor[1].pos) {
+		setMotorPositions(_pos);
+	}
+	if (_swing) {
+		resetLoop(az_loop, azmip);
+		learn_ok = false;					//< the sensor can't keep up with a swing
+	}
+}
+
+/*! @brief restart an axis controller, bumpless from the motor's last commanded position
+* @param loop the axis controller
+* @param mip the motor driving that axis
+*/
+void Gimbal::resetLoop(AxisLoop &loop, MotorInfo *mip)
+{
+	loop.integ = mip->pos;
+}
+
+/*! @brief compute the next position for one axis
+*
+* The servo is a position actuator, so the integrator holds the commanded pulse width and
+* the proportional term is added on top. Output is slew limited and clamped to the motor
+* limits; when either clips, the integrator is backed off to match (anti-windup).
+* @param loop the axis controller
+* @param mip the motor driving that axis
+* @param err pointing error in degrees
+* @param scale motor scale for this axis, usec per degree
+* @param dt seconds since previous tick
+* @return new motor position in usec
+*/
+uint16_t Gimbal::stepLoop(AxisLoop &loop, MotorInfo *mip, float err, float scale, float dt)
+{
+	float _p = TRACK_KP * err * scale;
+	float _i = constrain(loop.integ + TRACK_KI * err * scale * dt, (float)mip->min, (float)mip->max);
+	float _out = constrain(_i + _p, (float)mip->pos - TRACK_MAX_SLEW, (float)mip->pos + TRACK_MAX_SLEW);
+	_out = constrain(_out, (float)mip->min, (float)mip->max);
+	if (_out != _i + _p) {
+		_i = constrain(_out - _p, (float)mip->min, (float)mip->max);
+	}
+	loop.integ = _i;
+	return ((uint16_t)(_out + 0.5));
+}
+
+#if GIMBAL_AZ_STEPPER
+/*! @brief send the stepper to the step nearest its position that points at az_t
+*
+* The step count is turned into az with motor[0].az_scale and az_offset; az_offset follows
+* the sensor slowly, and only while the stepper is nearly still since the sensor lags it. The
+* move is the shortest way round, through 0/360 as often as needed.
+* @param az_s current sensor azimuth in degrees
+* @param az_t target azimuth in degrees
+*/
+void Gimbal::stepAz(float az_s, float az_t)
+{
+	float _scale = motor[0].az_scale;
+	float _here = stepper->position();
+	//< sensor az less the stepper's own idea of how far round it is
+	float _seen = fmod(az_s - _here / _scale, 360);
+	if (_seen < 0) {
+		_seen += 360;
+	}
+	if (!have_offset) {
+		az_offset = _seen;
+		have_offset = true;
+	} else if (fabs(stepper->speed()) < OFFSET_SPEED * fabs(_scale)) {
+		az_offset = fmod(az_offset + OFFSET_GAIN * azDist(az_offset, _seen) + 360, 360);
+	}
+	float _az_m = fmod(az_offset + _here / _scale, 360);
+	if (_az_m < 0) {
+		_az_m += 360;
+	}
+	stepper->setTarget(_here + azDist(_az_m, az_t) * _scale);
+}
+#endif
+
+/*! @brief turn a sensor reading into mount angles, and learn where the motors point
+*
+* The sensor sees where the antenna points, el never past 90. Over the top the mount is at
+* az + 180 and 180 - el, which the el motor's position tells apart. Mount az is unwrapped
+* to the turn the az motor's position is on.
+* @param az_s sensor azimuth in degrees, becomes mount az
+* @param el_s sensor elevation in degrees, becomes mount el
+*/
+void Gimbal::toMount(float &az_s, float &el_s)
+{
+	MotorInfo *azmip = &motor[best_azmotor];
+	MotorInfo *elmip = &motor[best_elmotor];
+	float _el_m = el_zero + elmip->pos / elmip->el_scale;
+	if (have_zero && _el_m > 90) {
+		az_s = fmod(az_s + 180, 360);
+		el_s = 180 - el_s;
+	} else if (el_s < EL_SURE && (!have_zero || _el_m < EL_SURE)) {
+		float _seen = el_s - elmip->pos / elmip->el_scale;
+		el_zero = have_zero ? el_zero + ZERO_GAIN * (_seen - el_zero) : _seen;
+	}
+	float _seen = az_s - azmip->pos / azmip->az_scale;
+	if (!have_zero) {
+		//< the first reading surely the right way up starts the model
+		if (el_s < EL_SURE) {
+			az_zero = _seen;
+			have_zero = true;
+		}
+		return;
+	}
+	az_zero += ZERO_GAIN * azDist(az_zero, _seen);	//< never renormalized, the plan's turns count from it
+#if !GIMBAL_AZ_STEPPER
+	az_s = wrapNear(az_zero + azmip->pos / azmip->az_scale, az_s);
+#endif
+}
+
+/*! @brief the angle az + 360k nearest ref
+* @param ref degrees, any turn
+* @param az degrees
+*/
+float Gimbal::wrapNear(float ref, float az)
+{
+	float _d = fmod(az - ref, 360);
+	if (_d > 180) {
+		_d -= 360;
+	} else if (_d < -180) {
+		_d += 360;
+	}
+	return (ref + _d);
+}
+
+/*! @brief the mount angles the motors can reach, for planning a pass
+*
+* az is on the same turns as the pass plan's az_start; el goes past 90 if the mount can go over the top.
+* @param az_lo receives the least mount az, degrees
+* @param az_hi receives the greatest mount az, degrees
+* @param el_lo receives the least mount el, degrees
+* @param el_hi receives the greatest mount el, degrees
+* @return false until calibrated and the sensor has been seen
+*/
+bool Gimbal::reach(float &az_lo, float &az_hi, float &el_lo, float &el_hi)
+{
+	if (!gimbal_found || !calibrated() || !have_zero) {
+		return (false);
+	}
+	MotorInfo *azmip = &motor[best_azmotor];
+	MotorInfo *elmip = &motor[best_elmotor];
+	float _a = az_zero + azmip->min / azmip->az_scale;
+	float _b = az_zero + azmip->max / azmip->az_scale;
+	az_lo = min(_a, _b);
+	az_hi = max(_a, _b);
+	_a = el_zero + elmip->min / elmip->el_scale;
+	_b = el_zero + elmip->max / elmip->el_scale;
+	el_lo = min(_a, _b);
+	el_hi = max(_a, _b);
+#if GIMBAL_AZ_STEPPER
+	//< the stepper turns as far as it needs, and stepAz() has no use for going over the top
+	az_lo = -1e6;
+	az_hi = 1e6;
+	el_hi = min(el_hi, 90.0f);
+#endif
+	return (true);
+}
+
+/*! @brief track the coming pass from one wrap, and over the top if flip, instead of the shortest way
+*
+* From Tracker, once per pass before it is tracked. az_start is where the planner found the whole
+* pass stays within reach(); later targets are unwrapped from it.
+* @param flip true to point the mount at az + 180, 180 - el
+* @param az_start mount az of the first point of the pass, degrees, from the turns of reach()
+*/
+void Gimbal::setPlan(bool flip, float az_start)
+{
+	plan_active = true;
+	plan_flip = flip;
+	plan_az = az_start;
+}
+
+/*! @brief back to the shortest way; a mount left over the top comes back by itself, toMount() follows it
+*/
+void Gimbal::endPlan()
+{
+	plan_active = false;
+	plan_flip = false;
+}
+
+/*! @brief choose between closed-loop tracking and settle-then-step tracking
+* @param on true for closed-loop tracking with track()
+*/
+void Gimbal::setClosedLoop(bool on)
+{
+	closed_loop = on;
+	have_target = false;
+	last_track = 0;
+}
+
+/*! @brief begin the calibration series from step 0
+*
+* Nothing blocks: serviceCalibration() does the work a step at a time as the gimbal settles.
+*/
+void Gimbal::startCalibration()
+{
+	if (isCalibrating || !gimbal_found || !sensor->connected()) {
+		return;
+	}
+	wake();
+	resetInitStep();
+	isCalibrating = true;
+	have_target = false;
+	cal_phase = CAL_STEP;
+	cal_start = cal_wait = millis();
+	have_zero = false;
+	learn_ok = false;
+	defer_motor = NMOTORS;
+	prevfast_az = prevfast_el = -1000;
+	webpage->setUserMessage(F("Calibrating gimbal"));
+}
+
+/*! @brief run the calibration state machine; call this frequently from loop()
+*
+* Waits are timestamps rather than delay(), so Serial and WiFi keep being serviced.
+* Each calibrate() step runs once two sensor readings CAL_SETTLE_PERIOD apart agree within
+* MAX_SETTLE, then the gimbal is sent home with N_HOME_MOVES settle-then-step moves.
+* A calibration still running after CAL_TIMEOUT, say for want of a good Sensor, is abandoned.
+*/
+void Gimbal::serviceCalibration()
+{
+	if (cal_phase == CAL_IDLE) {
+		return;
+	}
+	uint32_t _now = millis();
+	if (_now - cal_start >= CAL_TIMEOUT) {
+		cal_phase = CAL_IDLE;
+		isCalibrating = false;
+		defer_motor = NMOTORS;
+		if (calibrated()) {
+			webpage->setUserMessage(F("Gimbal calibrated, but did not get home"));
+		} else {
+			webpage->setUserMessage(F("Gimbal calibration timed out!"));
+		}
+		return;
+	}
+	if ((int32_t)(_now - cal_wait) < 0) {
+		return;
+	}
+	//< second motor of a two-motor move
+	if (defer_motor < NMOTORS) {
+		setMotorPosition(defer_motor, defer_pos);
+		defer_motor = NMOTORS;
+		cal_wait = _now + CAL_MOVE_WAIT;
+		return;
+	}
+#if GIMBAL_AZ_STEPPER
+	//< the stepper knows when it has stopped, and the sensor can't see a slow homing pass
+	if (stepper->homing() || stepper->speed() != 0) {
+		cal_wait = _now + CAL_SETTLE_PERIOD;
+		return;
+	}
+#endif
+	if (!sensor->taskRunning()) {
+		sensor->readAzElT();
+	}
+	float _az_s = sensor->getSensorAz();
+	float _el_s = sensor->getSensorEl();
+	cal_wait = _now + CAL_SETTLE_PERIOD;
+	//< hold still while the Sensor is flagged invalid
+	if (!sensor->valid() || _az_s < 0 || _az_s > 360 || _el_s < 0 || _el_s > 90) {
+		return;
+	}
+	bool _settled = fabs(azDist(prevfast_az, _az_s)) < MAX_SETTLE && fabs(_el_s - prevfast_el) < MAX_SETTLE;
+	prevfast_az = _az_s;
+	prevfast_el = _el_s;
+	if (!_settled) {
+		return;
+	}
+	if (cal_phase == CAL_STEP) {
+		calibrate(_az_s, _el_s);
+		if (calibrated()) {
+			cal_phase = CAL_HOME;
+			home_moves = 0;
+			cal_wait = millis() + CAL_HOME_WAIT;
+		}
+	} else {
+		float _home_az = G_HOME_AZ;
+		float _home_el = G_HOME_EL;
+		//< settled with the axes assigned: start the mount model, so a pass can be planned before it is tracked
+		float _az_m = _az_s, _el_m = _el_s;
+		toMount(_az_m, _el_m);
+		seekTarget(_home_az, _home_el, _az_s, _el_s);
+		if (++home_moves >= N_HOME_MOVES) {
+			cal_phase = CAL_IDLE;
+			isCalibrating = false;
+			webpage->setUserMessage(F("Gimbal calibrated+"));
+		} else {
+			cal_wait = millis() + CAL_HOME_WAIT;
+		}
+	}
+	//< preserve sensor angles for next stopped iteration
+	prevstop_az = _az_s;
+	prevstop_el = _el_s;
+}
+
 /*! @brief run the next step of the initial scale calibration series.
 *
 * steps proceed using init_step up to N_INIT_STEPS
+* Instead of waiting here for motors, set cal_wait for serviceCalibration().
 * @param az_s is current sensor azimuth angle in degrees
 * @param el_s is current sensor elevation angle in degrees
 */
@@ -171,8 +602,6 @@ void Gimbal::calibrate(float &az_s, float &el_s)
 	//< handy step ranges
 	uint16_t _range0 = motor[0].max - motor[0].min;
 	uint16_t _range1 = motor[1].max - motor[1].min;
-	//webpage->setUserMessage(F("Calibrating gimbal"));
-	isCalibrating = true;
 	//< init_step starts at 0; incremented each time function is called
 	switch (init_step++) {
 
@@ -183,11 +612,23 @@ void Gimbal::calibrate(float &az_s, float &el_s)
 			Serial.print(F("Init 0: Mot 1 Moves: "));
 			Serial.println(motor[1].min + _range1 * (1 - CAL_FRAC) / 2, 0);
 		}
+		//< the moves that follow are the estimator's first samples, and overrule what it had:
+		//< after a remount or a motor swap the old J may be far off, even of the wrong sign
+		cal.clear();
+#if GIMBAL_AZ_STEPPER
+		//< home the stepper while motor 1 moves near min; serviceCalibration() waits for both
+		stepper->startHoming();
+		have_offset = false;
+		setMotorPosition(1, motor[1].min + _range1 * (1 - CAL_FRAC) / 2);
+		cal_wait = millis() + CAL_MOVE_WAIT;
+#else
 		//< move near min of each range. setMotorPosition() uses microseconds
 		setMotorPosition(0, motor[0].min + _range0 * (1 - CAL_FRAC) / 2);
-		delay(100); //< wait until motor 0 starts moving before starting the other motor
-		setMotorPosition(1, motor[1].min + _range1 * (1 - CAL_FRAC) / 2);
-		delay(500);
+		//< wait until motor 0 starts moving before starting the other motor
+		defer_motor = 1;
+		defer_pos = motor[1].min + _range1 * (1 - CAL_FRAC) / 2;
+		cal_wait = millis() + CAL_MOTOR_GAP;
+#endif
 		break;
 
 	case 1:
@@ -198,14 +639,25 @@ void Gimbal::calibrate(float &az_s, float &el_s)
 			Serial.print(F("\tMoves\t"));
 			Serial.println(_range0 * CAL_FRAC, 0);
 		}
+#if GIMBAL_AZ_STEPPER
+		stepper->setTarget(stepper->position() + CAL_AZ_DEG * Motor1::actuator::STEPS_PER_DEG);
+#else
 		setMotorPosition(0, motor[0].pos + _range0 * CAL_FRAC);
-		delay(500);
+#endif
+		cal_wait = millis() + CAL_MOVE_WAIT;
 		break;
 
 	case 2:
 		//< calculate scale of motor 0
-		motor[0].az_scale = _range0 * CAL_FRAC / azDist(prevstop_az, az_s);
-		motor[0].el_scale = _range0 * CAL_FRAC / (el_s - prevstop_el);
+#if GIMBAL_AZ_STEPPER
+		motor[0].az_scale = CAL_AZ_DEG * Motor1::actuator::STEPS_PER_DEG / azDist(prevstop_az, az_s);
+		motor[0].el_scale = CAL_AZ_DEG * Motor1::actuator::STEPS_PER_DEG / (el_s - prevstop_el);
+		cal.set(CalEstimator::AZ, 0, 1 / motor[0].az_scale);
+		cal.set(CalEstimator::EL, 0, 1 / motor[0].el_scale);
+#else
+		cal.update(_range0 * CAL_FRAC, 0, azDist(prevstop_az, az_s), el_s - prevstop_el, false);
+		scalesFromEstimate();
+#endif
 		if (gimbal->DEBUG_GIMBAL) {
 			Serial.print(F("Init 2: Mot 0 ended  at (az/el): ("));
 			Serial.print(az_s, 1); Serial.print(F(", ")); Serial.print(el_s, 1);
@@ -217,7 +669,7 @@ void Gimbal::calibrate(float &az_s, float &el_s)
 		}
 		//< repeat procedure for motor 1
 		setMotorPosition(1, motor[1].pos + _range1 * CAL_FRAC);
-		delay(500);
+		cal_wait = millis() + CAL_MOVE_WAIT;
 		if (gimbal->DEBUG_GIMBAL) {
 			Serial.print(F("Init 2: Mot 1 starts at (az, el): ("));
 			Serial.print(az_s, 1); Serial.print(F(", ")); Serial.print(el_s, 1);
@@ -227,8 +679,8 @@ void Gimbal::calibrate(float &az_s, float &el_s)
 
 	case 3:
 		//< calculate scale of motor 1
-		motor[1].az_scale = _range1 * CAL_FRAC / azDist(prevstop_az, az_s);
-		motor[1].el_scale = _range1 * CAL_FRAC / (el_s - prevstop_el);
+		cal.update(0, _range1 * CAL_FRAC, azDist(prevstop_az, az_s), el_s - prevstop_el, false);
+		scalesFromEstimate();
 		if (gimbal->DEBUG_GIMBAL) {
 			Serial.print(F("Init 3: Mot 1 ended  at (az, el): "));
 			Serial.print(az_s, 1); Serial.print(F(", "));
@@ -238,16 +690,15 @@ void Gimbal::calibrate(float &az_s, float &el_s)
 			Serial.print(motor[1].az_scale, 2); Serial.print(F(", "));
 			Serial.print(motor[1].el_scale, 2); Serial.println(F(")"));
 		}
-		//< select best motor for az
-		best_azmotor = fabs(motor[0].az_scale) < fabs(motor[1].az_scale) ? 0 : 1;
+		//< select best motor for az; a stepper is always az
+		assignAxes(GIMBAL_AZ_STEPPER || fabs(motor[0].az_scale) < fabs(motor[1].az_scale) ? 0 : 1);
 		if (gimbal->DEBUG_GIMBAL) {
 			Serial.print(F("Best Az motor: ")); Serial.print(best_azmotor);
 			Serial.print(F("\tScale: ")); Serial.print(motor[best_azmotor].az_scale);
-			Serial.print(F("\tEl motor: ")); Serial.print(!best_azmotor);
-			Serial.print(F("\tScale: ")); Serial.println(motor[!best_azmotor].el_scale);
+			Serial.print(F("\tEl motor: ")); Serial.print(best_elmotor);
+			Serial.print(F("\tScale: ")); Serial.println(motor[best_elmotor].el_scale);
 		}
 		saveCalibration(); //< finished calibration, save to EEPROM
-		isCalibrating = false;
 		break;
 
 	default:
@@ -273,7 +724,7 @@ void Gimbal::seekTarget(float &az_t, float &el_t, float &az_s, float &el_s)
 	*/
 	//< correct each error using motor with most effect in that axis
 	MotorInfo *azmip = &motor[best_azmotor];
-	MotorInfo *elmip = &motor[!best_azmotor];
+	MotorInfo *elmip = &motor[best_elmotor];
 	if (gimbal->DEBUG_GIMBAL) {
 		Serial.print(F("Seeking target at (az, el): ("));
 		Serial.print(az_t, 1); Serial.print(F(", ")); Serial.print(el_t, 1); Serial.println(F(")"));
@@ -287,18 +738,34 @@ void Gimbal::seekTarget(float &az_t, float &el_t, float &az_s, float &el_s)
 		Serial.print(F("\tel_error, deg: ")); Serial.print(_el_err, 1); 
 		Serial.print(F(", us: ")); Serial.println(_el_err * elmip->el_scale, 0);
 	}
-	// tweak scale if move was substantial and sanity check by believing only small changes
-	reCal(az_s, el_s);
+	// the move since the previous stop refines the calibration
+	learn(az_s, el_s, el_s);
 	// move each motor to reduce error, but if at Az limit then swing back to near opposite limit
+	uint16_t _pos[NMOTORS];
+#if GIMBAL_AZ_STEPPER
+	stepAz(az_s, az_t);
+	_pos[0] = motor[0].pos;
+#else
 	if (azmip->atmin) {
-		setMotorPosition(best_azmotor, azmip->min + 0.9 * (azmip->max - azmip->min));
+		_pos[best_azmotor] = azmip->min + 0.9 * (azmip->max - azmip->min);
 	} else if (azmip->atmax) {
-		setMotorPosition(best_azmotor, azmip->min + 0.1 * (azmip->max - azmip->min));
+		_pos[best_azmotor] = azmip->min + 0.1 * (azmip->max - azmip->min);
 	} else {
-		setMotorPosition(best_azmotor, azmip->pos + _az_err * azmip->az_scale);
+		_pos[best_azmotor] = azmip->pos + _az_err * azmip->az_scale;
 	}
-	// set elevation motor (!best_azmotor)
-	setMotorPosition(!best_azmotor, elmip->pos + _el_err * elmip->el_scale);
+#endif
+	// set elevation motor (best_elmotor)
+	_pos[best_elmotor] = elmip->pos + _el_err * elmip->el_scale;
+	setMotorPositions(_pos);
+}
+
+/*! @brief record which motor drives az after calibration; the other one drives el
+* @param az_motor motor[] index with most effect in az
+*/
+void Gimbal::assignAxes(uint8_t az_motor)
+{
+	best_azmotor = az_motor;
+	best_elmotor = NMOTORS - 1 - az_motor;
 }
 
 /*! @brief given two azimuth values, return path length going shortest direction
@@ -327,6 +794,11 @@ void Gimbal::saveCalibration()
 	nv->init_step = init_step;
 	// save in EEPROM
 	nv->put();
+	for (uint8_t i = 0; i < NMOTORS; i++) {
+		saved_gain[CalEstimator::AZ][i] = cal.gain(CalEstimator::AZ, i);
+		saved_gain[CalEstimator::EL][i] = cal.gain(CalEstimator::EL, i);
+	}
+	last_save = millis();
 }
 
 /*! @brief install previously stored calibration data from EEPROM if it looks valid.
@@ -335,49 +807,134 @@ void Gimbal::installCalibration()
 {
 	nv->get();				   //< set from NV
 	init_step = nv->init_step; //< indicates gimbal calibrated
-	best_azmotor = nv->best_az_motor;
+	assignAxes(nv->best_az_motor > 1 ? 0 : nv->best_az_motor);
 	motor[0].az_scale = nv->m0_azscale;
 	motor[0].el_scale = nv->m0_elscale;
 	motor[1].az_scale = nv->m1_azscale;
 	motor[1].el_scale = nv->m1_elscale;
-	//< sanity check on calibration scales
-	if (fabs(motor[best_azmotor].az_scale > 50) || fabs(motor[!best_azmotor].el_scale > 50) 
-			|| init_step != 4 || best_azmotor < 0 || best_azmotor > 1) {
+	//< sanity check on calibration scales; a stepper's are steps, and only need to be there
+	bool _az_bad = GIMBAL_AZ_STEPPER ? motor[0].az_scale == 0 || nv->best_az_motor != 0
+			: fabs(motor[best_azmotor].az_scale > 50);
+	if (_az_bad || fabs(motor[best_elmotor].el_scale > 50) 
+			|| init_step != 4 || nv->best_az_motor > 1) {
 		//< request new calibration
 		init_step = 0;
 	}
+	//< the estimator starts from the saved scales, as sure of them as of a calibration's moves
+	for (uint8_t i = 0; i < NMOTORS; i++) {
+		saved_gain[CalEstimator::AZ][i] = motor[i].az_scale != 0 ? 1 / motor[i].az_scale : 0;
+		saved_gain[CalEstimator::EL][i] = motor[i].el_scale != 0 ? 1 / motor[i].el_scale : 0;
+		cal.set(CalEstimator::AZ, i, saved_gain[CalEstimator::AZ][i]);
+		cal.set(CalEstimator::EL, i, saved_gain[CalEstimator::EL][i]);
+	}
+	cal.reset(NV_P0);
 }
 
-/*! @brief re-calibrate motor scales if motion is great enough and scale difference is small enough
-*  during seekTarget move
+/*! @brief take the motion since the previous call as a calibration sample, and start the next one
+*
+* The sample waits, up to LEARN_MAX_WAIT, until the motors have moved LEARN_MIN_MOVE between
+* them. Near the zenith az says little about the motors, so no sample spans it. A stepper's
+* share of the motion is known from its steps, and taken out before the estimator sees it.
+* @param az_m mount azimuth in degrees
+* @param el_m mount elevation in degrees
+* @param el_s sensor elevation in degrees
 */
-void Gimbal::reCal(float &az_s, float &el_s)
+void Gimbal::learn(float az_m, float el_m, float el_s)
 {
-	MotorInfo *azmip = &motor[best_azmotor];
-	MotorInfo *elmip = &motor[!best_azmotor];
-	const float MIN_ANGLE = 30;	  //< min acceptable move
-	const float MAX_CHANGE = 0.1; //< max fractional scale change
-	float _az_move = azDist(prevstop_az, az_s);
-	if (fabs(_az_move) >= MIN_ANGLE) {
-		float _new_az_scale = azmip->del_pos / _az_move;
-		if (fabs((_new_az_scale - azmip->az_scale) / azmip->az_scale) < MAX_CHANGE) {
-			if (gimbal->DEBUG_GIMBAL) {
-				Serial.print(F("New Az scale: "));
-				Serial.print(azmip->az_scale); Serial.print(F("\t->\t")); Serial.println(_new_az_scale);
+	uint32_t _now = millis();
+	float _pos[NMOTORS];
+	for (uint8_t i = 0; i < NMOTORS; i++) {
+		_pos[i] = motor[i].pos;
+	}
+#if GIMBAL_AZ_STEPPER
+	_pos[0] = stepper->position();
+#endif
+	if (el_s >= EL_SURE) {
+		learn_ok = false;
+		return;
+	}
+	if (learn_ok) {
+		float _dpos0 = _pos[0] - learn_pos[0];
+		float _dpos1 = _pos[1] - learn_pos[1];
+		float _daz = azDist(learn_az, az_m);
+		float _del = el_m - learn_el;
+		if (fabs(_dpos0) + fabs(_dpos1) < LEARN_MIN_MOVE) {
+			if (_now - learn_t < LEARN_MAX_WAIT) {
+				return;
+			}
+		} else {
+#if GIMBAL_AZ_STEPPER
+			_daz -= _dpos0 / motor[0].az_scale;
+			_del -= _dpos0 / motor[0].el_scale;
+			_dpos0 = 0;
+#endif
+			if (cal.update(_dpos0, _dpos1, _daz, _del)) {
+				useEstimate();
+			} else {
+				metrics->count(C_CAL_REJECT);
 			}
-			azmip->az_scale = _new_az_scale;
 		}
 	}
-	float _el_move = el_s - prevstop_el;
-	if (fabs(_el_move) >= MIN_ANGLE) {
-		float _new_el_scale = elmip->del_pos / _el_move;
-		if (fabs((_new_el_scale - elmip->el_scale) / elmip->el_scale) < MAX_CHANGE) {
-			if (gimbal->DEBUG_GIMBAL) {
-				Serial.print(F("New El scale: "));
-				Serial.print(elmip->el_scale); Serial.print(F("\t->\t")); Serial.println(_new_el_scale);
-			}
-			elmip->el_scale = _new_el_scale;
+	for (uint8_t i = 0; i < NMOTORS; i++) {
+		learn_pos[i] = _pos[i];
+	}
+	learn_az = az_m;
+	learn_el = el_m;
+	learn_t = _now;
+	learn_ok = true;
+}
+
+/*! @brief whether the estimate is good enough to steer by: every term the estimator learns is
+*  known to CAL_CONVERGED, from at least CAL_MIN_SAMPLES samples
+*/
+bool Gimbal::converged()
+{
+	if (cal.samples() < CAL_MIN_SAMPLES) {
+		return (false);
+	}
+	for (uint8_t i = FIRST_PWM; i < NMOTORS; i++) {
+		if (cal.relErr(CalEstimator::AZ, i) >= CAL_CONVERGED || cal.relErr(CalEstimator::EL, i) >= CAL_CONVERGED) {
+			return (false);
+		}
+	}
+	return (true);
+}
+
+/*! @brief steer by the estimate once it has converged, and save it now and then as it drifts
+*
+* An estimate that would turn either axis the other way is not believed; that takes a new calibration.
+*/
+void Gimbal::useEstimate()
+{
+	if (!calibrated() || isCalibrating || !converged()) {
+		return;
+	}
+	if (cal.gain(CalEstimator::AZ, best_azmotor) * motor[best_azmotor].az_scale <= 0
+			|| cal.gain(CalEstimator::EL, best_elmotor) * motor[best_elmotor].el_scale <= 0) {
+		return;
+	}
+	scalesFromEstimate();
+	float _change = 0;
+	for (uint8_t i = FIRST_PWM; i < NMOTORS; i++) {
+		float _big = max(fabsf(cal.gain(CalEstimator::AZ, i)), fabsf(cal.gain(CalEstimator::EL, i)));
+		_change = max(_change, fabsf(cal.gain(CalEstimator::AZ, i) - saved_gain[CalEstimator::AZ][i]) / _big);
+		_change = max(_change, fabsf(cal.gain(CalEstimator::EL, i) - saved_gain[CalEstimator::EL][i]) / _big);
+	}
+	if (_change > CAL_SAVE_CHANGE && millis() - last_save >= CAL_SAVE_PERIOD) {
+		if (gimbal->DEBUG_GIMBAL) {
+			Serial.print(F("Saving calibration, changed by ")); Serial.println(_change, 3);
 		}
+		saveCalibration();
+	}
+}
+
+/*! @brief set the motor scales the estimator learns from its terms
+*/
+void Gimbal::scalesFromEstimate()
+{
+	for (uint8_t i = FIRST_PWM; i < NMOTORS; i++) {
+		motor[i].az_scale = 1 / cal.gain(CalEstimator::AZ, i);
+		motor[i].el_scale = 1 / cal.gain(CalEstimator::EL, i);
 	}
 }
 
@@ -387,9 +944,33 @@ void Gimbal::reCal(float &az_s, float &el_s)
 */
 void Gimbal::setMotorPosition(uint8_t motn, uint16_t newpos)
 {
-	if (motn >= NMOTORS || !gimbal_found) {
+	if (motn < FIRST_PWM || motn >= NMOTORS || !gimbal_found) {
 		return;
 	}
+	stagePosition(motn, newpos);
+	writeMotors();
+}
+
+/*! @brief move both motors at once, in one I2C transaction
+* @param newpos new position of each motor in microseconds, by motor number
+*/
+void Gimbal::setMotorPositions(const uint16_t newpos[NMOTORS])
+{
+	if (!gimbal_found) {
+		return;
+	}
+	for (uint8_t i = FIRST_PWM; i < NMOTORS; i++) {
+		stagePosition(i, newpos[i]);
+	}
+	writeMotors();
+}
+
+/*! @brief record a new motor position, clamped at limit, without sending it
+* @param motn is the motor number
+* @param newpos is the new position in microseconds
+*/
+void Gimbal::stagePosition(uint8_t motn, uint16_t newpos)
+{
 	MotorInfo *mip = &motor[motn];
 	mip->atmin = (newpos <= mip->min);
 	if (mip->atmin) {
@@ -405,97 +986,263 @@ void Gimbal::setMotorPosition(uint8_t motn, uint16_t newpos)
 		Serial.print(F("Set motor position: "));
 		Serial.println(newpos);
 	}
-	pwm->setPWM(mip->servo_num, 0, mip->pos / US_PER_BIT);
-	if (readPWM(mip->servo_num, true) != 0 || readPWM(mip->servo_num, false != mip->pos / US_PER_BIT)){
-		// send again; could also dis-able the PCA9685 before re-sending
-		pwm->setPWM(mip->servo_num, 0, mip->pos / US_PER_BIT);
-		if (gimbal->DEBUG_GIMBAL) {
-			Serial.println(F("I2C bus error, rewriting motor position"));
-		}
+}
+
+/*! @brief a motor limit entered by the user, kept within the servo frame
+* @param us pulse width in microseconds
+*/
+uint16_t Gimbal::limitPulse(int us)
+{
+	return (constrain(us, 0, (int)Servo::MAX_US - 1));
+}
+
+/*! @brief send every motor's last commanded position to the PCA9685 in one burst
+*
+* The motor channels are adjacent, so with MODE1 auto-increment (set by setPWMFreq())
+* both ON/OFF register pairs go in a single transaction. The outputs are checked against
+* motor[].pos later by checkOutputs(), not read back here.
+*/
+void Gimbal::writeMotors()
+{
+	uint8_t _regs[4 * (NMOTORS - FIRST_PWM)];
+	for (uint8_t i = FIRST_PWM; i < NMOTORS; i++) {
+		uint16_t _off = Servo::toCounts(motor[i].pos);
+		uint8_t *_rp = &_regs[4 * (motor[i].servo_num - PWM_BASE)];
+		_rp[0] = 0;						//< ON at count 0
+		_rp[1] = 0;
+		_rp[2] = _off & 0xff;			//< OFF at the pulse width
+		_rp[3] = _off >> 8;
 	}
+	TwoWire &_wire = i2cbus->wire(I2C_PWM);
+	i2cbus->lock(I2C_PWM);
+	uint32_t _t0 = Metrics::start();
+	_wire.beginTransmission(I2C_ADDR);
+	_wire.write(PCA9685_LED0_ON_L + 4 * PWM_BASE);
+	_wire.write(_regs, sizeof(_regs));
+	i2cbus->report(I2C_PWM, _wire.endTransmission() == 0);
+	metrics->stop(M_MOTOR_SET, _t0);
+	i2cbus->unlock(I2C_PWM);
 }
 
-/*! @brief read pulsewidth (bits 0->4096) from spec'd channel to see if it matches what we set
-* in setMotorPosition()
+/*! @brief put the PCA9685 oscillator to sleep, or start it again
+*
+* MODE1 is read first so the auto-increment setPWMFreq() chose is kept. Writing 0 to RESTART
+* does nothing; writing 1 once the oscillator is running again brings back the outputs the chip
+* had running when it went to sleep.
+* @param sleep true to stop every output
+* @return false if the PCA9685 didn't answer
+*/
+bool Gimbal::sleepOutputs(bool sleep)
+{
+	TwoWire &_wire = i2cbus->wire(I2C_PWM);
+	i2cbus->lock(I2C_PWM);
+	_wire.beginTransmission(I2C_ADDR);
+	_wire.write((uint8_t)PCA9685_MODE1);
+	bool _ok = _wire.endTransmission() == 0 && _wire.requestFrom((int)I2C_ADDR, 1) == 1;
+	uint8_t _mode = _wire.read() & ~MODE1_RESTART;
+	if (_ok) {
+		_wire.beginTransmission(I2C_ADDR);
+		_wire.write((uint8_t)PCA9685_MODE1);
+		_wire.write(sleep ? _mode | MODE1_SLEEP : _mode & ~MODE1_SLEEP);
+		_ok = _wire.endTransmission() == 0;
+	}
+	if (_ok && !sleep) {
+		delayMicroseconds(WAKE_US);
+		_wire.beginTransmission(I2C_ADDR);
+		_wire.write((uint8_t)PCA9685_MODE1);
+		_wire.write((_mode & ~MODE1_SLEEP) | MODE1_RESTART);
+		_ok = _wire.endTransmission() == 0;
+	}
+	_ok = i2cbus->report(I2C_PWM, _ok);
+	i2cbus->unlock(I2C_PWM);
+	return (_ok);
+}
+
+/*! @brief stop driving the motors between passes; the targets and positions are kept
+*
+* Not while calibrating. A stepper az stays energized, it would lose its position.
+*/
+void Gimbal::rest()
+{
+	if (!gimbal_found || resting || isCalibrating) {
+		return;
+	}
+	resting = sleepOutputs(true);
+}
+
+/*! @brief drive the motors again after rest(), from the positions they were left at
+*
+* track() starts its loops over, it finds its last tick stale.
+*/
+void Gimbal::wake()
+{
+	if (!resting) {
+		return;
+	}
+	sleepOutputs(false);
+	resting = false;
+	writeMotors();
+}
+
+/*! @brief whether the Gimbal is moving on its own: calibrating or, with a stepper, homing or finishing a move
+*/
+bool Gimbal::busy()
+{
+#if GIMBAL_AZ_STEPPER
+	if (stepper->homing() || stepper->speed() != 0) {
+		return (true);
+	}
+#endif
+	return (isCalibrating);
+}
 
-* @param motn is the channel number
-* @param on is a switch to say whether we want the "on" PWM bits or the "off" bits
-* we always set "on" to 0, but we should check if it is 0.
+/*! @brief background integrity check: read the PCA9685 outputs back and rewrite them if wrong
+*
+* Call this now and then, off the control path. One burst read covers both motors.
 * reference: https://thecavepearlproject.org/2017/11/03/configuring-i2c-sensors-with-arduino/
 */
-uint16_t Gimbal::readPWM(uint8_t motn, bool on) 
+void Gimbal::checkOutputs()
 {
-  uint16_t _value;
-  // on == true means we want to read ON PWM value; true = 1, so invert to point to PCA9685_LED0_OFF_L
-  uint8_t _register_addr = PCA9685_LED0_ON_L + 2 * (int)!on + 4 * motn;
-  Wire.beginTransmission(I2C_ADDR);      // set sensor target
-  Wire.write(_register_addr);            // set memory pointer
-  Wire.endTransmission();
-  Wire.requestFrom((int)I2C_ADDR, (int) 2); // request two bytes
-  byte _registerDataLo = Wire.read(); // get low byte
-  byte _registerDataHi = Wire.read(); // get high byte
-  _value = (((int)_registerDataHi) << 8) | _registerDataLo; // combine two bytes
-  return (_value);
+	if (!gimbal_found || !calibrated() || isCalibrating || resting) {
+		return;
+	}
+	uint8_t _regs[4 * (NMOTORS - FIRST_PWM)];
+	TwoWire &_wire = i2cbus->wire(I2C_PWM);
+	i2cbus->lock(I2C_PWM);
+	_wire.beginTransmission(I2C_ADDR);
+	_wire.write(PCA9685_LED0_ON_L + 4 * PWM_BASE);
+	bool _ok = _wire.endTransmission() == 0
+			&& _wire.requestFrom((int)I2C_ADDR, (int)sizeof(_regs)) == sizeof(_regs);
+	for (uint8_t i = 0; i < sizeof(_regs); i++) {
+		_regs[i] = _wire.read();
+	}
+	_ok = i2cbus->report(I2C_PWM, _ok);
+	i2cbus->unlock(I2C_PWM);
+	if (!_ok) {
+		return;
+	}
+	for (uint8_t i = FIRST_PWM; i < NMOTORS; i++) {
+		const uint8_t *_rp = &_regs[4 * (motor[i].servo_num - PWM_BASE)];
+		uint16_t _on = _rp[0] | _rp[1] << 8;
+		uint16_t _off = _rp[2] | _rp[3] << 8;
+		if (_on != 0 || _off != Servo::toCounts(motor[i].pos)) {
+			metrics->count(C_PWM_MISMATCH);
+			if (gimbal->DEBUG_GIMBAL) {
+				Serial.println(F("PCA9685 output differs, rewriting motor positions"));
+			}
+			writeMotors();
+			return;
+		}
+	}
 }
 
 /*! @brief send latest values to web page
-* @param client is the calling WiFi client
+* @param r the response to add our NAME=VALUE lines to
 * N.B. labels must match ids in web page
 */
-void Gimbal::sendNewValues(WiFiClient client)
+void Gimbal::sendNewValues(Response &r)
 {
 	if (!gimbal_found) {
-		client.println(F("G_Status=Not found!"));
+		r.add("G_Status", "Not found!");
 		return;
 	}
 
-	client.print(F("G_Mot1Pos="));
-	client.println(motor[0].pos);
-	client.print(F("G_Mot2Pos="));
-	client.println(motor[1].pos);
+#if GIMBAL_AZ_STEPPER
+	r.add("G_Mot1Pos", (int32_t)stepper->position());		//< steps from home
+#else
+	r.add("G_Mot1Pos", (int32_t)motor[0].pos);
+#endif
+	r.add("G_Mot2Pos", (int32_t)motor[1].pos);
+
+	r.add("G_Mot1Max", (int32_t)motor[0].max);
+	r.add("G_Mot1Min", (int32_t)motor[0].min);
 
-	client.print(F("G_Mot1Max="));
-	client.println(motor[0].max);
-	client.print(F("G_Mot1Min="));
-	client.println(motor[0].min);
+	r.add("G_Mot1AzCal", 1 / motor[0].az_scale, 2);
+	r.add("G_Mot1ElCal", 1 / motor[0].el_scale, 2);
 
-	client.print(F("G_Mot1AzCal="));
-	client.println(1 / motor[0].az_scale);
-	client.print(F("G_Mot1ElCal="));
-	client.println(1 / motor[0].el_scale);
+	r.add("G_Mot2Min", (int32_t)motor[1].min);
+	r.add("G_Mot2Max", (int32_t)motor[1].max);
 
-	client.print(F("G_Mot2Min="));
-	client.println(motor[1].min);
-	client.print(F("G_Mot2Max="));
-	client.println(motor[1].max);
+	r.add("G_Mot2AzCal", 1 / motor[1].az_scale, 2);
+	r.add("G_Mot2ElCal", 1 / motor[1].el_scale, 2);
 
-	client.print(F("G_Mot2AzCal="));
-	client.println(1 / motor[1].az_scale);
-	client.print(F("G_Mot2ElCal="));
-	client.println(1 / motor[1].el_scale);
+	//< standard error of each motor's az and el terms, percent; a stepper's are fixed by its steps
+	for (uint8_t i = 0; i < NMOTORS; i++) {
+		char _id[] = "G_MotNCalErr";
+		_id[5] = '1' + i;
+		if (i < FIRST_PWM) {
+			r.add(_id, "steps");
+		} else {
+			r.addf(_id, "%.1f / %.1f", 100 * cal.relErr(CalEstimator::AZ, i), 100 * cal.relErr(CalEstimator::EL, i));
+		}
+	}
+	r.addf("G_CalFit", "%u moves%s", (unsigned)cal.samples(), converged() ? ", converged" : "");
 	// HIGH means limit switch is applying 3v to OE input of PCA9685,
 	// which is read by PCA9685OEPin. OE is normally pulled down or 0v
 	//https://learn.adafruit.com/16-channel-pwm-servo-driver/pinouts
 	bool pca9685_is_disabled = digitalRead(PCA9685OEPin);
-	client.print(F("G_Status="));
 	if (pca9685_is_disabled) {
-		client.println(F("Gimbal fault!"));
+		r.add("G_Status", "Gimbal fault!");
+	}
+#if GIMBAL_AZ_STEPPER
+	else if (stepper->homing()) {
+		r.add("G_Status", "Homing stepper");
+	}
+#endif
+	else if (isCalibrating) {
+		r.addf("G_Status", "Calibrating %d/%d", init_step < N_INIT_STEPS ? init_step : N_INIT_STEPS, N_INIT_STEPS);
 	}
 	else if (motor[0].atmin) {
-		client.println(F("Servo 1 at Min!"));
+		r.add("G_Status", "Servo 1 at Min!");
 	}
 	else if (motor[0].atmax) {
-		client.println(F("Servo 1 at Max!"));
+		r.add("G_Status", "Servo 1 at Max!");
 	}
 	else if (motor[1].atmin) {
-		client.println(F("Servo 2 at Min!"));
+		r.add("G_Status", "Servo 2 at Min!");
 	}
 	else if (motor[1].atmax) {
-		client.println(F("Servo 2 at Max!"));
+		r.add("G_Status", "Servo 2 at Max!");
 	} else if (!calibrated()) {
-		client.println(F("Uncalibrated!"));
+		r.add("G_Status", "Uncalibrated!");
 	} else {
-		client.println(F("Ok+"));
+		r.add("G_Status", "Ok+");
+	}
+}
+
+/*! @brief fill in the Gimbal part of a status record
+*
+* @param s the record being built by buildStatus()
+*/
+void Gimbal::fillStatus(StatusRecord &s)
+{
+	s.target_az = az_loop.target;
+	s.target_el = el_loop.target;
+	for (uint8_t i = 0; i < NMOTORS; i++) {
+		s.pos[i] = motor[i].pos;
+		s.min[i] = motor[i].min;
+		s.max[i] = motor[i].max;
+		if (motor[i].atmin) {
+			s.limits |= ST_MOT1_ATMIN << (2*i);
+		}
+		if (motor[i].atmax) {
+			s.limits |= ST_MOT1_ATMAX << (2*i);
+		}
+	}
+	if (gimbal_found) {
+		s.flags |= ST_GIMBAL_FOUND;
+		if (digitalRead(PCA9685OEPin)) {
+			s.flags |= ST_GIMBAL_FAULT;
+		}
+	}
+	if (calibrated()) {
+		s.flags |= ST_GIMBAL_CALOK;
+	}
+	if (isCalibrating) {
+		s.flags |= ST_CALIBRATING;
+	}
+	if (closed_loop) {
+		s.flags |= ST_CLOSED_LOOP;
 	}
 }
 
@@ -512,7 +1259,11 @@ bool Gimbal::overrideValue(char *name, char *value)
 
 	if (!strcmp(name, "G_Mot1Pos")) {
 		if (gimbal_found) {
+#if GIMBAL_AZ_STEPPER
+			stepper->setTarget(atoi(value));			//< steps from home
+#else
 			setMotorPosition(0, atoi(value));
+#endif
 		} else {
 			webpage->setUserMessage(nog);
 		}
@@ -520,7 +1271,7 @@ bool Gimbal::overrideValue(char *name, char *value)
 	}
 	if (!strcmp(name, "G_Mot1Min")) {
 		if (gimbal_found) {
-			nv->mot0min = motor[0].min = atoi(value);
+			nv->mot0min = motor[0].min = limitPulse(atoi(value));
 			nv->put();
 			webpage->setUserMessage(F("Servo 1 minimum saved in EEPROM+"));
 		} else {
@@ -530,7 +1281,7 @@ bool Gimbal::overrideValue(char *name, char *value)
 	}
 	if (!strcmp(name, "G_Mot1Max")) {
 		if (gimbal_found) {
-			nv->mot0max = motor[0].max = atoi(value);
+			nv->mot0max = motor[0].max = limitPulse(atoi(value));
 			nv->put();
 			webpage->setUserMessage(F("Servo 1 maximum saved in EEPROM+"));
 		} else {
@@ -548,7 +1299,7 @@ bool Gimbal::overrideValue(char *name, char *value)
 	}
 	if (!strcmp(name, "G_Mot2Min")) {
 		if (gimbal_found) {
-			nv->mot1min = motor[1].min = atoi(value);
+			nv->mot1min = motor[1].min = limitPulse(atoi(value));
 			nv->put();
 			webpage->setUserMessage(F("Servo 2 minimum saved in EEPROM+"));
 		} else {
@@ -558,7 +1309,7 @@ bool Gimbal::overrideValue(char *name, char *value)
 	}
 	if (!strcmp(name, "G_Mot2Max")) {
 		if (gimbal_found) {
-			nv->mot1max = motor[1].max = atoi(value);
+			nv->mot1max = motor[1].max = limitPulse(atoi(value));
 			nv->put();
 			webpage->setUserMessage(F("Servo 2 maximum saved in EEPROM+"));
 		} else {
@@ -566,24 +1317,20 @@ bool Gimbal::overrideValue(char *name, char *value)
 		}
 		return (true);
 	}
+	if (!strcmp(name, "G_Loop")) {
+		setClosedLoop(!strcmp(value, "true") || !strcmp(value, "1"));
+		if (closed_loop) {
+			webpage->setUserMessage(F("Closed-loop tracking+"));
+		} else {
+			webpage->setUserMessage(F("Settle-then-step tracking+"));
+		}
+		return (true);
+	}
 	if (!strcmp(name, "G_Save")) {
 		if (gimbal_found) {
 			if (sensor->connected()) {
-				//< set init_step to 0 so we'll do calibration
-				resetInitStep();
-				//< have to do this for 4 steps, incrementing init_step each time
-				//< we can use 'delay()' since this is called by pressing a button
-				while (!calibrated()) {
-					last_update = 0; // override the update-period "UPD"
-					//< the values passed, "init_step * 5" are arbitrary
-					moveToAzEl(init_step * 5, init_step * 5);
-					delay(200);
-				}
-				delay(1000);
-				moveToAzEl(G_HOME_AZ, G_HOME_EL);
-				delay(1000);
-				moveToAzEl(G_HOME_AZ, G_HOME_EL);
-				webpage->setUserMessage(F("Gimbal calibrated+"));
+				//< serviceCalibration() takes it from here and reports when done
+				startCalibration();
 			} else {
 				webpage->setUserMessage(F("no Sensor!"));
 			}
@@ -36,22 +36,34 @@
 #include <Adafruit_PWMServoDriver.h>
 
 #include "Sensor.h"
+#include "Response.h"
+#include "Status.h"
+#include "Axis.h"
+#include "CalEstimator.h"
+#if GIMBAL_AZ_STEPPER
+#include "Stepper.h"
+#endif
+
+#define CLOSED_LOOP_TRACKING true	///< default tracking mode; can be changed thru Webpage (G_Loop)
 
 class Gimbal {
 
     private:
 	const bool DEBUG_GIMBAL = false;
 
-	// I2C servo interface
+	// I2C servo interface, as described for this build in Axis.h
+	// with GIMBAL_AZ_STEPPER motor 0 is the Stepper and only motor 1 is on the PCA9685
+	static_assert (Motor1::kind == (GIMBAL_AZ_STEPPER ? STEPPER : SERVO_PWM) && Motor2::kind == SERVO_PWM,
+			"Gimbal only drives SERVO_PWM motors, or a STEPPER motor 1 with GIMBAL_AZ_STEPPER");
+	static_assert (GIMBAL_AZ_STEPPER || Motor2::unit == Motor1::unit + 1, "writeMotors() needs the motors on adjacent channels");
+	typedef Motor2::actuator Servo;			// all PWM motors share the PCA9685's pulse frequency
+	static const uint8_t FIRST_PWM = GIMBAL_AZ_STEPPER ? 1 : 0;		// motor[] index of the first PWM motor
+	static const uint8_t PWM_BASE = GIMBAL_AZ_STEPPER ? Motor2::unit : Motor1::unit;	// its channel
 	Adafruit_PWMServoDriver *pwm;
-	static const uint8_t I2C_ADDR = 0x40;	// I2C bus address of servo controller
-	static const uint8_t SERVO_FREQ = 50;	// typical servo pulse frequency, Hz
-	static constexpr float US_PER_BIT = (1e6/SERVO_FREQ/4096);	// usec per bit @ 12 bit resolution
-	static const uint8_t MOT1_UNIT = 0;		// motor 1 I2C unit number
-	static const uint8_t MOT2_UNIT = 1;		// motor 2 I2C unit number
+	static const uint8_t I2C_ADDR = GIMBAL_PWM_ADDR;	// I2C bus address of servo controller
 	bool gimbal_found;						// whether PWM controller is present
-	static constexpr float G_HOME_AZ = 0.0;	// gimbal az home position for calibration
-	static constexpr float G_HOME_EL = 45.0; // gimbal el home position for calibration
+	static constexpr float G_HOME_AZ = GIMBAL_HOME_AZ;	// gimbal az home position for calibration
+	static constexpr float G_HOME_EL = GIMBAL_HOME_EL;	// gimbal el home position for calibration
 	// motor info
 	typedef struct {
 	    float az_scale, el_scale;			// az and el scale: steps (del usec) per degree
@@ -61,7 +73,7 @@ class Gimbal {
 	    bool atmin, atmax;					// (would have been commanded to) limit
 	    uint8_t servo_num;					// I2C bus address 0..15
 	} MotorInfo;
-	static const uint8_t NMOTORS = 2;		// not easily changed
+	static const uint8_t NMOTORS = 2;		// one per axis; calibration finds which moves which
 	MotorInfo motor[NMOTORS];
 
 	// search info
@@ -73,28 +85,129 @@ class Gimbal {
 												// N.B.: max physical motion must be < 180/CAL_FRAC
 	uint8_t init_step;							// initialization sequencing
 	uint8_t best_azmotor;						// after cal, motor[] index with most effect in az
+	uint8_t best_elmotor;						// and the other one, for el
 	uint32_t last_update;						// millis() time of last moveToAzEl
+	static const uint16_t CAL_SETTLE_PERIOD = 200;	// ms between settle checks while calibrating
+	static const uint16_t CAL_MOVE_WAIT = 500;		// ms to let a calibration move get going
+	static const uint16_t CAL_MOTOR_GAP = 100;		// ms between starting the two motors
+	static const uint16_t CAL_HOME_WAIT = 1000;		// ms before each move home after calibrating
+	static const uint32_t CAL_TIMEOUT = 180000;		// ms a whole calibration may take before it is abandoned
+	static const uint8_t N_HOME_MOVES = 2;			// settle-then-step moves home after calibrating
+	enum { CAL_IDLE, CAL_STEP, CAL_HOME } cal_phase;	// calibration state machine
+	uint32_t cal_start;							// millis() when the calibration started
+	uint32_t cal_wait;							// calibration does nothing until this millis() time
+	uint8_t defer_motor;						// motor to start at cal_wait, NMOTORS if none
+	uint16_t defer_pos;							// position for defer_motor
+	uint8_t home_moves;							// moves made in CAL_HOME
 	float prevfast_az, prevfast_el;				// previous pointing position
 	float prevstop_az, prevstop_el;				// previous stopped position for calibration
+
+	// closed-loop tracking info
+	// every track() tick each axis is driven by a PI loop instead of waiting for the gimbal to settle
+	static constexpr float TRACK_KP = 0.3;		// proportional gain, fraction of error per tick
+	static constexpr float TRACK_KI = 2.0;		// integral gain, 1/s
+	static const uint16_t TRACK_MAX_SLEW = 40;	// most a motor may move per tick, usec
+	static const uint16_t TRACK_STALE = 250;	// ms without a tick before controller state is reset
+	typedef struct {
+	    float integ;							// integrator, accumulated command, usec
+	    float target;							// target angle, degrees
+	} AxisLoop;
+	AxisLoop az_loop, el_loop;
+	bool closed_loop;							// true to track() continuously, false to settle-then-step
+	bool have_target;							// moveToAzEl() has given track() something to follow
+	uint32_t last_track;						// millis() time of last track() tick
+
+	// mount model: where the motor positions point, so the sensor can be read past the zenith
+	// N.B. the gimbal must start the right way up; the model is only learned while el is clearly below 90
+	static constexpr float ZERO_GAIN = 0.02;	// fraction of the sensor's disagreement taken per tick
+	static constexpr float EL_SURE = 75;		// degrees el below which the mount is surely not over the top
+	float az_zero, el_zero;						// mount az and el with the motors at 0 usec, degrees
+	bool have_zero;								// az_zero and el_zero have been set from the sensor
+	// pass plan, from Tracker: the whole pass is tracked from one wrap, over the top if flip
+	bool plan_active;							// track() follows the plan rather than the shortest way
+	bool plan_flip;								// targets map to az + 180, 180 - el
+	float plan_az;								// latest mount az target, unwrapped from the plan's start
+
+	// online calibration: every move the motors make refines how they move az and el
+	// N.B. only the PWM motors' columns are learned; a stepper's is fixed by its steps
+	CalEstimator cal;
+	static const uint16_t LEARN_PERIOD = 1000;	// ms between track() samples
+	static const uint16_t LEARN_MAX_WAIT = 10000;	// ms a sample waits for LEARN_MIN_MOVE before starting over
+	static constexpr float LEARN_MIN_MOVE = 10;	// usec of motor motion, both together, worth a sample
+	static constexpr float LEARN_MAX_ERR = 1;	// degrees of tracking error, either axis, beyond which track() takes no samples
+	static constexpr float NV_P0 = 1e-5;		// confidence in a calibration read from NV, 1/usec^2, about its moves'
+	static constexpr float CAL_CONVERGED = 0.02;	// every learned term's CalEstimator::relErr() below this
+	static const uint16_t CAL_MIN_SAMPLES = 30;	// and this many samples, before the estimate is used
+	static constexpr float CAL_SAVE_CHANGE = 0.01;	// fractional change in a term since the last save worth saving
+	static const uint32_t CAL_SAVE_PERIOD = 600000;	// ms, least time between saves
+	float learn_pos[NMOTORS];					// motor positions at the start of the sample, usec or steps
+	float learn_az, learn_el;					// mount az and el then, degrees
+	uint32_t learn_t;							// millis() then
+	bool learn_ok;								// a sample has been started
+	float saved_gain[2][NMOTORS];				// the estimate's terms as last saved, degrees per usec
+	uint32_t last_save;							// millis() of that
+
+	// between passes the PCA9685 oscillator sleeps: no pulses, so the servos go limp and draw next to nothing
+	// N.B. OE belongs to the limit switch, PCA9685OEPin only watches it
+	static const uint16_t WAKE_US = 500;		// usec for the oscillator to start again
+	bool resting;								// rest() has stopped the outputs
+	uint32_t last_motion;						// millis() of the latest change of target
+
+#if GIMBAL_AZ_STEPPER
+	// stepper az: motor[0].az_scale is steps per degree, signed, and the step count maps to az thru az_offset
+	static constexpr float CAL_AZ_DEG = 90;		// stepper calibration move, shaft degrees; must turn az < 180
+	static constexpr float OFFSET_GAIN = 0.05;	// fraction of the sensor's disagreement taken into az_offset per tick
+	static constexpr float OFFSET_SPEED = 2;	// degrees per second below which the sensor is believed, it lags
+	float az_offset;							// az at stepper position 0, degrees
+	bool have_offset;							// az_offset has been set from the sensor
+	void stepAz (float az_s, float az_t);
+#endif
 	
 	void setMotorPosition (uint8_t motn, uint16_t newpos);
+	void setMotorPositions (const uint16_t newpos[NMOTORS]);
+	void stagePosition (uint8_t motn, uint16_t newpos);
+	void writeMotors ();
+	bool sleepOutputs (bool sleep);
+	void assignAxes (uint8_t az_motor);
+	static uint16_t limitPulse (int us);
 	void calibrate (float &az_s, float &el_s);
+	void startCalibration ();
 	void seekTarget (float& az_t, float& el_t, float& az_s, float& el_s);
-	float azDist (float &from, float &to);
-	void reCal(float& az_s, float& el_s);
+	void learn(float az_m, float el_m, float el_s);
+	bool converged();
+	void useEstimate();
+	void scalesFromEstimate();
+	void toMount(float &az_s, float &el_s);
+	static float wrapNear(float ref, float az);
 	void installCalibration();
 	void saveCalibration();
-	uint16_t readPWM(uint8_t ledNum, bool on);
+	void resetLoop(AxisLoop &loop, MotorInfo *mip);
+	uint16_t stepLoop(AxisLoop &loop, MotorInfo *mip, float err, float scale, float dt);
 
     public:
 	boolean isCalibrating;
 	Gimbal();
 	void resetInitStep();
 	void moveToAzEl (float az_t, float el_t);
-	void sendNewValues (WiFiClient client);
+	void track ();
+	void serviceCalibration ();
+	void checkOutputs ();
+	void setClosedLoop (bool on);
+	bool isClosedLoop() { return (closed_loop); }
+	static float azDist (float &from, float &to);
+	void sendNewValues (Response &r);
+	void fillStatus (StatusRecord &s);
 	bool overrideValue (char *name, char *value);
 	bool connected() { return (gimbal_found); };
 	bool calibrated() { return (init_step >= N_INIT_STEPS); }
+	bool reach (float &az_lo, float &az_hi, float &el_lo, float &el_hi);
+	void setPlan (bool flip, float az_start);
+	void endPlan ();
+	void rest ();
+	void wake ();
+	bool isResting() { return (resting); };
+	bool busy ();
+	uint32_t lastMotion() { return (last_motion); };
 };
 
 extern Gimbal *gimbal;
@@ -0,0 +1,143 @@
+/*!
+* @brief Class that owns the I2C ports shared by the BNO055 Sensor and the PCA9685 Gimbal controller
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "I2CBus.h"
+#include "Metrics.h"
+
+/*! @brief class constructor; starts port 0, and port 1 if I2C_SPLIT_PORTS
+*
+* Must run before the Sensor and Gimbal constructors, they talk to their devices.
+*/
+I2CBus::I2CBus()
+{
+	ports[0].wire = &Wire;
+	ports[0].sda = I2C_SDA;
+	ports[0].scl = I2C_SCL;
+	ports[0].clock = I2C_CLOCK;
+	ports[1].wire = &Wire1;
+	ports[1].sda = I2C1_SDA;
+	ports[1].scl = I2C1_SCL;
+	ports[1].clock = I2C1_CLOCK;
+
+	port_of[I2C_SENSOR] = 0;
+	port_of[I2C_PWM] = I2C_SPLIT_PORTS ? 1 : 0;
+
+	for (uint8_t i = 0; i < N_PORTS; i++) {
+	    ports[i].failures = 0;
+	    ports[i].lock = NULL;
+	}
+	for (uint8_t d = 0; d < I2C_N_DEVICES; d++) {
+	    Port &_p = ports[port_of[d]];
+	    if (_p.lock == NULL) {
+		    _p.lock = xSemaphoreCreateMutex();
+		    beginPort (_p);
+	    }
+	}
+}
+
+/*! @brief attach a port to its pins at its clock
+*
+* N.B. the Adafruit drivers call begin() again with no arguments, which keeps these pins and clock
+*/
+void I2CBus::beginPort (Port &p)
+{
+	p.wire->begin (p.sda, p.scl, p.clock);
+	p.wire->setClock (p.clock);
+	p.wire->setTimeOut (I2C_TIMEOUT);
+}
+
+/*! @brief claim the port a device is on
+*
+* Hold this around any Wire traffic or driver call for that device; it may be running from
+* loop(), sensorTask or a web request.
+* @param device I2C_ device number
+*/
+void I2CBus::lock (uint8_t device)
+{
+	xSemaphoreTake (ports[port_of[device]].lock, portMAX_DELAY);
+}
+
+/*! @brief release the port claimed by lock()
+*
+* @param device I2C_ device number
+*/
+void I2CBus::unlock (uint8_t device)
+{
+	xSemaphoreGive (ports[port_of[device]].lock);
+}
+
+/*! @brief account for one transaction, clearing the bus after RECOVER_AFTER failures in a row
+*
+* Call with the port still locked.
+* @param device I2C_ device number
+* @param ok whether the transaction was acknowledged and complete
+* @return ok
+*/
+bool I2CBus::report (uint8_t device, bool ok)
+{
+	Port &_p = ports[port_of[device]];
+	if (ok) {
+	    _p.failures = 0;
+	    return (true);
+	}
+	metrics->count(C_I2C_ERROR);
+	if (++_p.failures >= RECOVER_AFTER) {
+	    recover (device);
+	}
+	return (false);
+}
+
+/*! @brief free a bus held by a slave that was interrupted mid-byte, then restart the port
+*
+* A slave that lost a clock edge keeps driving SDA low waiting for it. Clock SCL by hand
+* until it lets go, send a STOP, and hand the pins back to the controller.
+* Call with the port locked, or before anything else uses it.
+* @param device I2C_ device number
+* @return true if both lines are high afterwards
+*/
+bool I2CBus::recover (uint8_t device)
+{
+	Port &_p = ports[port_of[device]];
+	pinMode (_p.sda, OPEN_DRAIN | PULLUP | INPUT | OUTPUT);
+	pinMode (_p.scl, OPEN_DRAIN | PULLUP | INPUT | OUTPUT);
+	digitalWrite (_p.sda, HIGH);
+	digitalWrite (_p.scl, HIGH);
+	delayMicroseconds (HALF_PERIOD);
+	for (uint8_t i = 0; i < CLEAR_PULSES && digitalRead (_p.sda) == LOW; i++) {
+	    digitalWrite (_p.scl, LOW);
+	    delayMicroseconds (HALF_PERIOD);
+	    digitalWrite (_p.scl, HIGH);
+	    delayMicroseconds (HALF_PERIOD);
+	}
+	//< STOP: SDA rises while SCL is high
+	digitalWrite (_p.scl, LOW);
+	delayMicroseconds (HALF_PERIOD);
+	digitalWrite (_p.sda, LOW);
+	delayMicroseconds (HALF_PERIOD);
+	digitalWrite (_p.scl, HIGH);
+	delayMicroseconds (HALF_PERIOD);
+	digitalWrite (_p.sda, HIGH);
+	delayMicroseconds (HALF_PERIOD);
+	bool _free = digitalRead (_p.sda) == HIGH && digitalRead (_p.scl) == HIGH;
+
+	beginPort (_p);
+	_p.failures = 0;
+	metrics->count(C_I2C_RECOVERY);
+	return (_free);
+}
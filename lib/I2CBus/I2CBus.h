@@ -0,0 +1,76 @@
+/*!
+* @brief Class that owns the I2C ports shared by the BNO055 Sensor and the PCA9685 Gimbal controller
+*
+* Sets the clock and transaction timeout, serializes each port between tasks and clears a
+* stuck bus by clocking SCL, so an I2C fault never needs a reboot. Optionally moves the
+* PCA9685 to the second hardware port so PWM writes never wait behind a Sensor read.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _I2CBUS_H
+#define _I2CBUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define I2C_SDA          SDA    ///<  port 0 pins, the board variant's Wire pins: 23 and 22 on the featheresp32
+#define I2C_SCL          SCL    ///<  N.B. not 21, that is PCA9685OEPin, the limit switch's OE sense line
+#define I2C_CLOCK        400000 ///<  Hz on port 0; the BNO055 is rated to 400 kHz
+#define I2C_SPLIT_PORTS  false  ///<  true moves the PCA9685 to port 1 on I2C1_SDA and I2C1_SCL
+#define I2C1_SDA         25
+#define I2C1_SCL         26
+#define I2C1_CLOCK       1000000    ///<  Hz on port 1; the PCA9685 is rated to 1 MHz (Fm+)
+#define I2C_TIMEOUT      10     ///<  milliseconds before a transaction, including clock stretching, fails
+
+//< the devices, each assigned to a port
+enum {
+    I2C_SENSOR,							// BNO055, always port 0
+    I2C_PWM,							// PCA9685, port 1 if I2C_SPLIT_PORTS
+    I2C_N_DEVICES
+};
+
+class I2CBus {
+
+    public:
+	I2CBus();
+	TwoWire &wire (uint8_t device) { return (*ports[port_of[device]].wire); };
+	void lock (uint8_t device);
+	void unlock (uint8_t device);
+	bool report (uint8_t device, bool ok);
+	bool recover (uint8_t device);
+
+    private:
+	//< one hardware I2C controller and the lines it drives
+	typedef struct {
+	    TwoWire *wire;
+	    uint8_t sda, scl;
+	    uint32_t clock;					// Hz
+	    SemaphoreHandle_t lock;			// held for a whole transaction, or a whole driver call
+	    uint8_t failures;				// consecutive failed transactions
+	} Port;
+	static const uint8_t N_PORTS = 2;
+	static const uint8_t RECOVER_AFTER = 3;		// consecutive failures before clearing the bus
+	static const uint8_t CLEAR_PULSES = 9;		// enough for a slave to finish any byte it is sending
+	static const uint8_t HALF_PERIOD = 5;		// usec, 100 kHz while clearing
+	Port ports[N_PORTS];
+	uint8_t port_of[I2C_N_DEVICES];
+	void beginPort (Port &p);
+};
+
+extern I2CBus *i2cbus;
+
+#endif // _I2CBUS_H
@@ -0,0 +1,242 @@
+/*!
+* @brief Class to time the hot paths and count the rare events, for /metrics and the MT command
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Metrics.h"
+#include "Scheduler.h"
+
+static const char *site_names[M_N_SITES] = {
+	"sensor_read", "motor_set", "track", "easycomm", "serial_rx", "web", "nv_commit",
+};
+static const char *counter_names[M_N_COUNTERS] = {
+	"i2c_error", "i2c_recovery", "pwm_mismatch", "sensor_restart", "ec_commands", "ec_dropped", "serial_overflow",
+	"stepper_no_home", "cal_rejected", "idle_entered",
+};
+
+/*! @brief class constructor
+ */
+Metrics::Metrics()
+{
+	mux = portMUX_INITIALIZER_UNLOCKED;
+	memset (sites, 0, sizeof(sites));
+	for (uint8_t i = 0; i < M_N_SITES; i++) {
+	    sites[i].min_us = UINT32_MAX;
+	}
+	memset (totals, 0, sizeof(totals));
+	memset (window, 0, sizeof(window));
+	memset (rates, 0, sizeof(rates));
+	window_start = millis();
+}
+
+/*! @brief add one timing to a site
+*
+* @param site M_ site number
+* @param start_cycles what start() returned at the beginning of the timed code.
+* N.B. start and stop must run on the same core, each has its own cycle counter
+*/
+void Metrics::stop (uint8_t site, uint32_t start_cycles)
+{
+	uint32_t _us = (ESP.getCycleCount() - start_cycles) / ESP.getCpuFreqMHz();
+	uint8_t _b = _us ? 31 - __builtin_clz (_us) : 0;
+	if (_b >= N_BUCKETS) {
+	    _b = N_BUCKETS - 1;
+	}
+	Site &_s = sites[site];
+	portENTER_CRITICAL (&mux);
+	_s.count++;
+	_s.sum_us += _us;
+	if (_us < _s.min_us) {
+	    _s.min_us = _us;
+	}
+	if (_us > _s.max_us) {
+	    _s.max_us = _us;
+	}
+	_s.buckets[_b]++;
+	portEXIT_CRITICAL (&mux);
+}
+
+/*! @brief count an event
+*
+* @param counter C_ counter number
+* @param n how many happened
+*/
+void Metrics::count (uint8_t counter, uint32_t n)
+{
+	uint32_t _now = millis();
+	portENTER_CRITICAL (&mux);
+	roll (_now);
+	totals[counter] += n;
+	window[counter] += n;
+	portEXIT_CRITICAL (&mux);
+}
+
+/*! @brief start a new rate window if the current one is over
+*
+* A window with nothing counted for a whole extra RATE_WINDOW reads as 0 per second.
+* N.B. caller must hold mux
+*/
+void Metrics::roll (uint32_t now)
+{
+	uint32_t _age = now - window_start;
+	if (_age < RATE_WINDOW) {
+	    return;
+	}
+	for (uint8_t i = 0; i < M_N_COUNTERS; i++) {
+	    rates[i] = _age < 2 * RATE_WINDOW ? window[i] : 0;
+	    window[i] = 0;
+	}
+	window_start = now;
+}
+
+/*! @brief copy out one site consistently
+*/
+void Metrics::site (uint8_t i, Site &s)
+{
+	portENTER_CRITICAL (&mux);
+	s = sites[i];
+	portEXIT_CRITICAL (&mux);
+}
+
+/*! @brief read one counter
+*
+* @param i C_ counter number
+* @param total receives the count since boot
+* @param per_sec receives the count over the last whole second
+*/
+void Metrics::counter (uint8_t i, uint32_t *total, uint32_t *per_sec)
+{
+	uint32_t _now = millis();
+	portENTER_CRITICAL (&mux);
+	roll (_now);
+	*total = totals[i];
+	*per_sec = rates[i];
+	portEXIT_CRITICAL (&mux);
+}
+
+/*! @brief 99th percentile estimate: the top of the bucket holding it, but never above max
+*/
+uint32_t Metrics::p99 (const Site &s)
+{
+	if (s.count == 0) {
+	    return (0);
+	}
+	uint32_t _want = s.count - s.count / 100;
+	uint32_t _sum = 0;
+	for (uint8_t i = 0; i < N_BUCKETS - 1; i++) {
+	    _sum += s.buckets[i];
+	    if (_sum >= _want) {
+		    return (min ((uint32_t)2 << i, s.max_us));
+	    }
+	}
+	return (s.max_us);
+}
+
+const char *Metrics::siteName (uint8_t i)
+{
+	return (site_names[i]);
+}
+
+const char *Metrics::counterName (uint8_t i)
+{
+	return (counter_names[i]);
+}
+
+/*! @brief print one part of the metrics in Prometheus text format
+*
+* Each part fits a FRAME_SIZE Response; print part 0, 1, ... until this returns false.
+* Parts keep each metric family together: uptime and events, per-site extremes,
+* Scheduler job stats, then one latency histogram per site.
+* @param p where to print, typically a Response
+* @param part which part
+* @return false if there is no such part
+*/
+bool Metrics::print (Print &p, uint8_t part)
+{
+	if (part == 0) {
+	    p.print (F("# TYPE rotator_uptime_seconds gauge\n"));
+	    p.printf ("rotator_uptime_seconds %lu\n", (unsigned long)(millis() / 1000));
+	    p.print (F("# TYPE rotator_free_heap_bytes gauge\n"));
+	    p.printf ("rotator_free_heap_bytes %lu\n", (unsigned long)ESP.getFreeHeap());
+	    uint32_t _total[M_N_COUNTERS], _rate[M_N_COUNTERS];
+	    for (uint8_t i = 0; i < M_N_COUNTERS; i++) {
+		    counter (i, &_total[i], &_rate[i]);
+	    }
+	    p.print (F("# TYPE rotator_events_total counter\n"));
+	    for (uint8_t i = 0; i < M_N_COUNTERS; i++) {
+		    p.printf ("rotator_events_total{event=\"%s\"} %lu\n", counter_names[i], (unsigned long)_total[i]);
+	    }
+	    p.print (F("# TYPE rotator_events_per_second gauge\n"));
+	    for (uint8_t i = 0; i < M_N_COUNTERS; i++) {
+		    p.printf ("rotator_events_per_second{event=\"%s\"} %lu\n", counter_names[i], (unsigned long)_rate[i]);
+	    }
+	} else if (part == 1) {
+	    Site _s[M_N_SITES];
+	    for (uint8_t i = 0; i < M_N_SITES; i++) {
+		    site (i, _s[i]);
+	    }
+	    p.print (F("# TYPE rotator_latency_min_us gauge\n"));
+	    for (uint8_t i = 0; i < M_N_SITES; i++) {
+		    p.printf ("rotator_latency_min_us{site=\"%s\"} %lu\n", site_names[i],
+				    (unsigned long)(_s[i].count ? _s[i].min_us : 0));
+	    }
+	    p.print (F("# TYPE rotator_latency_p99_us gauge\n"));
+	    for (uint8_t i = 0; i < M_N_SITES; i++) {
+		    p.printf ("rotator_latency_p99_us{site=\"%s\"} %lu\n", site_names[i], (unsigned long)p99 (_s[i]));
+	    }
+	    p.print (F("# TYPE rotator_latency_max_us gauge\n"));
+	    for (uint8_t i = 0; i < M_N_SITES; i++) {
+		    p.printf ("rotator_latency_max_us{site=\"%s\"} %lu\n", site_names[i], (unsigned long)_s[i].max_us);
+	    }
+	} else if (part == 2) {
+	    //< whole jobs, as the Scheduler already times them
+	    const char *_name;
+	    uint32_t _runs, _overruns, _run_us, _max_us;
+	    p.print (F("# TYPE rotator_job_runs_total counter\n"));
+	    for (uint8_t i = 0; scheduler->stats (i, &_name, &_runs, &_overruns, &_run_us, &_max_us); i++) {
+		    p.printf ("rotator_job_runs_total{job=\"%s\"} %lu\n", _name, (unsigned long)_runs);
+	    }
+	    p.print (F("# TYPE rotator_job_overruns_total counter\n"));
+	    for (uint8_t i = 0; scheduler->stats (i, &_name, &_runs, &_overruns, &_run_us, &_max_us); i++) {
+		    p.printf ("rotator_job_overruns_total{job=\"%s\"} %lu\n", _name, (unsigned long)_overruns);
+	    }
+	    p.print (F("# TYPE rotator_job_max_us gauge\n"));
+	    for (uint8_t i = 0; scheduler->stats (i, &_name, &_runs, &_overruns, &_run_us, &_max_us); i++) {
+		    p.printf ("rotator_job_max_us{job=\"%s\"} %lu\n", _name, (unsigned long)_max_us);
+	    }
+	} else if (part < 3 + M_N_SITES) {
+	    uint8_t _i = part - 3;
+	    Site _s;
+	    site (_i, _s);
+	    if (_i == 0) {
+		    p.print (F("# TYPE rotator_latency_us histogram\n"));
+	    }
+	    uint32_t _sum = 0;
+	    for (uint8_t b = 0; b < N_BUCKETS - 1; b++) {
+		    _sum += _s.buckets[b];
+		    p.printf ("rotator_latency_us_bucket{site=\"%s\",le=\"%lu\"} %lu\n", site_names[_i],
+				    (unsigned long)2 << b, (unsigned long)_sum);
+	    }
+	    p.printf ("rotator_latency_us_bucket{site=\"%s\",le=\"+Inf\"} %lu\n", site_names[_i],
+			    (unsigned long)_s.count);
+	    p.printf ("rotator_latency_us_sum{site=\"%s\"} %llu\n", site_names[_i], (unsigned long long)_s.sum_us);
+	    p.printf ("rotator_latency_us_count{site=\"%s\"} %lu\n", site_names[_i], (unsigned long)_s.count);
+	} else {
+	    return (false);
+	}
+	return (true);
+}
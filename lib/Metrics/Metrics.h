@@ -0,0 +1,92 @@
+/*!
+* @brief Class to time the hot paths and count the rare events, for /metrics and the MT command
+*
+* Timing uses the CPU cycle counter so a sample costs a few instructions; each timed site keeps
+* a log2 histogram of microseconds. Safe to use from any task.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _METRICS_H
+#define _METRICS_H
+
+#include <Arduino.h>
+
+//< timed sites
+enum {
+    M_SENSOR_READ,						// Sensor::readAzElT() I2C transfer
+    M_MOTOR_SET,						// Gimbal::writeMotors() I2C burst
+    M_TRACK,							// trackJob()
+    M_EASYCOMM,							// Easycomm::easycomm_process()
+    M_SERIAL_RX,						// Easycomm::receiveAll(), one burst
+    M_WEB,								// Webpage::checkEthernet()
+    M_NV_COMMIT,						// NV::commit() flash write
+    M_N_SITES
+};
+
+//< counted events
+enum {
+    C_I2C_ERROR,						// NACK, timeout or short read on either device
+    C_I2C_RECOVERY,						// I2CBus::recover() clocked a stuck bus free
+    C_PWM_MISMATCH,						// PCA9685 readback differed, position rewritten
+    C_SENSOR_RESTART,					// BNO055 begin() after an error
+    C_EC_COMMANDS,						// Easycomm command lines
+    C_EC_DROPPED,						// Easycomm commands lost to a full queue
+    C_SERIAL_OVERFLOW,					// serial bytes discarded from over-long lines
+    C_STEPPER_NO_HOME,					// Stepper homing turned a full circle without finding the switch
+    C_CAL_REJECT,						// calibration samples the estimator did not believe
+    C_IDLE,								// Power went idle between passes
+    M_N_COUNTERS
+};
+
+class Metrics {
+
+    public:
+	static const uint8_t N_BUCKETS = 16;	// bucket i counts [2^i, 2^(i+1)) usec, the last is open
+
+	//< one timed site
+	typedef struct {
+	    uint32_t count;
+	    uint64_t sum_us;
+	    uint32_t min_us, max_us;
+	    uint32_t buckets[N_BUCKETS];
+	} Site;
+
+	Metrics();
+	static uint32_t start() { return (ESP.getCycleCount()); };
+	void stop (uint8_t site, uint32_t start_cycles);
+	void count (uint8_t counter, uint32_t n = 1);
+	void site (uint8_t i, Site &s);
+	void counter (uint8_t i, uint32_t *total, uint32_t *per_sec);
+	static uint32_t p99 (const Site &s);
+	static const char *siteName (uint8_t i);
+	static const char *counterName (uint8_t i);
+	bool print (Print &p, uint8_t part);
+
+    private:
+	static const uint16_t RATE_WINDOW = 1000;	// ms over which per_sec is counted
+	portMUX_TYPE mux;
+	Site sites[M_N_SITES];
+	uint32_t totals[M_N_COUNTERS];
+	uint32_t window[M_N_COUNTERS];		//< counts in the current RATE_WINDOW
+	uint32_t rates[M_N_COUNTERS];		//< counts in the previous RATE_WINDOW
+	uint32_t window_start;
+	void roll (uint32_t now);
+};
+
+extern Metrics *metrics;
+
+#endif // _METRICS_H
@@ -0,0 +1,242 @@
+/*!
+* @brief Class to organize variables stored in flash.
+*
+* @section license License
+*
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <Preferences.h>
+#include <EEPROM.h>
+#include "NV.h"
+#include "Metrics.h"
+
+//< one journal slot as stored: this, then the image, then the CRC-32 of both
+typedef struct {
+    uint16_t schema;					// NV::SCHEMA when written
+    uint16_t seq;						// commit count, the newer of the two slots wins
+    uint16_t len;						// image bytes that follow
+} SlotHeader;
+
+//< how NV was kept in EEPROM before, schema 1; imported once if there is no journal yet
+typedef struct {
+    uint32_t magic;
+    uint16_t mot0min, mot0max;
+    uint16_t mot1min, mot1max;
+    float_t mag_decl;
+    float_t m0_azscale, m0_elscale;
+    float_t m1_azscale, m1_elscale;
+    uint8_t best_az_motor;
+    uint8_t init_step;
+    uint16_t ss_version;
+    uint8_t ss_offsets[NV::SS_OFFSETS_LEN];
+} LegacyNV;
+static const uint32_t LEGACY_MAGIC = 0x5a5aa5a5;
+
+static const char PREFS_NAME[] = "nv";				//< Preferences namespace
+static const char *SLOT_KEY[2] = { "slot0", "slot1" };
+//< bytes, imageSize(): both end at wifi_pass, so a field appended to the image moves both ends
+static const uint16_t MAX_IMAGE = offsetof(NV, wifi_pass) + NV::WIFI_PASS_LEN - offsetof(NV, mot0min);
+
+static Preferences prefs;
+static uint8_t committed[MAX_IMAGE];	//< the image as last read from or written to flash
+static uint16_t committed_seq;			//< seq of that image
+static bool loaded;						//< RAM holds the image, get() has nothing to do
+static bool dirty;						//< put() since the last commit changed the image
+static uint32_t first_put, last_put;	//< millis() of the first and latest such put()
+
+/*! @brief CRC-32 (IEEE), bitwise; NV images are small and rarely checked
+* @param crc 0, or the result so far
+* @param p bytes to add
+* @param n number of bytes
+*/
+static uint32_t crc32 (uint32_t crc, const uint8_t *p, size_t n)
+{
+	crc = ~crc;
+	while (n--) {
+	    crc ^= *p++;
+	    for (uint8_t b = 0; b < 8; b++) {
+		    crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+	    }
+	}
+	return (~crc);
+}
+
+/*! @brief class constructor
+ */
+NV::NV()
+{
+	memset (image(), 0, imageSize());	//< padding too, so images compare byte for byte
+	loaded = false;
+	dirty = false;
+	committed_seq = 0;
+	prefs.begin (PREFS_NAME, false);
+}
+
+/*! @brief fill the variables from flash, the first time only; after that RAM is the master copy
+*
+* If nothing valid was ever stored, all variables are set to 0 and stored.
+*/
+void NV::get()
+{
+	if (loaded) {
+	    return;
+	}
+	loaded = true;
+	if (!load() && !migrate()) {
+	    memset (image(), 0, imageSize());
+	    commit();
+	}
+}
+
+/*! @brief note the variables have changed; service() writes them to flash shortly
+*/
+void NV::put()
+{
+	uint32_t _now = millis();
+	if (memcmp (image(), committed, imageSize()) == 0) {
+	    dirty = false;					//< same as flash, perhaps changed back again
+	    return;
+	}
+	if (!dirty) {
+	    dirty = true;
+	    first_put = _now;
+	}
+	last_put = _now;
+}
+
+/*! @brief commit once a burst of put()s has been quiet for COMMIT_DELAY, or MAX_DEFER at most
+*
+* Call periodically from loop().
+*/
+void NV::service()
+{
+	uint32_t _now = millis();
+	if (dirty && (_now - last_put >= COMMIT_DELAY || _now - first_put >= MAX_DEFER)) {
+	    commit();
+	}
+}
+
+/*! @brief commit now if anything is waiting; call before a reboot
+*/
+void NV::flush()
+{
+	if (dirty) {
+	    commit();
+	}
+}
+
+/*! @brief whether a put() is still waiting to be committed
+*/
+bool NV::pending()
+{
+	return (dirty);
+}
+
+/*! @brief read the newer of the two journal slots that has a good CRC and our schema, or an older one
+*
+* Variables are only ever appended, so an older image is the start of ours; the ones it lacks are 0.
+* @return true if either slot was valid
+*/
+bool NV::load()
+{
+	uint8_t _buf[sizeof(SlotHeader) + MAX_IMAGE + sizeof(uint32_t)];
+	bool _found = false;
+	for (uint8_t i = 0; i < 2; i++) {
+	    SlotHeader _h;
+	    size_t _len = prefs.getBytes (SLOT_KEY[i], _buf, sizeof(_buf));
+	    if (_len < sizeof(_h) + sizeof(uint32_t)) {
+		    continue;
+	    }
+	    memcpy (&_h, _buf, sizeof(_h));
+	    uint32_t _crc;
+	    memcpy (&_crc, _buf + _len - sizeof(_crc), sizeof(_crc));
+	    if (_h.schema > SCHEMA || _h.len > imageSize() || _len != sizeof(_h) + _h.len + sizeof(_crc)
+			    || _crc != crc32 (0, _buf, _len - sizeof(_crc))) {
+		    continue;
+	    }
+	    if (!_found || (int16_t)(_h.seq - committed_seq) > 0) {
+		    memset (committed, 0, imageSize());
+		    memcpy (committed, _buf + sizeof(_h), _h.len);
+		    committed_seq = _h.seq;
+		    _found = true;
+	    }
+	}
+	if (_found) {
+	    memcpy (image(), committed, imageSize());
+	}
+	return (_found);
+}
+
+/*! @brief import the variables an older firmware left in EEPROM, and commit them to the journal
+*
+* @return true if there was something to import
+*/
+bool NV::migrate()
+{
+	LegacyNV _l;
+	EEPROM.begin (sizeof(_l));
+	EEPROM.get (0, _l);
+	if (_l.magic != LEGACY_MAGIC) {
+	    return (false);
+	}
+	mot0min = _l.mot0min;
+	mot0max = _l.mot0max;
+	mot1min = _l.mot1min;
+	mot1max = _l.mot1max;
+	mag_decl = _l.mag_decl;
+	m0_azscale = _l.m0_azscale;
+	m0_elscale = _l.m0_elscale;
+	m1_azscale = _l.m1_azscale;
+	m1_elscale = _l.m1_elscale;
+	best_az_motor = _l.best_az_motor;
+	init_step = _l.init_step;
+	ss_version = _l.ss_version;
+	memcpy (ss_offsets, _l.ss_offsets, sizeof(ss_offsets));
+	commit();
+	return (true);
+}
+
+/*! @brief write the image over the older slot
+*
+* On failure the image is left dirty, so service() tries again.
+*/
+void NV::commit()
+{
+	uint8_t _buf[sizeof(SlotHeader) + MAX_IMAGE + sizeof(uint32_t)];
+	SlotHeader _h;
+	_h.schema = SCHEMA;
+	_h.seq = committed_seq + 1;
+	_h.len = imageSize();
+	memcpy (_buf, &_h, sizeof(_h));
+	memcpy (_buf + sizeof(_h), image(), _h.len);
+	size_t _len = sizeof(_h) + _h.len;
+	uint32_t _crc = crc32 (0, _buf, _len);
+	memcpy (_buf + _len, &_crc, sizeof(_crc));
+	_len += sizeof(_crc);
+
+	uint32_t _t0 = Metrics::start();
+	bool _ok = prefs.putBytes (SLOT_KEY[_h.seq & 1], _buf, _len) == _len;
+	metrics->stop(M_NV_COMMIT, _t0);
+	if (_ok) {
+	    memcpy (committed, image(), _h.len);
+	    committed_seq = _h.seq;
+	    dirty = false;
+	} else if (!dirty) {
+	    dirty = true;
+	    first_put = last_put = millis();
+	}
+}
@@ -1,73 +1,81 @@
-﻿/*!
-* @brief Class to organize variables stored in EEPROM.
-*
-* The public class variables are mirrored in RAM, so change nv then call put(), or call get() then access 
-*
-* @section license License
-*
-* Copyright (c) 2020 Tom Driscoll. 
-* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
-* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
-* and associated documentation files (the "Software"), to deal in the Software without restriction,
-* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
-* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
-* subject to the following conditions: The above copyright notice and this permission notice shall be
-* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
-* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
-* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
-* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
-* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
-* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
-*/
-
-#ifndef _NV_H
-#define _NV_H
-
-#include <EEPROM.h>
-
-class NV {
-
-    private:
-
-        enum {
-            MAGIC  = 0x5a5aa5a5,            //< used to validate the EEPROM stored values
-            EEBASE = 0,                     //< address of the EEPROM storage area
-        };
-
-    public:
-
-        NV()
-        {
-            EEPROM.begin(sizeof(*this));    //< for ESP32, call .begin()
-        }
-
-        uint32_t magic;                     //< magic # read from EEPROM
-        uint16_t mot0min, mot0max;          //< motor 0 minimum and maximum pulse durations
-        uint16_t mot1min, mot1max;          //< motor 1 minimum and maximum pulse durations
-        float_t mag_decl;                   //< magnetic declination of user location
-        float_t m0_azscale, m0_elscale;     //< motor 0 azimuth and elevation conversion from degrees to usec pulse width
-        float_t m1_azscale, m1_elscale;     //< motor 1 azimuth and elevation conversion from degrees to usec pulse width
-        uint8_t best_az_motor;              //< motor that has the most effect in azimuth direction either 0 or 1
-        uint8_t init_step;                  //< step number that the calibration routine ran when this cal was saved. s.b. 4
-
-        void get() 
-        {
-            EEPROM.get (EEBASE, *this);
-            if (magic != MAGIC) {               //< EEPROM was never written, or it was corrupted
-                memset (this, 0, sizeof(*this));//< erase EEPROM values
-                magic = MAGIC;
-                EEPROM.put (EEBASE, *this);     //< save all NV values to EEPROM
-                EEPROM.commit();
-            }
-        }
-
-        void put() 
-        {
-            EEPROM.put (EEBASE, *this);
-            EEPROM.commit();
-        }
-};
-
-extern NV *nv;
-
-#endif // _NV_H
\ No newline at end of file
+﻿/*!
+* @brief Class to organize variables stored in flash.
+*
+* The public class variables are mirrored in RAM, so change nv then call put(), or call get() then access 
+*
+* Stored with Preferences (ESP32 NVS) as a two slot journal: each commit writes the whole image, with
+* a schema version, sequence number and CRC, over the older slot, so a commit cut short by a power
+* failure leaves the previous one intact. put() only marks the image changed; service() commits once
+* the edits stop for COMMIT_DELAY, so a burst of web page overrides costs one flash write, and a
+* put() that changed nothing costs none.
+*
+* @section license License
+*
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _NV_H
+#define _NV_H
+
+#include <Arduino.h>
+
+class NV {
+
+    public:
+
+        enum {
+            SCHEMA = 3,                     //< layout of the variables below; only ever append, and bump it
+            SS_VERSION = 1,                 //< layout of ss_offsets; change it and older saves are ignored
+            SS_OFFSETS_LEN = 22,            //< bytes of BNO055 offset and radius registers
+            WIFI_SSID_LEN = 33,             //< room for the longest SSID and its EOS
+            WIFI_PASS_LEN = 65,             //< room for the longest WPA2 passphrase and its EOS
+            COMMIT_DELAY = 2000,            //< ms without a put() before service() commits
+            MAX_DEFER = 10000,              //< ms after the first uncommitted put() that service() commits anyway
+        };
+
+        NV();
+
+        //< the stored image, from mot0min thru wifi_pass; keep them together, and if a field is
+        //< appended after wifi_pass, end imageSize() and MAX_IMAGE in NV.cpp at it instead
+        uint16_t mot0min, mot0max;          //< motor 0 minimum and maximum pulse durations
+        uint16_t mot1min, mot1max;          //< motor 1 minimum and maximum pulse durations
+        float_t mag_decl;                   //< magnetic declination of user location
+        float_t m0_azscale, m0_elscale;     //< motor 0 azimuth and elevation conversion from degrees to usec pulse width
+        float_t m1_azscale, m1_elscale;     //< motor 1 azimuth and elevation conversion from degrees to usec pulse width
+        uint8_t best_az_motor;              //< motor that has the most effect in azimuth direction either 0 or 1
+        uint8_t init_step;                  //< step number that the calibration routine ran when this cal was saved. s.b. 4
+        uint16_t ss_version;                //< SS_VERSION if ss_offsets holds a saved Sensor calibration
+        uint8_t ss_offsets[SS_OFFSETS_LEN]; //< BNO055 accel, mag and gyro offsets and radii, as getSensorOffsets()
+        char wifi_ssid[WIFI_SSID_LEN];      //< network to join, "" for the built-in WIFI_SSID
+        char wifi_pass[WIFI_PASS_LEN];      //< its password
+
+        void get();
+        void put();
+        void service();
+        void flush();
+        bool pending();
+
+    private:
+
+        uint8_t *image() { return ((uint8_t *)&mot0min); };
+        size_t imageSize() { return ((uint8_t *)&wifi_pass[WIFI_PASS_LEN] - image()); };
+        bool load();
+        bool migrate();
+        void commit();
+};
+
+extern NV *nv;
+
+#endif // _NV_H
@@ -0,0 +1,109 @@
+/*!
+* @brief Class to save power between passes, and to be awake again before the next command runs
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <WiFi.h>
+#include "Power.h"
+#include "Gimbal.h"
+#include "Sensor.h"
+#include "Tracker.h"
+#include "Scheduler.h"
+#include "Metrics.h"
+
+/*! @brief class constructor; awake, with the WiFi modem on so replies don't wait for a beacon
+*
+* Make it after the Gimbal, Sensor and Tracker, and after WiFi has started.
+*/
+Power::Power()
+{
+	idle = false;
+	last_activity = millis();
+	awake_mhz = getCpuFrequencyMhz();
+	sensor_interval = 0;
+	WiFi.setSleep (false);
+}
+
+/*! @brief call at the top of loop(): while idle, nap until a job is due, then wake or idle as need be
+*
+* Runs before the jobs, so a command that ended a nap finds everything awake.
+*/
+void Power::service()
+{
+	if (idle) {
+	    scheduler->nap();
+	}
+	bool _quiet = IDLE_AFTER > 0 && quiet (millis());
+	if (idle && !_quiet) {
+	    leave();
+	} else if (!idle && _quiet) {
+	    enter();
+	}
+}
+
+/*! @brief note Easycomm traffic or a user's command, and end a nap to see to it
+*
+* Safe from any task.
+*/
+void Power::activity()
+{
+	last_activity = millis();
+	if (idle) {
+	    scheduler->wake();
+	}
+}
+
+/*! @brief whether there has been nothing to do for IDLE_AFTER, and nothing is coming up
+* @param now millis()
+*/
+bool Power::quiet (uint32_t now)
+{
+	uint32_t _after = IDLE_AFTER * 1000UL;
+	return (now - last_activity >= _after && now - gimbal->lastMotion() >= _after && !gimbal->busy()
+			&& !tracker->passWithin (PASS_LEAD));
+}
+
+/*! @brief go idle
+ */
+void Power::enter()
+{
+	idle = true;						//< first, so activity() from here on ends the nap
+	metrics->count(C_IDLE);
+	gimbal->rest();
+	if (sensor->taskRunning()) {
+	    sensor_interval = sensor->taskInterval();
+	    sensor->setTaskInterval (IDLE_SENSOR_INTERVAL);
+	}
+	WiFi.setSleep (true);
+	setCpuFrequencyMhz (IDLE_MHZ);
+}
+
+/*! @brief be awake again, CPU clock first so the rest goes at full speed
+*
+* The first Sensor sample at the full rate may be up to IDLE_SENSOR_INTERVAL away, but the
+* antenna hasn't moved, so the last one is still good.
+*/
+void Power::leave()
+{
+	setCpuFrequencyMhz (awake_mhz);
+	WiFi.setSleep (false);
+	if (sensor->taskRunning()) {
+	    sensor->setTaskInterval (sensor_interval);
+	}
+	gimbal->wake();
+	idle = false;
+}
@@ -0,0 +1,59 @@
+/*!
+* @brief Class to save power between passes, and to be awake again before the next command runs
+*
+* Idle begins once there has been no Easycomm traffic and no new Gimbal target for IDLE_AFTER seconds,
+* with no self-tracked pass due within PASS_LEAD. Idle runs the CPU at IDLE_MHZ, lets the WiFi modem
+* sleep between beacons, stops the PCA9685 outputs, samples the Sensor every IDLE_SENSOR_INTERVAL,
+* and has loop() nap until its next job instead of spinning. A command on Serial or a TCP session,
+* a new session, a web page override or a new target ends it before the command is run.
+*
+* N.B. not light sleep: the Arduino core can't keep the WiFi association thru it, and the host must
+* be able to reach us at any time.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _POWER_H
+#define _POWER_H
+
+#include <Arduino.h>
+
+#define IDLE_AFTER       120	///<  seconds with nothing to do before idling, 0 for never
+
+class Power {
+
+    public:
+	Power();
+	void service();
+	void activity();
+	bool isIdle() { return (idle); };
+
+    private:
+	static const uint32_t IDLE_MHZ = 80;			// least CPU clock WiFi runs at
+	static const uint16_t IDLE_SENSOR_INTERVAL = 250;	// ms between Sensor samples while idle
+	static const uint16_t PASS_LEAD = 60;			// seconds before a self-tracked pass to be awake
+	volatile bool idle;					//< enter() has run, leave() not yet
+	volatile uint32_t last_activity;	//< millis() of the latest Easycomm traffic
+	uint32_t awake_mhz;					//< CPU clock to go back to
+	uint32_t sensor_interval;			//< Sensor task interval to go back to
+	bool quiet (uint32_t now);
+	void enter();
+	void leave();
+};
+
+extern Power *power;
+
+#endif // _POWER_H
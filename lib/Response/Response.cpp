@@ -0,0 +1,127 @@
+/*!
+* @brief Class to collect NAME=VALUE lines for the web page in a fixed buffer
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdarg.h>
+#include "Response.h"
+
+/*! @brief class constructor
+*
+* @param buf storage for the response, used until the Response goes away
+* @param size bytes at buf
+*/
+Response::Response (char *buf, size_t size)
+{
+	this->buf = buf;
+	this->size = size;
+	clear();
+}
+
+/*! @brief empty the response
+ */
+void Response::clear()
+{
+	len = 0;
+	buf[0] = '\0';
+	overflow = false;
+}
+
+/*! @brief copy n bytes to the end, or set overflow if they don't fit
+*/
+void Response::append (const char *s, size_t n)
+{
+	if (overflow || len + n >= size) {
+	    overflow = true;
+	    return;
+	}
+	memcpy (buf + len, s, n);
+	len += n;
+	buf[len] = '\0';
+}
+
+/*! @brief add one NAME=VALUE line
+*
+* @param name the web page id
+* @param value its text, optionally ending with '!' for an alarm or '+' for good
+*/
+void Response::add (const char *name, const char *value)
+{
+	size_t _start = len;
+	bool _was = overflow;
+	append (name, strlen (name));
+	append ("=", 1);
+	append (value, strlen (value));
+	append ("\n", 1);
+	if (overflow && !_was) {
+	    //< drop the partial line
+	    len = _start;
+	    buf[len] = '\0';
+	}
+}
+
+/*! @brief add one NAME=VALUE line with an F() value
+*/
+void Response::add (const char *name, const __FlashStringHelper *value)
+{
+	add (name, (const char *)value);
+}
+
+/*! @brief add one NAME=VALUE line with an integer value
+*/
+void Response::add (const char *name, int32_t value)
+{
+	addf (name, "%d", value);
+}
+
+/*! @brief add one NAME=VALUE line with a float value
+*
+* @param digits places after the decimal point
+*/
+void Response::add (const char *name, float value, uint8_t digits)
+{
+	addf (name, "%.*f", digits, value);
+}
+
+/*! @brief add one NAME=VALUE line with the value formatted as printf()
+*/
+void Response::addf (const char *name, const char *format, ...)
+{
+	char _value[64];
+	va_list _args;
+	va_start (_args, format);
+	vsnprintf (_value, sizeof(_value), format, _args);
+	va_end (_args);
+	add (name, _value);
+}
+
+/*! @brief Print interface, for anything that prints rather than adds
+*/
+size_t Response::write (uint8_t c)
+{
+	char _c = c;
+	append (&_c, 1);
+	return (overflow ? 0 : 1);
+}
+
+/*! @brief Print interface, for anything that prints rather than adds
+*/
+size_t Response::write (const uint8_t *data, size_t n)
+{
+	append ((const char *)data, n);
+	return (overflow ? 0 : n);
+}
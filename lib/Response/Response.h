@@ -0,0 +1,51 @@
+/*!
+* @brief Class to collect NAME=VALUE lines for the web page in a fixed buffer
+*
+* Subsystems add their values with add(); the whole response is then sent with one write.
+* Nothing is allocated: a line that would not fit is dropped whole and overflowed() is set.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _RESPONSE_H
+#define _RESPONSE_H
+
+#include <Arduino.h>
+
+class Response : public Print {
+
+    private:
+	char *buf;					//< caller's storage, always '\0' terminated
+	size_t size, len;
+	bool overflow;				//< something did not fit since clear()
+	void append (const char *s, size_t n);
+
+    public:
+	Response (char *buf, size_t size);
+	void clear();
+	void add (const char *name, const char *value);
+	void add (const char *name, const __FlashStringHelper *value);
+	void add (const char *name, int32_t value);
+	void add (const char *name, float value, uint8_t digits);
+	void addf (const char *name, const char *format, ...);
+	const char *text() { return (buf); };
+	size_t length() { return (len); };
+	bool overflowed() { return (overflow); };
+	size_t write (uint8_t c);
+	size_t write (const uint8_t *data, size_t n);
+};
+
+#endif // _RESPONSE_H
@@ -0,0 +1,316 @@
+/*!
+* @brief Class to propagate a satellite orbit from a NORAD two-line element set
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SGP4.h"
+
+/*! @brief verify the modulo-10 checksum in column 69 of a TLE line
+* @param line one line of the element set
+* @return true if line is long enough and the checksum matches
+*/
+bool SGP4::checksum (const char *line)
+{
+	if (strlen (line) < 69) {
+	    return (false);
+	}
+	uint16_t _sum = 0;
+	for (uint8_t i = 0; i < 68; i++) {
+	    if (line[i] >= '0' && line[i] <= '9') {
+		    _sum += line[i] - '0';
+	    } else if (line[i] == '-') {
+		    _sum += 1;
+	    }
+	}
+	return ((_sum % 10) == (uint16_t)(line[68] - '0'));
+}
+
+/*! @brief read a fixed-column number from a TLE line
+* @param line one line of the element set
+* @param start 0-based column of the first character
+* @param len number of columns
+* @return the value
+*/
+double SGP4::field (const char *line, uint8_t start, uint8_t len)
+{
+	char _buf[16];
+	memcpy (_buf, line + start, len);
+	_buf[len] = '\0';
+	return (atof (_buf));
+}
+
+/*! @brief read a TLE field in assumed-decimal exponential notation, e.g. " 12345-4" == 0.12345e-4
+* @param line one line of the element set
+* @param start 0-based column of the sign character
+* @return the value
+*/
+double SGP4::expField (const char *line, uint8_t start)
+{
+	double _mant = field (line, start + 1, 5) * 1e-5;
+	int _exp = (int)field (line, start + 6, 2);
+	return ((line[start] == '-' ? -_mant : _mant) * pow (10.0, _exp));
+}
+
+/*! @brief parse an element set and initialize the propagator
+*
+* @param line1 first line of the TLE, starting with '1'
+* @param line2 second line of the TLE, starting with '2'
+* @return true if the elements are valid near-earth elements
+*/
+bool SGP4::init (const char *line1, const char *line2)
+{
+	valid = false;
+	if (line1[0] != '1' || line2[0] != '2' || !checksum (line1) || !checksum (line2)) {
+	    return (false);
+	}
+	const double _deg2rad = M_PI / 180;
+	const double _x2o3 = 2.0 / 3.0;
+
+	//< epoch: 2-digit year and fractional day of year
+	int _year = (int)field (line1, 18, 2);
+	_year += (_year < 57) ? 2000 : 1900;
+	double _days = field (line1, 20, 12);
+	long _y = _year - 1;
+	long _jan1 = 365L * (_year - 1970) + (_y / 4 - 1969 / 4) - (_y / 100 - 1969 / 100) + (_y / 400 - 1969 / 400);
+	epoch_unix = (_jan1 + _days - 1) * 86400.0;
+
+	bstar = expField (line1, 53);
+	inclo = field (line2, 8, 8) * _deg2rad;
+	nodeo = field (line2, 17, 8) * _deg2rad;
+	char _ecc[9] = "0.";
+	memcpy (_ecc + 2, line2 + 26, 7);
+	_ecc[8] = '\0';
+	ecco = atof (_ecc);
+	argpo = field (line2, 34, 8) * _deg2rad;
+	mo = field (line2, 43, 8) * _deg2rad;
+	no = field (line2, 52, 11) * 2 * M_PI / 1440.0;	//< rev/day to rad/min
+	if (no <= 0 || ecco >= 1) {
+	    return (false);
+	}
+
+	//< recover original mean motion and semi-major axis from the Kozai mean motion
+	double _cosio = cos (inclo);
+	double _cosio2 = _cosio * _cosio;
+	double _eccsq = ecco * ecco;
+	double _omeosq = 1 - _eccsq;
+	double _rteosq = sqrt (_omeosq);
+	double _ak = pow (XKE / no, _x2o3);
+	double _d1 = 0.75 * J2 * (3 * _cosio2 - 1) / (_rteosq * _omeosq);
+	double _del = _d1 / (_ak * _ak);
+	double _adel = _ak * (1 - _del * _del - _del * (1.0 / 3.0 + 134 * _del * _del / 81));
+	_del = _d1 / (_adel * _adel);
+	no = no / (1 + _del);
+	if (2 * M_PI / no >= 225) {
+	    return (false);	//< deep-space, SDP4 not supported
+	}
+	double _ao = pow (XKE / no, _x2o3);
+	double _sinio = sin (inclo);
+	double _po = _ao * _omeosq;
+	double _con42 = 1 - 5 * _cosio2;
+	con41 = -_con42 - _cosio2 - _cosio2;
+	double _posq = _po * _po;
+	double _rp = _ao * (1 - ecco);
+
+	//< atmospheric drag and perigee dependent terms
+	isimp = (_rp < (220 / RE + 1));
+	double _sfour = 78 / RE + 1;
+	double _qzms24 = pow ((120 - 78) / RE, 4);
+	double _perige = (_rp - 1) * RE;
+	if (_perige < 156) {
+	    _sfour = _perige - 78;
+	    if (_perige < 98) {
+		    _sfour = 20;
+	    }
+	    _qzms24 = pow ((120 - _sfour) / RE, 4);
+	    _sfour = _sfour / RE + 1;
+	}
+	double _pinvsq = 1 / _posq;
+	double _tsi = 1 / (_ao - _sfour);
+	eta = _ao * ecco * _tsi;
+	double _etasq = eta * eta;
+	double _eeta = ecco * eta;
+	double _psisq = fabs (1 - _etasq);
+	double _coef = _qzms24 * pow (_tsi, 4);
+	double _coef1 = _coef / pow (_psisq, 3.5);
+	double _cc2 = _coef1 * no * (_ao * (1 + 1.5 * _etasq + _eeta * (4 + _etasq))
+		+ 0.375 * J2 * _tsi / _psisq * con41 * (8 + 3 * _etasq * (8 + _etasq)));
+	cc1 = bstar * _cc2;
+	double _cc3 = 0;
+	if (ecco > 1e-4) {
+	    _cc3 = -2 * _coef * _tsi * J3OJ2 * no * _sinio / ecco;
+	}
+	x1mth2 = 1 - _cosio2;
+	cc4 = 2 * no * _coef1 * _ao * _omeosq * (eta * (2 + 0.5 * _etasq) + ecco * (0.5 + 2 * _etasq)
+		- J2 * _tsi / (_ao * _psisq) * (-3 * con41 * (1 - 2 * _eeta + _etasq * (1.5 - 0.5 * _eeta))
+		+ 0.75 * x1mth2 * (2 * _etasq - _eeta * (1 + _etasq)) * cos (2 * argpo)));
+	cc5 = 2 * _coef1 * _ao * _omeosq * (1 + 2.75 * (_etasq + _eeta) + _eeta * _etasq);
+
+	//< secular rates
+	double _cosio4 = _cosio2 * _cosio2;
+	double _temp1 = 1.5 * J2 * _pinvsq * no;
+	double _temp2 = 0.5 * _temp1 * J2 * _pinvsq;
+	double _temp3 = -0.46875 * J4 * _pinvsq * _pinvsq * no;
+	mdot = no + 0.5 * _temp1 * _rteosq * con41 + 0.0625 * _temp2 * _rteosq * (13 - 78 * _cosio2 + 137 * _cosio4);
+	argpdot = -0.5 * _temp1 * _con42 + 0.0625 * _temp2 * (7 - 114 * _cosio2 + 395 * _cosio4)
+		+ _temp3 * (3 - 36 * _cosio2 + 49 * _cosio4);
+	double _xhdot1 = -_temp1 * _cosio;
+	nodedot = _xhdot1 + (0.5 * _temp2 * (4 - 19 * _cosio2) + 2 * _temp3 * (3 - 7 * _cosio2)) * _cosio;
+	omgcof = bstar * _cc3 * cos (argpo);
+	xmcof = 0;
+	if (ecco > 1e-4) {
+	    xmcof = -_x2o3 * _coef * bstar / _eeta;
+	}
+	nodecf = 3.5 * _omeosq * _xhdot1 * cc1;
+	t2cof = 1.5 * cc1;
+	double _den = (fabs (_cosio + 1) > 1.5e-12) ? (1 + _cosio) : 1.5e-12;
+	xlcof = -0.25 * J3OJ2 * _sinio * (3 + 5 * _cosio) / _den;
+	aycof = -0.5 * J3OJ2 * _sinio;
+	delmo = pow (1 + eta * cos (mo), 3);
+	sinmao = sin (mo);
+	x7thm1 = 7 * _cosio2 - 1;
+	if (!isimp) {
+	    double _cc1sq = cc1 * cc1;
+	    d2 = 4 * _ao * _tsi * _cc1sq;
+	    double _temp = d2 * _tsi * cc1 / 3;
+	    d3 = (17 * _ao + _sfour) * _temp;
+	    d4 = 0.5 * _temp * _ao * _tsi * (221 * _ao + 31 * _sfour) * cc1;
+	    t3cof = d2 + 2 * _cc1sq;
+	    t4cof = 0.25 * (3 * d3 + cc1 * (12 * d2 + 10 * _cc1sq));
+	    t5cof = 0.2 * (3 * d4 + 12 * cc1 * d3 + 6 * d2 * d2 + 15 * _cc1sq * (2 * d2 + _cc1sq));
+	}
+	valid = true;
+	return (true);
+}
+
+/*! @brief compute the satellite position at a time relative to the element set epoch
+*
+* @param tsince minutes since epoch
+* @param r receives the TEME position, km
+* @return true if the orbit is still physical at tsince
+*/
+bool SGP4::propagate (double tsince, double r[3])
+{
+	if (!valid) {
+	    return (false);
+	}
+	const double _twopi = 2 * M_PI;
+	double _t = tsince;
+	double _t2 = _t * _t;
+
+	//< secular gravity and atmospheric drag
+	double _xmdf = mo + mdot * _t;
+	double _argpdf = argpo + argpdot * _t;
+	double _nodedf = nodeo + nodedot * _t;
+	double _argpm = _argpdf;
+	double _mm = _xmdf;
+	double _nodem = _nodedf + nodecf * _t2;
+	double _tempa = 1 - cc1 * _t;
+	double _tempe = bstar * cc4 * _t;
+	double _templ = t2cof * _t2;
+	if (!isimp) {
+	    double _delomg = omgcof * _t;
+	    double _delm = xmcof * (pow (1 + eta * cos (_xmdf), 3) - delmo);
+	    double _temp = _delomg + _delm;
+	    _mm = _xmdf + _temp;
+	    _argpm = _argpdf - _temp;
+	    double _t3 = _t2 * _t;
+	    double _t4 = _t3 * _t;
+	    _tempa = _tempa - d2 * _t2 - d3 * _t3 - d4 * _t4;
+	    _tempe = _tempe + bstar * cc5 * (sin (_mm) - sinmao);
+	    _templ = _templ + t3cof * _t3 + _t4 * (t4cof + _t * t5cof);
+	}
+	double _am = pow (XKE / no, 2.0 / 3.0) * _tempa * _tempa;
+	double _em = ecco - _tempe;
+	if (_em >= 1 || _em < -0.001) {
+	    return (false);
+	}
+	if (_em < 1e-6) {
+	    _em = 1e-6;
+	}
+	_mm = _mm + no * _templ;
+	double _xlm = fmod (_mm + _argpm + _nodem, _twopi);
+	_nodem = fmod (_nodem, _twopi);
+	_argpm = fmod (_argpm, _twopi);
+	_mm = fmod (_xlm - _argpm - _nodem, _twopi);
+	double _sinip = sin (inclo);
+	double _cosip = cos (inclo);
+
+	//< long period periodics
+	double _axnl = _em * cos (_argpm);
+	double _temp = 1 / (_am * (1 - _em * _em));
+	double _aynl = _em * sin (_argpm) + _temp * aycof;
+	double _xl = _mm + _argpm + _nodem + _temp * xlcof * _axnl;
+
+	//< solve kepler's equation
+	double _u = fmod (_xl - _nodem, _twopi);
+	double _eo1 = _u;
+	double _tem5 = 9999.9;
+	double _sineo1 = 0, _coseo1 = 1;
+	for (uint8_t _ktr = 0; fabs (_tem5) >= 1e-12 && _ktr < 10; _ktr++) {
+	    _sineo1 = sin (_eo1);
+	    _coseo1 = cos (_eo1);
+	    _tem5 = 1 - _coseo1 * _axnl - _sineo1 * _aynl;
+	    _tem5 = (_u - _aynl * _coseo1 + _axnl * _sineo1 - _eo1) / _tem5;
+	    if (fabs (_tem5) >= 0.95) {
+		    _tem5 = _tem5 > 0 ? 0.95 : -0.95;
+	    }
+	    _eo1 = _eo1 + _tem5;
+	}
+
+	//< short period preliminary quantities
+	double _ecose = _axnl * _coseo1 + _aynl * _sineo1;
+	double _esine = _axnl * _sineo1 - _aynl * _coseo1;
+	double _el2 = _axnl * _axnl + _aynl * _aynl;
+	double _pl = _am * (1 - _el2);
+	if (_pl < 0) {
+	    return (false);
+	}
+	double _rl = _am * (1 - _ecose);
+	double _betal = sqrt (1 - _el2);
+	_temp = _esine / (1 + _betal);
+	double _sinu = _am / _rl * (_sineo1 - _aynl - _axnl * _temp);
+	double _cosu = _am / _rl * (_coseo1 - _axnl + _aynl * _temp);
+	double _su = atan2 (_sinu, _cosu);
+	double _sin2u = (_cosu + _cosu) * _sinu;
+	double _cos2u = 1 - 2 * _sinu * _sinu;
+	_temp = 1 / _pl;
+	double _temp1 = 0.5 * J2 * _temp;
+	double _temp2 = _temp1 * _temp;
+
+	//< update for short period periodics
+	double _mrt = _rl * (1 - 1.5 * _temp2 * _betal * con41) + 0.5 * _temp1 * x1mth2 * _cos2u;
+	_su = _su - 0.25 * _temp2 * x7thm1 * _sin2u;
+	double _xnode = _nodem + 1.5 * _temp2 * _cosip * _sin2u;
+	double _xinc = inclo + 1.5 * _temp2 * _cosip * _sinip * _cos2u;
+	if (_mrt < 1) {
+	    return (false);	//< decayed
+	}
+
+	//< orientation vectors
+	double _sinsu = sin (_su), _cossu = cos (_su);
+	double _snod = sin (_xnode), _cnod = cos (_xnode);
+	double _sini = sin (_xinc), _cosi = cos (_xinc);
+	double _xmx = -_snod * _cosi;
+	double _xmy = _cnod * _cosi;
+	r[0] = _mrt * (_xmx * _sinsu + _cnod * _cossu) * RE;
+	r[1] = _mrt * (_xmy * _sinsu + _snod * _cossu) * RE;
+	r[2] = _mrt * (_sini * _sinsu) * RE;
+	return (true);
+}
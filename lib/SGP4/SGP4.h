@@ -0,0 +1,61 @@
+/*!
+* @brief Class to propagate a satellite orbit from a NORAD two-line element set
+*
+* Near-earth SGP4 only, following Vallado et al., "Revisiting Spacetrack Report #3", AIAA 2006-6753.
+* Deep-space (period >= 225 minutes) element sets are rejected; SatNOGS rotators track LEO.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _SGP4_H
+#define _SGP4_H
+
+#include <stdint.h>
+
+class SGP4 {
+
+    private:
+
+	// WGS-72 constants, as used to generate the element sets
+	static constexpr double RE = 6378.135;				// earth radius, km
+	static constexpr double XKE = 0.0743669161331734;	// sqrt(GM) in earth radii^1.5 / min
+	static constexpr double J2 = 0.001082616;
+	static constexpr double J3OJ2 = -0.00000253881 / 0.001082616;
+	static constexpr double J4 = -0.00000165597;
+
+	// mean elements at epoch
+	double epoch_unix;					// epoch, seconds since 1970
+	double bstar, ecco, inclo, nodeo, argpo, mo, no;
+	// secular and drag coefficients set by init()
+	bool isimp;
+	double con41, cc1, cc4, cc5, d2, d3, d4, delmo, eta, argpdot, omgcof, sinmao;
+	double t2cof, t3cof, t4cof, t5cof, x1mth2, x7thm1, mdot, nodedot, xlcof, xmcof, nodecf, aycof;
+	bool valid;
+
+	bool checksum (const char *line);
+	double field (const char *line, uint8_t start, uint8_t len);
+	double expField (const char *line, uint8_t start);
+
+    public:
+
+	SGP4() { valid = false; };
+	bool init (const char *line1, const char *line2);
+	bool propagate (double tsince, double r[3]);
+	bool isValid() { return (valid); };
+	double epoch() { return (epoch_unix); };
+};
+
+#endif // _SGP4_H
@@ -0,0 +1,166 @@
+/*!
+* @brief Class to run the firmware's periodic jobs from loop() by priority and deadline
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Scheduler.h"
+
+/*! @brief class constructor; make it in setup(), the task that calls run()
+ */
+Scheduler::Scheduler()
+{
+	n_jobs = 0;
+	loop_task = xTaskGetCurrentTaskHandle();
+}
+
+/*! @brief register a periodic job
+*
+* @param name short label for statistics
+* @param fn function to call
+* @param period ms between calls
+* @param priority higher runs first when several jobs are due
+* @param deadline ms after release by which fn should have returned, 0 for one period
+* @return job number, or -1 if there is no room
+*/
+int8_t Scheduler::add (const char *name, JobFunction fn, uint32_t period, uint8_t priority, uint32_t deadline)
+{
+	if (n_jobs >= MAX_JOBS) {
+	    return (-1);
+	}
+	Job *_jp = &jobs[n_jobs];
+	_jp->name = name;
+	_jp->fn = fn;
+	_jp->period = period;
+	_jp->deadline = deadline ? deadline : period;
+	_jp->priority = priority;
+	_jp->next = millis() + period;
+	_jp->run_us = _jp->max_us = 0;
+	_jp->runs = _jp->overruns = 0;
+	return (n_jobs++);
+}
+
+/*! @brief find the most urgent job that is due
+*
+* Highest priority wins; among equal priorities the earliest deadline wins.
+* @return jobs[] index, or -1 if none is due
+*/
+int8_t Scheduler::pick ()
+{
+	uint32_t _now = millis();
+	int8_t _best = -1;
+	for (uint8_t i = 0; i < n_jobs; i++) {
+	    Job *_jp = &jobs[i];
+	    if ((int32_t)(_now - _jp->next) < 0) {
+		    continue;
+	    }
+	    if (_best < 0 || _jp->priority > jobs[_best].priority
+			    || (_jp->priority == jobs[_best].priority
+				&& (int32_t)((_jp->next + _jp->deadline) - (jobs[_best].next + jobs[_best].deadline)) < 0)) {
+		    _best = i;
+	    }
+	}
+	return (_best);
+}
+
+/*! @brief run one job, measure it and schedule its next release
+* @param i jobs[] index
+*/
+void Scheduler::runJob (uint8_t i)
+{
+	Job *_jp = &jobs[i];
+	uint32_t _release = _jp->next;
+	uint32_t _start = micros();
+	_jp->fn();
+	_jp->run_us = micros() - _start;
+	if (_jp->run_us > _jp->max_us) {
+	    _jp->max_us = _jp->run_us;
+	}
+	_jp->runs++;
+	uint32_t _now = millis();
+	if ((int32_t)(_now - (_release + _jp->deadline)) > 0) {
+	    _jp->overruns++;
+	}
+	//< keep phase, but don't try to catch up on releases we missed entirely
+	_jp->next = _release + _jp->period;
+	if ((int32_t)(_now - _jp->next) >= 0) {
+	    _jp->next = _now + _jp->period;
+	}
+}
+
+/*! @brief call this repeatedly from loop() to run every job that is due, most urgent first
+ */
+void Scheduler::run ()
+{
+	for (uint8_t n = 0; n < n_jobs; n++) {
+	    int8_t _i = pick ();
+	    if (_i < 0) {
+		    return;
+	    }
+	    runJob (_i);
+	}
+}
+
+/*! @brief block loop() until the next job is due, or until wake()
+*
+* Lets the idle task sleep the CPU instead of run() polling; call with nothing running.
+*/
+void Scheduler::nap ()
+{
+	uint32_t _now = millis();
+	TickType_t _wait = portMAX_DELAY;
+	for (uint8_t i = 0; i < n_jobs; i++) {
+	    int32_t _due = jobs[i].next - _now;
+	    if (_due <= 0) {
+		    return;
+	    }
+	    if ((TickType_t)pdMS_TO_TICKS(_due) < _wait) {
+		    _wait = pdMS_TO_TICKS(_due);
+	    }
+	}
+	ulTaskNotifyTake (pdTRUE, _wait);
+}
+
+/*! @brief end a nap() early, from a task that has just given loop() something to do
+*/
+void Scheduler::wake ()
+{
+	xTaskNotifyGive (loop_task);
+}
+
+/*! @brief report statistics for one job
+*
+* @param i job number, 0 .. count()-1
+* @param name receives the job label
+* @param runs receives the number of times run
+* @param overruns receives the number of times the job finished after its deadline
+* @param run_us receives the latest run time, microseconds
+* @param max_us receives the worst run time, microseconds
+* @return false if there is no such job
+*/
+bool Scheduler::stats (uint8_t i, const char **name, uint32_t *runs, uint32_t *overruns, uint32_t *run_us, uint32_t *max_us)
+{
+	if (i >= n_jobs) {
+	    return (false);
+	}
+	Job *_jp = &jobs[i];
+	*name = _jp->name;
+	*runs = _jp->runs;
+	*overruns = _jp->overruns;
+	*run_us = _jp->run_us;
+	*max_us = _jp->max_us;
+	return (true);
+}
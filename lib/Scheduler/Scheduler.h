@@ -0,0 +1,64 @@
+/*!
+* @brief Class to run the firmware's periodic jobs from loop() by priority and deadline
+*
+* Cooperative: a job runs to completion, so a job must not wait on anything; more urgent jobs
+* that come due in the meantime run once it returns. Between passes loop() may nap()
+* until the next job is due instead of spinning; another task that has work for it calls wake().
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#include <Arduino.h>
+
+typedef void (*JobFunction)();
+
+class Scheduler {
+
+    private:
+	typedef struct {
+	    const char *name;
+	    JobFunction fn;
+	    uint32_t period;				// ms between releases
+	    uint32_t deadline;				// ms after release by which the job should have finished
+	    uint8_t priority;				// higher runs first
+	    uint32_t next;					// millis() of next release
+	    uint32_t run_us, max_us;		// last and worst run time
+	    uint32_t runs, overruns;		// overrun: finished after release + deadline
+	} Job;
+	static const uint8_t MAX_JOBS = 12;
+	Job jobs[MAX_JOBS];
+	uint8_t n_jobs;
+	TaskHandle_t loop_task;				//< the task that made us, and runs run(); nap() blocks it
+
+	int8_t pick ();
+	void runJob (uint8_t i);
+
+    public:
+	Scheduler();
+	int8_t add (const char *name, JobFunction fn, uint32_t period, uint8_t priority, uint32_t deadline = 0);
+	void run ();
+	void nap ();
+	void wake ();
+	uint8_t count() { return (n_jobs); };
+	bool stats (uint8_t i, const char **name, uint32_t *runs, uint32_t *overruns, uint32_t *run_us, uint32_t *max_us);
+};
+
+extern Scheduler *scheduler;
+
+#endif // _SCHEDULER_H
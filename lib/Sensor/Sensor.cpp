@@ -21,43 +21,294 @@
 #include "Sensor.h"
 #include "NV.h"
 #include "Webpage.h"
+#include "Metrics.h"
 
 /*! @brief class constructor
  */
 Sensor::Sensor()
 {
-	//< instantiate, discover and initialize
-	bno = new Adafruit_BNO055(-1, I2CADDR);
-	sensor_found = bno->begin(Adafruit_BNO055::OPERATION_MODE_NDOF);
+	task = NULL;
+	task_interval = 0;
+	sample_seq = 0;
+	memset (&sample, 0, sizeof(sample));
+	filter_time = 0;
+	temperature = 0;
+	temp_time = 0;
+	health = H_RUNNING;
+	health_wait = health_start = 0;
+	fusion_start = last_change = 0;
+	cal_seen = false;
+	cal_lost = 0;
+	bad_samples = 0;
+	memset (last_raw, 0, sizeof(last_raw));
+	cal_time = 0;
+	restart_wanted = false;
+	last_status = 0;
+	//< instantiate, discover and initialize, from the saved calibration if there is one
+	nv->get();
+	bno = new Adafruit_BNO055(-1, I2CADDR, &i2cbus->wire(I2C_SENSOR));
+	sensor_found = begun = startSensor();
 	system_status = 1;
 	self_test_results = 0;
 	system_error = 3;
+	sys = gyro = accel = mag = 0;
 	calok = false;
 }
 
-/*! @brief test that the Sensor is still working
+/*! @brief (re)start the BNO055 fusion, loading the offsets saved by saveCalibration()
 *
+* With offsets loaded the fusion is usable within a second or so instead of after minutes
+* of waving the antenna about. Call with the bus locked, or before anything else uses it.
+* @return true if the BNO055 answered
+*/
+bool Sensor::startSensor()
+{
+	if (!bno->begin(Adafruit_BNO055::OPERATION_MODE_NDOF)) {
+	    return (false);
+	}
+	if (nv->ss_version == NV::SS_VERSION) {
+	    bno->setSensorOffsets(nv->ss_offsets);
+	}
+	filter_time = 0;
+	fusion_start = last_change = millis();
+	cal_seen = false;
+	cal_lost = 0;
+	return (true);
+}
+
+/*! @brief reboot the BNO055 thru its system trigger; serviceRecovery() takes it from there
+*
+* Unlike begin(), which waits the whole time, this only starts the reset. Call with the bus locked.
+* @param now millis()
+*/
+void Sensor::startRecovery (uint32_t now)
+{
+	uint8_t _rst = RST_SYS;
+	writeReg (REG_SYS_TRIGGER, &_rst, 1);
+	health = H_RESETTING;
+	health_start = now;
+	health_wait = now + RESET_WAIT;
+}
+
+/*! @brief the next step of the restart, a register write or two at most, once its wait is over
+*
+* Once the BNO055 answers it is set up as begin() would, with the saved offsets if there are any,
+* and put back into NDOF. One that never answers is reset again every RECOVER_TIMEOUT, so a
+* BNO055 plugged in later is found. Call with the bus locked.
+* @param now millis()
+*/
+void Sensor::serviceRecovery (uint32_t now)
+{
+	if ((int32_t)(now - health_wait) < 0) {
+	    return;
+	}
+	if (health == H_RESETTING) {
+	    if (readReg (REG_CHIP_ID) != CHIP_ID) {
+		    if (now - health_start >= RECOVER_TIMEOUT) {
+			    startRecovery (now);
+		    } else {
+			    health_wait = now + PROBE_PERIOD;
+		    }
+		    return;
+	    }
+	    //< out of reset it is in CONFIG mode, where the offsets may be written
+	    uint8_t _zero = 0;
+	    writeReg (REG_PAGE_ID, &_zero, 1);
+	    writeReg (REG_PWR_MODE, &_zero, 1);		//< normal power
+	    writeReg (REG_SYS_TRIGGER, &_zero, 1);	//< internal oscillator, as begin()
+	    if (nv->ss_version == NV::SS_VERSION) {
+		    writeReg (REG_OFFSETS, nv->ss_offsets, NV::SS_OFFSETS_LEN);
+	    }
+	    uint8_t _mode = Adafruit_BNO055::OPERATION_MODE_NDOF;
+	    writeReg (REG_OPR_MODE, &_mode, 1);
+	    health = H_STARTING;
+	    health_wait = now + MODE_WAIT;
+	} else if (health == H_STARTING) {
+	    health = H_RUNNING;
+	    sensor_found = true;
+	    bad_samples = 0;
+	    filter_time = 0;
+	    fusion_start = last_change = now;
+	    cal_seen = false;
+	    cal_lost = 0;
+	}
+}
+
+/*! @brief write BNO055 registers in one transaction; call with the bus locked
+*
+* Not reported to i2cbus: a missing BNO055 is not a bus fault.
+* @param reg first register
+* @param data bytes for it and those following
+* @param n number of bytes
+* @return true if acknowledged
+*/
+bool Sensor::writeReg (uint8_t reg, const uint8_t *data, uint8_t n)
+{
+	TwoWire &_wire = i2cbus->wire(I2C_SENSOR);
+	_wire.beginTransmission (I2CADDR);
+	_wire.write (reg);
+	_wire.write (data, n);
+	return (_wire.endTransmission() == 0);
+}
+
+/*! @brief read one BNO055 register; call with the bus locked
+*
+* @param reg the register
+* @return its value, or -1 if the BNO055 did not answer
+*/
+int Sensor::readReg (uint8_t reg)
+{
+	TwoWire &_wire = i2cbus->wire(I2C_SENSOR);
+	_wire.beginTransmission (I2CADDR);
+	_wire.write (reg);
+	if (_wire.endTransmission() != 0 || _wire.requestFrom ((int)I2CADDR, 1) != 1) {
+	    return (-1);
+	}
+	return (_wire.read());
+}
+
+/*! @brief save the BNO055 offsets to NV so the next startSensor() can load them
+*
+* Only a full calibration is worth keeping; the BNO055 reports its offsets only then anyway.
+* @return true if saved
+*/
+bool Sensor::saveCalibration()
+{
+	if (!sensor_found) {
+	    return (false);
+	}
+	uint8_t _offsets[NV::SS_OFFSETS_LEN];
+	i2cbus->lock(I2C_SENSOR);
+	if (!begun) {
+	    bno->setMode(Adafruit_BNO055::OPERATION_MODE_NDOF);	//< found by a restart: tell the driver the mode it is in
+	    begun = true;
+	}
+	bool _ok = bno->getSensorOffsets(_offsets);
+	fusion_start = millis();				//< that went thru CONFIG mode, give the fusion time to restart
+	i2cbus->unlock(I2C_SENSOR);
+	if (!_ok) {
+	    return (false);
+	}
+	memcpy (nv->ss_offsets, _offsets, sizeof(_offsets));
+	nv->ss_version = NV::SS_VERSION;
+	nv->put();
+	return (true);
+}
+
+/*! @brief start sampling the Sensor from a task pinned to the otherwise idle core
+*
+* After this, readAzElT() need not be called from loop() or Gimbal;
+* getSensorAz(), getSensorEl() and getTempC() return the latest published sample without blocking.
+* @param interval_ms milliseconds between samples, at least MIN_TASK_INTERVAL
+* @return true if the task is running
+*/
+bool Sensor::startTask (uint32_t interval_ms)
+{
+	if (task != NULL) {
+	    return (true);
+	}
+	task_interval = interval_ms < MIN_TASK_INTERVAL ? MIN_TASK_INTERVAL : interval_ms;
+	if (xTaskCreatePinnedToCore (sensorTask, "Sensor", TASK_STACK, this, TASK_PRIORITY, &task, TASK_CORE) != pdPASS) {
+	    task = NULL;
+	}
+	return (task != NULL);
+}
+
+/*! @brief change how often the task samples, from its next sample on
+*
+* Between passes a slower rate saves the bus and core 0 the work.
+* @param interval_ms milliseconds between samples, at least MIN_TASK_INTERVAL
+*/
+void Sensor::setTaskInterval (uint32_t interval_ms)
+{
+	task_interval = interval_ms < MIN_TASK_INTERVAL ? MIN_TASK_INTERVAL : interval_ms;
+}
+
+/*! @brief body of the sampling task; reads the Sensor every task_interval forever
+*
+* Without a Sensor that is a restart every so often, in case one is plugged in.
+* @param arg the Sensor instance
+*/
+void Sensor::sensorTask (void *arg)
+{
+	Sensor *_s = (Sensor *)arg;
+	TickType_t _wake = xTaskGetTickCount();
+	for (;;) {
+	    _s->readAzElT();
+	    vTaskDelayUntil (&_wake, pdMS_TO_TICKS(_s->task_interval));
+	}
+}
+
+/*! @brief publish a new sample for readers on either core
+*
+* Seqlock writer: sample_seq is odd while the copy is in progress. Only one writer at a time,
+* which holds because readAzElT() is called either from sensorTask or from loop(), never both.
+*/
+void Sensor::publishSample (float az, float el, int8_t temperature, bool valid)
+{
+	sample_seq++;
+	__sync_synchronize();
+	sample.az = az;
+	sample.el = el;
+	sample.temperature = temperature;
+	sample.time = millis();
+	sample.valid = valid;
+	__sync_synchronize();
+	sample_seq++;
+}
+
+/*! @brief copy out the latest sample, never blocking on the writer
+*
+* Seqlock reader: retry if the writer was active before or during the copy.
+* @param s receives the sample
+*/
+void Sensor::latestSample (SensorSample &s)
+{
+	uint32_t _seq;
+	do {
+	    _seq = sample_seq;
+	    __sync_synchronize();
+	    s = sample;
+	    __sync_synchronize();
+	} while ((_seq & 1) || _seq != sample_seq);
+}
+
+/*! @brief report the BNO055 system status, and ask for a restart if it reports an error
+*
+* readAzElT() catches bad samples as they come; this catches what the BNO055 knows about itself.
+* The status registers are read directly, the driver's getSystemStatus() waits 200 ms after.
+* The web page hears only of changes.
 */
 void Sensor::checkSensor()
 {
-	/* Get the system status values (mostly for debugging purposes) */ 	
-  	if (sensor_found) {
-		  bno->getSystemStatus(&system_status, &self_test_results, &system_error);
-	}
-	if (system_error > 0 || system_status == 1 || !sensor_found) {
-		sensor_found = bno->begin(Adafruit_BNO055::OPERATION_MODE_NDOF);	//< restart Sensor
-		delay(20);
-		if (sensor_found) {
-			webpage->setUserMessage(F("Sensor error... restarting sensor!"));
-		} else {
-			// still didn't find sensor
-			system_status = 1;
-			self_test_results = 0;
-			system_error = 3;
-			calok = false;
-			webpage->setUserMessage(F("Sensor not found!"));
+	if (!sensor_found || recovering()) {
+		system_status = 1;
+		self_test_results = 0;
+		system_error = 3;
+		calok = false;
+		if (last_status != 0xff) {
+			last_status = 0xff;
+			webpage->setUserMessage(sensor_found ? F("Sensor error... restarting sensor!") : F("Sensor not found!"));
 		}
-	} else { // no error
+		return;
+	}
+	/* Get the system status values (mostly for debugging purposes) */ 	
+	i2cbus->lock(I2C_SENSOR);
+	int _status = readReg (REG_SYS_STATUS);
+	int _self_test = readReg (REG_SELFTEST);
+	int _error = readReg (REG_SYS_ERR);
+	i2cbus->unlock(I2C_SENSOR);
+	if (_status < 0 || _self_test < 0 || _error < 0) {
+		return;							//< readAzElT() will see whether it has gone for good
+	}
+	system_status = _status;
+	self_test_results = _self_test;
+	system_error = _error;
+	if (system_error > 0 || system_status == 1) {
+		restart_wanted = true;			//< readAzElT() restarts, while it has the bus
+		metrics->count(C_SENSOR_RESTART);
+	} else if (system_status != last_status) {
+		last_status = system_status;
 		switch (system_status) {
 			case 2:
 			webpage->setUserMessage(F("Initializing Sensor Peripherals"));
@@ -114,7 +365,9 @@ void Sensor::checkSensor()
 int8_t Sensor::getTempC()
 {
 	if (sensor_found) {
-	    return temperature;
+		SensorSample _s;
+		latestSample (_s);
+	    return _s.temperature;
 	}
 	return (-1);
 }
@@ -131,14 +384,16 @@ int8_t Sensor::getTempC()
 */
 bool Sensor::calibrated(uint8_t& sys, uint8_t& gyro, uint8_t& accel, uint8_t& mag)
 {
-	if (!sensor_found) {
+	if (!sensor_found || recovering()) {
 	    return (false);
 	}
 	sys = 0;
 	gyro = 0;
 	accel = 0;
 	mag = 0;;
+	i2cbus->lock(I2C_SENSOR);
 	bno->getCalibration(&sys, &gyro, &accel, &mag);
+	i2cbus->unlock(I2C_SENSOR);
 	return (sys >= 1 && gyro >= 1 && accel >= 1 && mag >= 1);
 }
 
@@ -150,7 +405,9 @@ bool Sensor::calibrated(uint8_t& sys, uint8_t& gyro, uint8_t& accel, uint8_t& ma
 */
 float Sensor::getSensorAz ()
 {
-  return az_sensor;
+  SensorSample _s;
+  latestSample (_s);
+  return _s.az;
 }
 
 /*! @brief  return the current sensor elevation 
@@ -161,68 +418,259 @@ float Sensor::getSensorAz ()
 */
 float Sensor::getSensorEl ()
 {
-  return el_sensor;
+  SensorSample _s;
+  latestSample (_s);
+  return _s.el;
+}
+
+/*! @brief return when the latest az, el and temperature were read
+*
+* @return millis() time of the last Sensor sample
+*/
+uint32_t Sensor::getSampleTime ()
+{
+  SensorSample _s;
+  latestSample (_s);
+  return _s.time;
+}
+
+/*! @brief return az, el and temperature all from the same sample
+*
+* @param az receives the last measured Sensor azimuth
+* @param el receives the last measured Sensor elevation
+* @param temperature receives the last measured temperature, or -1 if there is no Sensor
+*/
+void Sensor::getAzElT (float *az, float *el, int8_t *temperature)
+{
+  SensorSample _s;
+  latestSample (_s);
+  *az = _s.az;
+  *el = _s.el;
+  *temperature = sensor_found ? _s.temperature : -1;
+}
+
+/*! @brief whether the latest sample is fit to steer by: it passed readAzElT()'s health checks, and is recent
+*/
+bool Sensor::valid ()
+{
+  SensorSample _s;
+  latestSample (_s);
+  return (sensor_found && _s.valid && millis() - _s.time < STALE_AGE);
 }
 
 /*! @brief  read the current az and el, corrected for mag decl but not necessarily calibrated.
 
- * N.B. we assume this will only be called if we know the sensor is connected.
  * N.B. Adafruit board:
  *   the short dimension is parallel to the antenna boom,
  *   the populated side of the board faces upwards and
  *   the side with the control signals (SDA, SCL etc) points in the rear direction of the antenna pattern.
  * Note that az/el is a left-hand coordinate system.
- * This is only called repeatedly from loop()
+ * With SENSOR_QUATERNION one 8 byte burst gives the orientation, else the 6 byte Euler angles.
+ * The temperature is read only every SENSOR_TEMP_INTERVAL, the calibration status every CAL_INTERVAL.
+ * Every sample is checked: NaN or out of range BAD_SAMPLES times running, no change at all for
+ * FROZEN_AGE with the BNO055 no longer saying its fusion runs, or system calibration lost for
+ * CAL_LOST_AGE is a fault, and the BNO055 is restarted. A mount standing still can read the same,
+ * Euler angles especially, for as long as it likes, so unchanged readings alone are no fault.
+ * A sample that fails is published as invalid, with the last good az and el, so Gimbal holds.
+ * Without a BNO055, or while it restarts, this runs the restart instead.
+ * This is called repeatedly from sensorTask, or from loop() if the task is not running
  */
 void Sensor::readAzElT ()
 {
-  imu::Vector<3> euler = bno->getVector(Adafruit_BNO055::VECTOR_EULER);
-  az_sensor = fmod (euler.x() + nv->mag_decl + 540, 360);
-  el_sensor = (euler.z());
-  temperature = bno->getTemp();
+  float _az, _el;
+  float _raw[4] = { 0, 0, 0, 0 };
+  bool _bad;
+  uint32_t _now = millis();
+  i2cbus->lock(I2C_SENSOR);
+  if (restart_wanted && !recovering()) {
+    restart_wanted = false;
+    startRecovery (_now);
+  } else if (!sensor_found && !recovering()) {
+    startRecovery (_now);
+  }
+  if (recovering()) {
+    serviceRecovery (_now);
+    i2cbus->unlock(I2C_SENSOR);
+    if (sample.valid) {
+      publishSample (sample.az, sample.el, temperature, false);
+    }
+    return;
+  }
+  uint32_t _t0 = Metrics::start();
+  if (SENSOR_QUATERNION) {
+    imu::Quaternion _q = bno->getQuat();
+    _raw[0] = _q.w();
+    _raw[1] = _q.x();
+    _raw[2] = _q.y();
+    _raw[3] = _q.z();
+    float _n2 = _raw[0] * _raw[0] + _raw[1] * _raw[1] + _raw[2] * _raw[2] + _raw[3] * _raw[3];
+    boomAzEl (_q, &_az, &_el);
+    _bad = !(_n2 > 0.81 && _n2 < 1.21);		//< a unit quaternion; all 0 if the fusion isn't running, or NaN
+  } else {
+    imu::Vector<3> euler = bno->getVector(Adafruit_BNO055::VECTOR_EULER);
+    _raw[0] = euler.x();
+    _raw[1] = euler.y();
+    _raw[2] = euler.z();
+    _az = euler.x() + 180;
+    _el = euler.z();
+    _bad = !(euler.x() >= 0 && euler.x() <= 360 && fabs (_el) <= 180);
+  }
+  _bad = _bad || isnan (_az) || isnan (_el);
+  if (temp_time == 0 || _now - temp_time >= SENSOR_TEMP_INTERVAL) {
+    temperature = bno->getTemp();
+    temp_time = _now ? _now : 1;
+  }
+  if (cal_time == 0 || _now - cal_time >= CAL_INTERVAL) {
+    bno->getCalibration(&sys, &gyro, &accel, &mag);
+    cal_time = _now ? _now : 1;
+    if (sys >= 1) {
+      cal_seen = true;
+      cal_lost = 0;
+    } else if (cal_seen && cal_lost == 0) {
+      cal_lost = _now ? _now : 1;
+    }
+  }
+  metrics->stop(M_SENSOR_READ, _t0);
+
+  //< health
+  if (memcmp (_raw, last_raw, sizeof(_raw)) != 0) {
+    memcpy (last_raw, _raw, sizeof(_raw));
+    last_change = _now;
+  }
+  bad_samples = _bad ? min (bad_samples + 1, 255) : 0;
+  bool _frozen = false;
+  if (_now - last_change >= FROZEN_AGE) {
+    _frozen = readReg (REG_SYS_STATUS) != FUSION_RUNNING;
+    last_change = _now;				//< still, or not, ask again in another FROZEN_AGE
+  }
+  if (_now - fusion_start >= FUSION_WAIT && (bad_samples >= BAD_SAMPLES || _frozen
+        || (cal_lost != 0 && _now - cal_lost >= CAL_LOST_AGE))) {
+    i2cbus->recover(I2C_SENSOR);		//< in case the BNO055 is holding the bus
+    startRecovery (_now);
+    metrics->count(C_SENSOR_RESTART);
+  }
+  i2cbus->unlock(I2C_SENSOR);
+  if (_bad || _frozen || cal_lost != 0 || recovering()) {
+    filter_time = 0;
+    publishSample (sample.az, sample.el, temperature, false);
+    return;
+  }
+
+  _az = fmod (_az + nv->mag_decl + 720, 360);
+  float _dt = (_now - filter_time) / 1000.0;
+  if (filter_time == 0 || _now - filter_time > MAX_FILTER_GAP) {
+    filter_az.x = _az;
+    filter_az.v = 0;
+    filter_el.x = _el;
+    filter_el.v = 0;
+  } else if (_now - filter_time >= MIN_TASK_INTERVAL) {
+    _az = filterAxis (filter_az, _az, _dt, true);
+    _el = filterAxis (filter_el, _el, _dt, false);
+  } else {
+    return;						//< too soon after the last sample to say anything about the rate
+  }
+  filter_time = _now ? _now : 1;
+  publishSample (_az, _el, temperature, true);
+}
+
+/*! @brief direction of the antenna boom from the BNO055 fused orientation
+*
+* The boom is the board's -Y axis; rotating it by q gives east, north and up components.
+* At zenith this stays well conditioned, where the Euler heading and pitch trade off.
+* Matches the Euler path: az is heading + 180, el is pitch.
+* @param q board to earth rotation
+* @param az receives the boom azimuth, degrees east of magnetic north, -180 .. 180
+* @param el receives the boom elevation, degrees
+*/
+void Sensor::boomAzEl (const imu::Quaternion &q, float *az, float *el)
+{
+  float _e = 2 * (q.w() * q.z() - q.x() * q.y());
+  float _n = 2 * (q.x() * q.x() + q.z() * q.z()) - 1;
+  float _u = -2 * (q.y() * q.z() + q.w() * q.x());
+  *az = atan2f (_e, _n) * 180 / M_PI;
+  *el = atan2f (_u, hypotf (_e, _n)) * 180 / M_PI;
+}
+
+/*! @brief one alpha-beta filter step
+*
+* Predict from the last rate, then correct both angle and rate by the residual.
+* reference: https://en.wikipedia.org/wiki/Alpha_beta_filter
+* @param f this axis's filter state
+* @param angle new measurement, degrees
+* @param dt seconds since the last measurement
+* @param wraps true for azimuth, which is taken modulo 360
+* @return filtered angle
+*/
+float Sensor::filterAxis (AxisFilter &f, float angle, float dt, bool wraps)
+{
+  float _x = f.x + f.v * dt;
+  float _r = angle - _x;
+  if (wraps) {
+    _r = fmod (_r + 540, 360) - 180;
+  }
+  _x += SENSOR_ALPHA * _r;
+  f.v += SENSOR_BETA * _r / dt;
+  if (wraps) {
+    _x = fmod (_x + 360, 360);
+  }
+  f.x = _x;
+  return (_x);
 }
 
 /*! @brief send latest values to web page
 *
-* @param client a reference to the calling WiFi client
+* @param r the response to add our NAME=VALUE lines to
 * N.B. labels must match ids in web page
 */
 
-void Sensor::sendNewValues (WiFiClient client)
+void Sensor::sendNewValues (Response &r)
 {
+	SensorSample _s;
+	latestSample (_s);
+	r.add ("SS_Az", _s.az, 1);
+	r.add ("SS_El", _s.el, 1);
+
+	r.add ("SS_Temp", (int32_t)_s.temperature);
+	r.add ("SS_STSStatus", 0x08 & self_test_results?"pass+":"fail!");
+	r.add ("SS_STGStatus", 0x04 & self_test_results?"pass+":"fail!");
+	r.add ("SS_STMStatus", 0x02 & self_test_results?"pass+":"fail!");
+	r.add ("SS_STAStatus", 0x01 & self_test_results?"pass+":"fail!");
+	r.add ("SS_SCal", (int32_t)sys);
+	r.add ("SS_GCal", (int32_t)gyro);
+	r.add ("SS_MCal", (int32_t)mag);
+	r.add ("SS_ACal", (int32_t)accel);
+	//< readAzElT() keeps looking for a missing Sensor, nothing to do here
 	if (!sensor_found) {
-	    client.println (F("SS_Status=Not found!"));
-	    client.println (F("SS_Save=false"));
-	    // restart Sensor
-		sensor_found = bno->begin(Adafruit_BNO055::OPERATION_MODE_NDOF);
-		delay(25);
-		if (sensor_found) {
-			webpage->setUserMessage(F("Sensor error... restarting sensor!"));
-		}
+	    r.add ("SS_Status", "Not found!");
+	} else if (recovering()) {
+	    r.add ("SS_Status", "Restarting!");
+	} else if (!valid()) {
+	    r.add ("SS_Status", "Bad samples!");
+	} else {
+	    r.add ("SS_Status", calok ? "Ok+" : "Uncalibrated!");
 	}
+	r.add ("SS_Save", (calok && sys == 3 && gyro == 3 && accel == 3 && mag == 3) ? "true" : "false");
+}
 
-	client.print (F("SS_Az=")); client.println (az_sensor, 1);
-	client.print (F("SS_El=")); client.println (el_sensor, 1);
-
-	client.print (F("SS_Temp=")); client.println (temperature);
-	client.print (F("SS_STSStatus=")); client.println (0x08 & self_test_results?"pass+":"fail!");
-	client.print (F("SS_STGStatus=")); client.println (0x04 & self_test_results?"pass+":"fail!");
-	client.print (F("SS_STMStatus=")); client.println (0x02 & self_test_results?"pass+":"fail!");
-	client.print (F("SS_STAStatus=")); client.println (0x01 & self_test_results?"pass+":"fail!");
-	client.print (F("SS_SCal=")); client.println (sys);
-	client.print (F("SS_GCal=")); client.println (gyro);
-	client.print (F("SS_MCal=")); client.println (mag);
-	client.print (F("SS_ACal=")); client.println (accel);
-	if (calok) {
-	    client.println (F("SS_Status=Ok+"));
-	} else {
-	    client.println (F("SS_Status=Uncalibrated!"));
+/*! @brief fill in the Sensor part of a status record
+*
+* @param s the record being built by buildStatus()
+*/
+void Sensor::fillStatus (StatusRecord &s)
+{
+	SensorSample _s;
+	latestSample (_s);
+	s.sample_time = _s.time;
+	s.az = _s.az;
+	s.el = _s.el;
+	s.temperature = sensor_found ? _s.temperature : -1;
+	s.cal = (sys & 3) << 6 | (gyro & 3) << 4 | (accel & 3) << 2 | (mag & 3);
+	s.self_test = self_test_results;
+	if (valid()) {
+	    s.flags |= ST_SENSOR_FOUND;
 	}
-	client.print (F("SS_Save="));
 	if (calok && sys == 3 && gyro == 3 && accel == 3 && mag == 3) {
-	    client.println (F("true"));
-	} else {
-	    client.println (F("false"));
+	    s.flags |= ST_SENSOR_CALOK;
 	}
 }
 
@@ -234,6 +682,13 @@ void Sensor::sendNewValues (WiFiClient client)
 */
 bool Sensor::overrideValue (char *name, char *value)
 {
-
+	if (strcmp (name, "SS_Save") == 0) {
+	    if (saveCalibration()) {
+		    webpage->setUserMessage(F("Saved Sensor calibration+"));
+	    } else {
+		    webpage->setUserMessage(F("Sensor not fully calibrated, nothing saved!"));
+	    }
+	    return (true);
+	}
 	return (false);
 }
@@ -34,14 +34,49 @@
 #include <WiFi.h>
 #include <Adafruit_Sensor.h>
 #include <Adafruit_BNO055.h>
+#include "Response.h"
+#include "Status.h"
+#include "I2CBus.h"
 
 #define MAG_DECLINATION 13.23	///< default magnetic declination; should be set thru Webpage
+#define SENSOR_QUATERNION true	///< read the fused quaternion, no gimbal lock near zenith; false reads Euler angles
+#define SENSOR_ALPHA 0.8		///< alpha-beta filter position gain; 1 with SENSOR_BETA 0 turns the filter off
+#define SENSOR_BETA 0.2		///< alpha-beta filter rate gain
+#define SENSOR_TEMP_INTERVAL 5000	///< milliseconds between temperature reads, it changes slowly
 
 class Sensor {
 
     private:
-	int8_t temperature;
-	float az_sensor, el_sensor;
+	//< one orientation sample, handed from the reader (loop() or sensorTask) to everyone else
+	typedef struct {
+	    float az, el;				// corrected az and el, degrees
+	    int8_t temperature;			// degrees C
+	    uint32_t time;				// millis() when sampled
+	    bool valid;					// passed the health checks; if not, az and el are the last good ones
+	} SensorSample;
+	SensorSample sample;			//< latest sample; only touch thru publishSample() and latestSample()
+	volatile uint32_t sample_seq;	//< seqlock count, odd while sample is being written
+	TaskHandle_t task;				//< sampling task, NULL when reading from loop()
+	uint32_t task_interval;			//< ms between samples in sensorTask
+	static const uint8_t TASK_CORE = 0;			// loop() runs on core 1, so sample on the idle core
+	static const uint16_t TASK_STACK = 4096;	// bytes
+	static const uint8_t TASK_PRIORITY = 2;		// above idle and loop()
+	static const uint32_t MIN_TASK_INTERVAL = 10;	// BNO055 fusion output rate is 100 Hz
+	static void sensorTask (void *arg);
+	//< alpha-beta tracker for one axis, smoothing noise without lagging a steady slew
+	typedef struct {
+	    float x;					// filtered angle, degrees
+	    float v;					// rate, degrees per second
+	} AxisFilter;
+	AxisFilter filter_az, filter_el;
+	uint32_t filter_time;			//< millis() of the last filter update, 0 to restart the filter
+	static const uint16_t MAX_FILTER_GAP = 500;	// ms without a sample before the filter restarts
+	static float filterAxis (AxisFilter &f, float angle, float dt, bool wraps);
+	int8_t temperature;				//< latest temperature reading
+	uint32_t temp_time;				//< millis() of the latest temperature reading
+	static void boomAzEl (const imu::Quaternion &q, float *az, float *el);
+	void publishSample (float az, float el, int8_t temperature, bool valid);
+	void latestSample (SensorSample &s);
 	//< bit, status for debugging and display
 	/* Self Test Results: 1 = test passed, 0 = test failed
     Bit 0 = Accelerometer self test
@@ -56,8 +91,51 @@ class Sensor {
 	const bool DEBUG_SENSOR = false;
 	bool sensor_found;		//< whether sensor is connected
 	bool calibrated(uint8_t& sys, uint8_t& gyro, uint8_t& accel, uint8_t& mag);
+	bool startSensor();
+	//< health of every sample, checked by readAzElT(); a fault restarts the BNO055 without blocking,
+	//< and Gimbal holds still until the samples are good again
+	static const uint16_t STALE_AGE = 500;		// ms after which the latest sample is too old to steer by
+	static const uint16_t FROZEN_AGE = 5000;	// ms of a bit for bit unchanged orientation before asking if the fusion still runs
+	static const uint8_t BAD_SAMPLES = 3;		// NaN or out of range samples in a row that make a fault
+	static const uint16_t CAL_INTERVAL = 500;	// ms between calibration status reads
+	static const uint16_t CAL_LOST_AGE = 5000;	// ms without system calibration, once it had some, that make a fault
+	static const uint16_t RESET_WAIT = 650;		// ms the BNO055 takes to boot after a reset
+	static const uint16_t PROBE_PERIOD = 50;	// ms between chip id reads while it boots
+	static const uint16_t RECOVER_TIMEOUT = 2000;	// ms without an answer before resetting again
+	static const uint16_t MODE_WAIT = 20;		// ms from CONFIG to the first NDOF output
+	static const uint16_t FUSION_WAIT = 1000;	// ms after a restart before bad samples make a fault
+	enum { H_RUNNING, H_RESETTING, H_STARTING } health;	// recovery state machine, run by readAzElT()
+	uint32_t health_wait;			//< the recovery does nothing until this millis() time
+	uint32_t health_start;			//< millis() of the latest reset
+	uint32_t fusion_start;			//< millis() the fusion was last (re)started
+	uint8_t bad_samples;			//< NaN or out of range samples in a row
+	float last_raw[4];				//< orientation as read, to see it change
+	uint32_t last_change;			//< millis() it last changed
+	bool cal_seen;					//< system calibration has been at least 1 since the fusion started
+	uint32_t cal_time;				//< millis() of the latest calibration status read
+	uint32_t cal_lost;				//< millis() system calibration fell to 0 after cal_seen, 0 if it hasn't
+	volatile bool restart_wanted;	//< checkSensor() found an error, readAzElT() is to restart
+	bool begun;						//< the driver's begin() succeeded, so it knows its own mode
+	uint8_t last_status;			//< system_status last reported to the web page
+	void startRecovery (uint32_t now);
+	void serviceRecovery (uint32_t now);
+	bool writeReg (uint8_t reg, const uint8_t *data, uint8_t n);
+	int readReg (uint8_t reg);
 	enum {
 	    I2CADDR = 0x28,		// I2C bus address of BNO055
+	    CHIP_ID = 0xA0,		// what REG_CHIP_ID reads
+	    FUSION_RUNNING = 5,	// what REG_SYS_STATUS reads in NDOF
+	    //< registers, page 0
+	    REG_CHIP_ID = 0x00,
+	    REG_PAGE_ID = 0x07,
+	    REG_SELFTEST = 0x36,
+	    REG_SYS_STATUS = 0x39,
+	    REG_SYS_ERR = 0x3A,
+	    REG_OPR_MODE = 0x3D,
+	    REG_PWR_MODE = 0x3E,
+	    REG_SYS_TRIGGER = 0x3F,
+	    REG_OFFSETS = 0x55,	// ss_offsets, thru the mag radius; written in CONFIG mode only
+	    RST_SYS = 0x20,		// REG_SYS_TRIGGER bit that reboots the BNO055
 	};
 
     public:
@@ -67,8 +145,18 @@ class Sensor {
 	int8_t getTempC();
 	float getSensorAz ();
 	float getSensorEl ();
+	uint32_t getSampleTime ();
+	void getAzElT (float *az, float *el, int8_t *temperature);
 	void readAzElT ();
-	void sendNewValues (WiFiClient client);
+	bool startTask (uint32_t interval_ms);
+	bool taskRunning() { return (task != NULL); };
+	void setTaskInterval (uint32_t interval_ms);
+	uint32_t taskInterval() { return (task_interval); };
+	bool valid ();
+	bool recovering() { return (health != H_RUNNING); };
+	bool saveCalibration();
+	void sendNewValues (Response &r);
+	void fillStatus (StatusRecord &s);
 	bool connected() { return sensor_found; };
 	bool overrideValue (char *name, char *value);
 };
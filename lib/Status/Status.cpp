@@ -0,0 +1,54 @@
+/*!
+* @brief Fixed-layout binary status record, for /status.bin and the Easycomm SB command
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <time.h>
+#include "Status.h"
+#include "Sensor.h"
+#include "Gimbal.h"
+#include "Easycomm.h"
+#include "Tracker.h"
+#include "Scheduler.h"
+
+/*! @brief ask each subsystem to fill in its part of a status record
+*
+* @param s receives the current status
+*/
+void buildStatus (StatusRecord &s)
+{
+    memset (&s, 0, sizeof(s));
+    s.magic = STATUS_MAGIC;
+    s.version = STATUS_VERSION;
+    s.size = sizeof(s);
+    s.uptime = millis();
+    time_t _t = time (NULL);
+    s.unix_time = _t > 1000000000 ? (uint32_t)_t : 0;
+    sensor->fillStatus (s);
+    gimbal->fillStatus (s);
+    if (tracker->isActive()) {
+        s.flags |= ST_TRACKER_ACTIVE;
+    }
+    s.commands_dropped = easycomm->droppedCommands();
+    for (uint8_t i = 0; i < scheduler->count(); i++) {
+        const char *_name;
+        uint32_t _runs, _overruns, _run_us, _max_us;
+        if (scheduler->stats (i, &_name, &_runs, &_overruns, &_run_us, &_max_us)) {
+            s.overruns += _overruns;
+        }
+    }
+}
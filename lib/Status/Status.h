@@ -0,0 +1,74 @@
+/*!
+* @brief Fixed-layout binary status record, for /status.bin, the Easycomm SB command and the Discovery beacon
+*
+* Little-endian, packed, no padding. Readers should check magic and version, and may use size
+* to skip fields added at the end by later versions.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _STATUS_H
+#define _STATUS_H
+
+#include <Arduino.h>
+
+#define STATUS_MAGIC    0x5253		///< "SR" as the first two bytes
+#define STATUS_VERSION  1			///< bump when fields change; only ever append
+
+//< StatusRecord.flags bits
+enum {
+    ST_SENSOR_FOUND = 0x01,			// BNO055 answering, with samples fit to steer by
+    ST_SENSOR_CALOK = 0x02,			// BNO055 fully calibrated
+    ST_GIMBAL_FOUND = 0x04,			// PCA9685 answering
+    ST_GIMBAL_CALOK = 0x08,			// Gimbal servo calibration done
+    ST_CALIBRATING = 0x10,			// Gimbal calibration in progress
+    ST_CLOSED_LOOP = 0x20,			// Gimbal tracking closed-loop
+    ST_TRACKER_ACTIVE = 0x40,		// onboard Tracker is pointing
+    ST_GIMBAL_FAULT = 0x80,			// PCA9685 outputs disabled by limit switch
+};
+
+//< StatusRecord.limits bits, motor n at bits 2n (at min) and 2n+1 (at max)
+enum {
+    ST_MOT1_ATMIN = 0x01,
+    ST_MOT1_ATMAX = 0x02,
+    ST_MOT2_ATMIN = 0x04,
+    ST_MOT2_ATMAX = 0x08,
+};
+
+typedef struct __attribute__((packed)) {
+    uint16_t magic;					// STATUS_MAGIC
+    uint8_t version;				// STATUS_VERSION
+    uint8_t size;					// sizeof(StatusRecord)
+    uint32_t uptime;				// millis()
+    uint32_t unix_time;				// seconds since 1970, 0 if the clock is not set
+    uint32_t sample_time;			// millis() of the Sensor sample below
+    float az, el;					// measured, degrees
+    float target_az, target_el;		// latest Gimbal target, degrees
+    uint16_t pos[2];				// last commanded motor pulse, usec
+    uint16_t min[2], max[2];		// motor pulse limits, usec
+    int8_t temperature;				// degrees C
+    uint8_t cal;					// BNO055 calibration 0..3: sys << 6 | gyro << 4 | accel << 2 | mag
+    uint8_t self_test;				// BNO055 self test bits, 1 = pass
+    uint8_t flags;					// ST_ flags
+    uint8_t limits;					// ST_MOT flags
+    uint8_t reserved[3];
+    uint32_t commands_dropped;		// Easycomm commands lost to a full queue
+    uint32_t overruns;				// Scheduler jobs that finished past their deadline
+} StatusRecord;
+
+void buildStatus (StatusRecord &s);
+
+#endif // _STATUS_H
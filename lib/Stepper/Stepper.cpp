@@ -0,0 +1,240 @@
+/*!
+* @brief Class to drive a stepper az axis with step pulses timed by the RMT peripheral
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Stepper.h"
+#include "Metrics.h"
+
+#if GIMBAL_AZ_STEPPER					//< otherwise the RMT channel and pins are left alone
+
+/*! @brief class constructor; claims the RMT channel and pins, holds the current position as step 0
+*/
+Stepper::Stepper()
+{
+	rmt_config_t _c;
+	memset (&_c, 0, sizeof(_c));
+	_c.rmt_mode = RMT_MODE_TX;
+	_c.channel = CHANNEL;
+	_c.gpio_num = (gpio_num_t)STEPPER_STEP_PIN;
+	_c.mem_block_num = 1;
+	_c.clk_div = CLK_DIV;
+	_c.tx_config.loop_en = false;
+	_c.tx_config.carrier_en = false;
+	_c.tx_config.idle_output_en = true;
+	_c.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+	rmt_config (&_c);
+	rmt_driver_install (CHANNEL, 0, 0);
+
+	pinMode (STEPPER_DIR_PIN, OUTPUT);
+	digitalWrite (STEPPER_DIR_PIN, LOW);
+	dir = -1;
+	if (STEPPER_ENABLE_PIN >= 0) {
+	    pinMode (STEPPER_ENABLE_PIN, OUTPUT);
+	    digitalWrite (STEPPER_ENABLE_PIN, LOW);
+	}
+	if (STEPPER_HOME_PIN >= 0) {
+	    pinMode (STEPPER_HOME_PIN, INPUT_PULLUP);
+	}
+	pos = 0;
+	target = 0;
+	v = 0;
+	phase = 0;
+	gap_carry = 0;
+	last_plan = micros();
+	home_phase = HOME_IDLE;
+	home_start = 0;
+	is_homed = false;
+}
+
+/*! @brief whether the home switch is closed
+*/
+bool Stepper::atHome()
+{
+	return (STEPPER_HOME_PIN >= 0 && digitalRead (STEPPER_HOME_PIN) == LOW);
+}
+
+/*! @brief find the home switch: a fast pass up to it, back off, then a slow pass to set step 0 there
+*
+* Runs from service(). Without a switch the current position is taken as home.
+*/
+void Stepper::startHoming()
+{
+	if (STEPPER_HOME_PIN < 0) {
+	    pos = 0;
+	    target = 0;
+	    is_homed = true;
+	    return;
+	}
+	is_homed = false;
+	home_start = pos;
+	home_phase = HOME_FAST;
+}
+
+/*! @brief plan and send the steps until about the next call; call every few tens of ms
+*
+* The plan covers the time since the last one, so the average rate is right however late
+* loop() calls. Nothing is planned while RMT is still sending the previous plan.
+*/
+void Stepper::service()
+{
+	if (rmt_wait_tx_done (CHANNEL, 0) != ESP_OK) {
+	    return;
+	}
+	uint32_t _now = micros();
+	if (_now == last_plan) {
+	    return;
+	}
+	float _dt = (_now - last_plan) / 1e6;
+	last_plan = _now;
+	if (_dt > MAX_DT) {
+	    _dt = MAX_DT;
+	}
+
+	//< the speed wanted now: homing creeps at a fixed speed, otherwise the fastest that can still stop on target
+	float _v_want;
+	float _to_go = target - pos;
+	switch (home_phase) {
+	case HOME_FAST:
+	    if (atHome()) {
+		    pos = 0;
+		    target = -HOME_BACKOFF * Traits::STEPS_PER_DEG;
+		    home_phase = HOME_BACK;
+	    } else if (pos - home_start > HOME_TRAVEL * Traits::STEPS_PER_DEG) {
+		    target = pos;
+		    home_phase = HOME_IDLE;		//< no switch: is_homed stays false
+		    metrics->count(C_STEPPER_NO_HOME);
+	    }
+	    _v_want = Traits::HOME_SPEED;
+	    break;
+	case HOME_SLOW_PASS:
+	    if (atHome()) {
+		    pos = 0;
+		    target = 0;
+		    v = 0;
+		    home_phase = HOME_IDLE;
+		    is_homed = true;
+		    _v_want = 0;
+	    } else {
+		    _v_want = Traits::HOME_SPEED / HOME_SLOW;
+	    }
+	    break;
+	case HOME_BACK:
+	    if (fabs (_to_go) < 1 && v == 0) {
+		    home_phase = HOME_SLOW_PASS;
+	    }
+	    //< fall through, a positioning move
+	default:
+	    {
+		//< fastest v such that, after this plan covers (v + the current speed) / 2 * dt, v can still brake to the target
+		float _sign = _to_go < 0 ? -1 : 1;
+		float _room = fabs (_to_go) - _sign * v * _dt / 2;
+		float _h = Traits::ACCEL * _dt / 2;
+		_v_want = _room > 0 ? sqrtf (_h * _h + 2 * Traits::ACCEL * _room) - _h : 0;
+		if (_v_want > Traits::MAX_SPEED) {
+		    _v_want = Traits::MAX_SPEED;
+		}
+		if (fabs (_to_go) < 1) {
+		    _v_want = 0;
+		}
+		_v_want *= _sign;
+	    }
+	    break;
+	}
+
+	uint16_t _n = plan (_dt, _v_want);
+	if (_n > 0) {
+	    rmt_write_items (CHANNEL, items, _n, false);
+	}
+}
+
+/*! @brief fill the idle RMT buffer with the steps of the next dt, speed ramping linearly to v_want
+*
+* The speed moves towards v_want by at most STEPPER_ACCEL * dt. It never changes sign within a
+* plan: it stops at the end of one and turns at the start of the next, so DIR is steady while
+* pulses go out.
+* @param dt seconds to plan
+* @param v_want steps per second wanted, signed
+* @return number of RMT items filled
+*/
+uint16_t Stepper::plan (float dt, float v_want)
+{
+	float _dv = constrain (v_want - v, -Traits::ACCEL * dt, Traits::ACCEL * dt);
+	float _v1 = v + _dv;
+	if ((v > 0 && _v1 < 0) || (v < 0 && _v1 > 0)) {
+	    _v1 = 0;
+	}
+	float _v0 = v;
+	v = _v1;
+	int8_t _dir = (_v0 + _v1 > 0) ? 1 : -1;
+	float _s0 = fabs (_v0), _s1 = fabs (_v1);
+	float _steps = (_s0 + _s1) / 2 * dt;		//< covered this plan
+	if (_steps + phase < 1) {
+	    phase += _steps;
+	    gap_carry = (_s0 == 0 && _s1 == 0) ? 0 : gap_carry + dt * 1e6;	//< at rest the next step starts afresh
+	    return (0);
+	}
+	if (_dir != dir) {
+	    dir = _dir;
+	    phase = 0;							//< a part step the other way is not a part step this way
+	    digitalWrite (STEPPER_DIR_PIN, _dir > 0 ? HIGH : LOW);
+	}
+
+	//< time of each step from s(t) = s0 t + a t^2 / 2
+	float _a = (_s1 - _s0) / dt;
+	rmt_item32_t *_ip = items;
+	uint16_t _n = 0;
+	uint32_t _t_prev = 0;
+	float _d = 1 - phase;
+	while (_d <= _steps + 1e-6 && _n < MAX_ITEMS - 2) {
+	    //< solved as 2d / (s0 + sqrt(s0^2 + 2ad)), which holds for a = 0 and keeps float precision when a is small
+	    float _disc = _s0 * _s0 + 2 * _a * _d;
+	    float _t = _disc > 0 ? 2 * _d / (_s0 + sqrtf (_disc)) : dt;
+	    uint32_t _t_us = _t * 1e6;
+	    uint32_t _gap = gap_carry + _t_us - _t_prev;
+	    gap_carry = 0;
+	    if (_gap < PULSE_US) {
+		    _gap = PULSE_US;
+	    }
+	    //< low for the gap, then the pulse; a long gap takes extra items that stay low
+	    while (_gap > MAX_GAP && _n < MAX_ITEMS - 2) {
+		    _ip[_n].level0 = 0;
+		    _ip[_n].duration0 = MAX_GAP / 2;
+		    _ip[_n].level1 = 0;
+		    _ip[_n].duration1 = MAX_GAP / 2;
+		    _gap -= 2 * (MAX_GAP / 2);
+		    _n++;
+	    }
+	    _ip[_n].level0 = 0;
+	    _ip[_n].duration0 = _gap > PULSE_US ? _gap - PULSE_US : 1;	//< 0 would end the items
+	    _ip[_n].level1 = 1;
+	    _ip[_n].duration1 = PULSE_US;
+	    _n++;
+	    pos += _dir;
+	    _t_prev = _t_us;
+	    _d += 1;
+	}
+	phase = _steps - (_d - 1);				//< _d - 1 is where the last step sent fell
+	if (phase < 0) {
+	    phase = 0;
+	}
+	gap_carry = dt * 1e6 - _t_prev;
+	_ip[_n].val = 0;							//< end marker
+	return (_n + 1);
+}
+
+#endif // GIMBAL_AZ_STEPPER
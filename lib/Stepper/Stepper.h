@@ -0,0 +1,76 @@
+/*!
+* @brief Class to drive a stepper az axis with step pulses timed by the RMT peripheral
+*
+* Each service() plans the steps until the next one with a trapezoidal profile, ramping the speed
+* by at most STEPPER_ACCEL and braking in time to stop on the target, and hands their timing to
+* RMT, so no step is bit-banged and the pulse train keeps going while loop() is busy. Position is
+* the count of steps sent, unbounded, so the axis can turn through 360 degrees as often as needed.
+* A home switch, if fitted, sets step 0.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _STEPPER_H
+#define _STEPPER_H
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include "Axis.h"
+
+class Stepper {
+
+    public:
+	Stepper();
+	void service();
+	void setTarget (float steps) { target = steps; };
+	float position() { return (pos); };
+	float speed() { return (v); };
+	void startHoming();
+	bool homing() { return (home_phase != HOME_IDLE); };
+	bool homed() { return (is_homed); };
+
+    private:
+	typedef Actuator<STEPPER> Traits;
+	static const rmt_channel_t CHANNEL = RMT_CHANNEL_0;
+	static const uint8_t CLK_DIV = 80;				// RMT ticks of 1 usec
+	static const uint16_t PULSE_US = 5;				// STEP high time; most drivers need 1 to 3
+	static const uint16_t MAX_GAP = 32767;			// longest RMT item half, usec
+	static constexpr float MAX_DT = 0.1;			// seconds planned at most per service()
+	static const uint16_t MAX_ITEMS = 256;			// RMT items per plan
+	static_assert (Traits::MAX_SPEED * MAX_DT + MAX_DT * 1e6 / MAX_GAP + 2 < MAX_ITEMS,
+			"STEPPER_MAX_SPEED needs more than MAX_ITEMS steps per plan");
+	static_assert (Traits::MAX_SPEED < 0.5e6 / PULSE_US, "STEPPER_MAX_SPEED leaves no time between pulses");
+	static constexpr float HOME_TRAVEL = 370;		// degrees to look for the switch before giving up
+	static constexpr float HOME_BACKOFF = 5;		// degrees to back off the switch for the slow pass
+	static const uint8_t HOME_SLOW = 5;				// slow pass speed divisor
+	rmt_item32_t items[MAX_ITEMS];					//< the driver reads these while sending, so only plan when it is done
+	int32_t pos;									//< steps sent so far, + drives az up if wired as calibrated
+	float target;									//< step to stop at
+	float v;										//< steps per second at the end of the last plan, signed
+	int8_t dir;										//< DIR as last set, +1 or -1
+	float phase;									//< fraction of a step covered since the last one
+	uint32_t gap_carry;								//< usec from the last step sent to the end of its plan
+	uint32_t last_plan;								//< micros() of the last plan
+	enum { HOME_IDLE, HOME_FAST, HOME_BACK, HOME_SLOW_PASS } home_phase;
+	int32_t home_start;								//< pos when the fast pass began
+	bool is_homed;
+	bool atHome();
+	uint16_t plan (float dt, float v_want);
+};
+
+extern Stepper *stepper;
+
+#endif // _STEPPER_H
@@ -0,0 +1,149 @@
+/*!
+* @brief Class to keep a history of pointing at the control-loop rate, for pass post-mortems
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Telemetry.h"
+#include "Sensor.h"
+#include "Gimbal.h"
+#include "Status.h"
+#include "Webpage.h"
+
+static TelemetryRecord ring[2048];		//< static arena, no heap; size must match RING_SIZE
+
+/*! @brief class constructor
+ */
+Telemetry::Telemetry()
+{
+	static_assert (sizeof(ring)/sizeof(ring[0]) == RING_SIZE, "ring size");
+	head = 0;
+	prev_faults = 0;
+	arm();
+}
+
+/*! @brief start recording again after a freeze
+ */
+void Telemetry::arm ()
+{
+	frozen = false;
+	frozen_at = 0;
+	freeze_in = -1;
+}
+
+/*! @brief add one record for the current control-loop tick
+*
+* Call right after Gimbal::track(). Does nothing while frozen.
+*/
+void Telemetry::record ()
+{
+	if (frozen) {
+	    return;
+	}
+	StatusRecord _s;
+	memset (&_s, 0, sizeof(_s));
+	sensor->fillStatus (_s);
+	gimbal->fillStatus (_s);
+
+	TelemetryRecord *_rp = &ring[head % RING_SIZE];
+	_rp->time = millis();
+	_rp->target_az = (uint16_t)(fmod (_s.target_az + 360, 360) * 100);
+	_rp->target_el = (int16_t)(_s.target_el * 100);
+	_rp->az = (uint16_t)(fmod (_s.az + 360, 360) * 100);
+	_rp->el = (int16_t)(_s.el * 100);
+	_rp->pos[0] = _s.pos[0];
+	_rp->pos[1] = _s.pos[1];
+	float _az = _s.az, _target_az = _s.target_az;		// azDist() wants references, not packed fields
+	_rp->err_az = (int16_t)(Gimbal::azDist (_az, _target_az) * 100);
+	_rp->err_el = (int16_t)((_s.target_el - _s.el) * 100);
+	_rp->flags = _s.limits & 0x0f;
+	if (_s.flags & ST_GIMBAL_FAULT) {
+	    _rp->flags |= TM_GIMBAL_FAULT;
+	}
+	if (_s.flags & ST_CALIBRATING) {
+	    _rp->flags |= TM_CALIBRATING;
+	}
+	if (_s.flags & ST_CLOSED_LOOP) {
+	    _rp->flags |= TM_CLOSED_LOOP;
+	}
+	if (!(_s.flags & ST_SENSOR_FOUND)) {
+	    _rp->flags |= TM_NO_SENSOR;
+	}
+	head++;
+
+	//< a new limit, fault or lost sensor starts the countdown to freezing
+	uint8_t _faults = _rp->flags & (0x0f | TM_GIMBAL_FAULT | TM_NO_SENSOR);
+	if (TELEMETRY_FREEZE_ON_FAULT && freeze_in < 0 && (_faults & ~prev_faults)) {
+	    freeze_in = POST_FAULT;
+	    frozen_at = _rp->time;
+	}
+	prev_faults = _faults;
+	if (freeze_in >= 0 && freeze_in-- == 0) {
+	    frozen = true;
+	    webpage->setUserMessage (F("Telemetry frozen after fault, download /telemetry.bin!"));
+	}
+}
+
+/*! @brief copy out records by sequence number
+*
+* Records older than first() have been overwritten; asking for them starts at first().
+* @param from sequence number of the first record wanted
+* @param out receives up to n records
+* @param n room at out
+* @return records copied
+*/
+uint16_t Telemetry::copy (uint32_t from, TelemetryRecord *out, uint16_t n)
+{
+	if (from < first()) {
+	    from = first();
+	}
+	uint16_t _n = 0;
+	while (_n < n && from < head) {
+	    out[_n++] = ring[from++ % RING_SIZE];
+	}
+	return (_n);
+}
+
+/*! @brief fill in the header for a download
+*
+* @param h receives the header
+* @param count how many records will follow
+*/
+void Telemetry::header (TelemetryHeader &h, uint32_t count)
+{
+	h.magic = TELEMETRY_MAGIC;
+	h.version = TELEMETRY_VERSION;
+	h.record_size = sizeof(TelemetryRecord);
+	h.count = count;
+	h.now = millis();
+	h.frozen_at = frozen ? frozen_at : 0;
+}
+
+/*! @brief process name = value pair
+*
+* @param name the web page id where value was entered
+* @param value a value to operate on, if needed
+* @return true if Telemetry handles this 'name'
+*/
+bool Telemetry::overrideValue (char *name, char *value)
+{
+	if (strcmp (name, "TM_Arm") == 0) {
+	    arm();
+	    webpage->setUserMessage (F("Telemetry recording+"));
+	    return (true);
+	}
+	return (false);
+}
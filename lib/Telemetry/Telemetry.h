@@ -0,0 +1,88 @@
+/*!
+* @brief Class to keep a history of pointing at the control-loop rate, for pass post-mortems
+*
+* Records live in a fixed static ring, oldest overwritten first. Optionally the ring freezes
+* a little after a fault so the lead-up survives until someone downloads it.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+#include <Arduino.h>
+
+#define TELEMETRY_FREEZE_ON_FAULT true	///< stop recording shortly after a fault until rearmed (TM_Arm)
+
+#define TELEMETRY_MAGIC    0x4d54		///< "TM" as the first two bytes of a download
+#define TELEMETRY_VERSION  1
+
+//< TelemetryRecord.flags bits; the low 4 are StatusRecord.limits
+enum {
+    TM_GIMBAL_FAULT = 0x10,				// PCA9685 outputs disabled by limit switch
+    TM_CALIBRATING = 0x20,				// Gimbal calibration in progress
+    TM_CLOSED_LOOP = 0x40,				// Gimbal tracking closed-loop
+    TM_NO_SENSOR = 0x80,				// BNO055 not answering, or its samples flagged invalid
+};
+
+//< one control-loop tick; angles in 1/100 degree
+typedef struct __attribute__((packed)) {
+    uint32_t time;						// millis()
+    uint16_t target_az;					// 0..35999
+    int16_t target_el;
+    uint16_t az;						// measured
+    int16_t el;
+    uint16_t pos[2];					// commanded motor pulses, usec
+    int16_t err_az, err_el;				// target - measured, az the short way round
+    uint8_t flags;						// TM_ and limit bits
+    uint8_t reserved;
+} TelemetryRecord;
+
+//< start of a download, followed by count records oldest first
+typedef struct __attribute__((packed)) {
+    uint16_t magic;						// TELEMETRY_MAGIC
+    uint8_t version;					// TELEMETRY_VERSION
+    uint8_t record_size;				// sizeof(TelemetryRecord)
+    uint32_t count;						// records that follow
+    uint32_t now;						// millis() when the download started
+    uint32_t frozen_at;					// millis() of the fault that froze the ring, 0 if recording
+} TelemetryHeader;
+
+class Telemetry {
+
+    private:
+	static const uint16_t RING_SIZE = 2048;		// records; 100 s at the 50 ms control rate
+	static const uint16_t POST_FAULT = 200;		// records kept after a fault before freezing
+	uint32_t head;						//< sequence number of the next record
+	bool frozen;
+	uint32_t frozen_at;
+	int32_t freeze_in;					//< records until freezing, -1 if no fault pending
+	uint8_t prev_faults;				//< fault flags at the previous record
+
+    public:
+	Telemetry();
+	void record ();
+	void arm ();
+	uint32_t first() { return (head > RING_SIZE ? head - RING_SIZE : 0); };
+	uint32_t last() { return (head); };
+	uint16_t copy (uint32_t from, TelemetryRecord *out, uint16_t n);
+	void header (TelemetryHeader &h, uint32_t count);
+	bool overrideValue (char *name, char *value);
+};
+
+extern Telemetry *telemetry;
+
+#endif // _TELEMETRY_H
@@ -0,0 +1,512 @@
+/*!
+* @brief Class to track a satellite from an uploaded TLE without commands from the host
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sys/time.h>
+#include <time.h>
+#include "Tracker.h"
+#include "Webpage.h"
+#include "Gimbal.h"
+
+/*! @brief class constructor
+ */
+Tracker::Tracker()
+{
+	memset (tle1, 0, sizeof(tle1));
+	have_tle = have_qth = false;
+	active = false;
+	st_lat = st_lon = 0;
+	st_ecef[0] = st_ecef[1] = st_ecef[2] = 0;
+	head = count = 0;
+	state = IDLE;
+	search_t = fill_t = 0;
+	above = false;
+	memset (plans, 0, sizeof(plans));
+	plan_head = 0;
+	pass_aos = 0;
+	plan_due = false;
+	applied_aos = 0;
+	//< UTC from the network; TIM can set it instead at stations without internet access
+	configTime (0, 0, NTP_SERVER);
+}
+
+/*! @brief current UTC time
+*
+* @return seconds since 1970, or 0 if the clock has not been set
+*/
+double Tracker::now()
+{
+	struct timeval _tv;
+	gettimeofday (&_tv, NULL);
+	if (_tv.tv_sec < 1577836800L) {		//< before 2020, so never set
+	    return (0);
+	}
+	return (_tv.tv_sec + _tv.tv_usec / 1e6);
+}
+
+/*! @brief compute where the satellite is seen from the station
+*
+* @param t unix time, seconds
+* @param az receives azimuth, degrees E of N
+* @param el receives elevation, degrees up
+* @return true if the orbit could be propagated to t
+*/
+bool Tracker::look (uint32_t t, float *az, float *el)
+{
+	double _r[3];
+	if (!sgp4.propagate ((t - sgp4.epoch()) / 60.0, _r)) {
+	    return (false);
+	}
+	//< rotate TEME to earth-fixed by Greenwich mean sidereal time
+	double _tut1 = (t / 86400.0 + 2440587.5 - 2451545.0) / 36525.0;
+	double _gmst = -6.2e-6 * _tut1 * _tut1 * _tut1 + 0.093104 * _tut1 * _tut1
+		+ (876600.0 * 3600 + 8640184.812866) * _tut1 + 67310.54841;
+	_gmst = fmod (_gmst * M_PI / 180 / 240, 2 * M_PI);
+	double _cg = cos (_gmst), _sg = sin (_gmst);
+	double _dx = _cg * _r[0] + _sg * _r[1] - st_ecef[0];
+	double _dy = -_sg * _r[0] + _cg * _r[1] - st_ecef[1];
+	double _dz = _r[2] - st_ecef[2];
+	//< into the station's south, east, zenith frame
+	double _slat = sin (st_lat), _clat = cos (st_lat);
+	double _slon = sin (st_lon), _clon = cos (st_lon);
+	double _s = _slat * _clon * _dx + _slat * _slon * _dy - _clat * _dz;
+	double _e = -_slon * _dx + _clon * _dy;
+	double _z = _clat * _clon * _dx + _clat * _slon * _dy + _slat * _dz;
+	double _range = sqrt (_s * _s + _e * _e + _z * _z);
+	*az = fmod (atan2 (_e, -_s) * 180 / M_PI + 360, 360);
+	*el = asin (_z / _range) * 180 / M_PI;
+	return (true);
+}
+
+/*! @brief discard the pass table and start looking for the next pass from now
+ */
+void Tracker::restart()
+{
+	head = count = 0;
+	above = false;
+	memset (plans, 0, sizeof(plans));
+	plan_due = false;
+	release();
+	state = IDLE;
+	if (active && have_tle && have_qth) {
+	    search_t = (uint32_t)now();
+	    state = SEARCH;
+	}
+}
+
+/*! @brief call this occasionally to extend the pass table
+*
+* Does at most CHUNK propagations so it never holds up loop() for long.
+* SEARCH steps forward by SEARCH_STEP until the satellite rises, then FILL stores a point
+* every POINT_STEP until it sets, after which SEARCH resumes from there. A pass is planned
+* once it has set, or has filled the table.
+*/
+void Tracker::service()
+{
+	uint32_t _now = (uint32_t)now();
+	if (state == IDLE || _now == 0) {
+	    return;
+	}
+	float _az, _el;
+	for (uint8_t i = 0; i < CHUNK; i++) {
+	    if (state == SEARCH) {
+		    if (search_t > _now + SEARCH_SPAN) {
+			    return;		//< nothing within SEARCH_SPAN, try again later
+		    }
+		    if (!look (search_t, &_az, &_el)) {
+			    state = IDLE;
+			    webpage->setUserMessage (F("TLE cannot be propagated!"));
+			    return;
+		    }
+		    if (_el >= MIN_EL) {
+			    //< rose since the last search point; start the table there to have some lead-in
+			    fill_t = search_t - SEARCH_STEP;
+			    if (fill_t < _now) {
+				    fill_t = _now;
+			    }
+			    above = false;
+			    pass_aos = fill_t;
+			    plan_due = true;
+			    state = FILL;
+		    } else {
+			    search_t += SEARCH_STEP;
+		    }
+	    } else {
+		    if (count >= N_POINTS) {
+			    if (plan_due) {
+				    planPass (fill_t - POINT_STEP);		//< as much of it as there is room for
+			    }
+			    return;		//< table full, wait for target() to use some
+		    }
+		    if (!look (fill_t, &_az, &_el)) {
+			    state = IDLE;
+			    return;
+		    }
+		    PassPoint *_pp = &points[head];
+		    _pp->t = fill_t;
+		    _pp->az = _az;
+		    _pp->el = _el;
+		    head = (head + 1) % N_POINTS;
+		    count++;
+		    fill_t += POINT_STEP;
+		    if (_el >= MIN_EL) {
+			    above = true;
+		    } else if (above) {
+			    //< set: this point closes the pass, plan it and look for the next one
+			    planPass (_pp->t);
+			    search_t = fill_t;
+			    state = SEARCH;
+			    return;
+		    }
+	    }
+	}
+}
+
+/*! @brief where the Gimbal should point now, interpolated from the pass table
+*
+* @param az receives azimuth, degrees
+* @param el receives elevation, degrees, never below the horizon
+* @return true if now is within a pass in the table
+*/
+bool Tracker::target (float *az, float *el)
+{
+	double _now = now();
+	if (!active || _now == 0) {
+	    release();
+	    return (false);
+	}
+	//< drop points that are entirely in the past
+	uint16_t _tail = (head + N_POINTS - count) % N_POINTS;
+	while (count >= 2 && points[(_tail + 1) % N_POINTS].t <= _now) {
+	    _tail = (_tail + 1) % N_POINTS;
+	    count--;
+	}
+	if (count < 2) {
+	    release();
+	    return (false);
+	}
+	PassPoint *_p0 = &points[_tail];
+	PassPoint *_p1 = &points[(_tail + 1) % N_POINTS];
+	//< not yet at the first point, or between passes
+	if (_now < _p0->t || _p1->t - _p0->t != POINT_STEP) {
+	    release();
+	    return (false);
+	}
+	//< the Gimbal waits for the plan rather than start the pass on the wrong wrap
+	const PassPlan *_pl = planFor (_p0->t);
+	if (_pl == NULL) {
+	    return (false);
+	}
+	if (_pl->aos != applied_aos) {
+	    applied_aos = _pl->aos;
+	    if (_pl->ok) {
+		    gimbal->setPlan (_pl->flip, _pl->az);
+	    } else {
+		    gimbal->endPlan();
+	    }
+	}
+	float _f = (_now - _p0->t) / POINT_STEP;
+	float _daz = _p1->az - _p0->az;
+	if (_daz > 180) {
+	    _daz -= 360;
+	} else if (_daz < -180) {
+	    _daz += 360;
+	}
+	*az = fmod (_p0->az + _f * _daz + 360, 360);
+	*el = _p0->el + _f * (_p1->el - _p0->el);
+	if (*el < MIN_EL) {
+	    *el = MIN_EL;
+	}
+	return (true);
+}
+
+/*! @brief whether self-tracking will be pointing within the given time, or already is
+*
+* Only passes already in the table count, so this is for waking in time, not for planning.
+* @param secs seconds from now
+*/
+bool Tracker::passWithin (uint32_t secs)
+{
+	double _now = now();
+	if (!active || _now == 0 || count == 0) {
+	    return (false);
+	}
+	uint16_t _tail = (head + N_POINTS - count) % N_POINTS;
+	return (points[_tail].t <= _now + secs);
+}
+
+/*! @brief choose how the Gimbal tracks the pass just completed in the table
+*
+* Tries the mount the right way up, then over the top, and keeps the first in which the whole
+* pass stays within Gimbal::reach() from one az wrap. If neither fits, or the Gimbal can't say yet,
+* the pass is tracked the shortest way, swinging at the az limits as for host commands.
+* Runs once per pass, from service(), so target() only looks the plan up.
+* @param los time of the last table point of the pass
+*/
+void Tracker::planPass (uint32_t los)
+{
+	plan_due = false;
+	PassPlan *_pl = &plans[plan_head];
+	plan_head = (plan_head + 1) % N_PLANS;
+	_pl->aos = pass_aos;
+	_pl->los = los;
+	_pl->ok = false;
+	_pl->flip = false;
+	float _reach[4];
+	if (!gimbal->reach (_reach[0], _reach[1], _reach[2], _reach[3])) {
+	    return;
+	}
+	//< the pass is the newest points, perhaps less any target() has already used
+	uint16_t _tail = (head + N_POINTS - count) % N_POINTS;
+	uint16_t _n = 0;
+	while (_n < count && points[(head + N_POINTS - 1 - _n) % N_POINTS].t >= pass_aos) {
+	    _n++;
+	}
+	if (_n < 2) {
+	    return;
+	}
+	uint16_t _first = (_tail + count - _n) % N_POINTS;
+	for (uint8_t _flip = 0; _flip < 2 && !_pl->ok; _flip++) {
+	    _pl->flip = _flip;
+	    _pl->ok = fits (_first, _n, _flip, _reach, &_pl->az);
+	}
+	if (!_pl->ok) {
+	    _pl->flip = false;
+	    webpage->setUserMessage (F("Next pass exceeds the gimbal, it will swing mid-pass!"));
+	} else if (_pl->flip) {
+	    webpage->setUserMessage (F("Next pass is tracked over the top+"));
+	}
+	if (DEBUG_TRACKER) {
+	    Serial.printf ("Pass plan %u..%u: ok %d flip %d az %.1f, reach az %.1f..%.1f el %.1f..%.1f\n",
+			    (unsigned)_pl->aos, (unsigned)_pl->los, _pl->ok, _pl->flip, _pl->az, _reach[0], _reach[1], _reach[2], _reach[3]);
+	}
+}
+
+/*! @brief whether a pass stays within the Gimbal's reach, the mount one way up
+*
+* @param first points[] index of the first point of the pass
+* @param n number of points
+* @param flip true to check over the top, az + 180 and el 180 - el
+* @param reach least and greatest mount az, then el, as Gimbal::reach()
+* @param az_start receives the mount az of the first point, on the turn that fits
+* @return true if one az turn takes the whole pass, PLAN_MARGIN clear of the az limits
+*/
+bool Tracker::fits (uint16_t first, uint16_t n, bool flip, float reach[4], float *az_start)
+{
+	float _az0 = 0, _az = 0, _lo = 0, _hi = 0;
+	for (uint16_t i = 0; i < n; i++) {
+	    const PassPoint *_pp = &points[(first + i) % N_POINTS];
+	    float _el = _pp->el < MIN_EL ? MIN_EL : _pp->el;
+	    if (flip) {
+		    _el = 180 - _el;
+	    }
+	    //< el only clamps at a limit, so a little short is no reason to flip
+	    if (_el < reach[2] - PLAN_MARGIN || _el > reach[3] + PLAN_MARGIN) {
+		    return (false);
+	    }
+	    //< az unwrapped along the pass
+	    float _a = _pp->az + (flip ? 180 : 0);
+	    if (i == 0) {
+		    _az0 = _az = _lo = _hi = _a;
+		    continue;
+	    }
+	    float _d = fmod (_a - _az, 360);
+	    if (_d > 180) {
+		    _d -= 360;
+	    } else if (_d < -180) {
+		    _d += 360;
+	    }
+	    _az += _d;
+	    _lo = min (_lo, _az);
+	    _hi = max (_hi, _az);
+	}
+	//< of the turns that fit, the one nearest the first
+	float _k_lo = ceil ((reach[0] + PLAN_MARGIN - _lo) / 360);
+	float _k_hi = floor ((reach[1] - PLAN_MARGIN - _hi) / 360);
+	if (_k_lo > _k_hi) {
+	    return (false);
+	}
+	*az_start = _az0 + 360 * constrain (0.0f, _k_lo, _k_hi);
+	return (true);
+}
+
+/*! @brief the plan for the pass a table point is in
+* @param t table point time
+* @return NULL if that pass has not been planned
+*/
+const Tracker::PassPlan *Tracker::planFor (uint32_t t)
+{
+	for (uint8_t i = 0; i < N_PLANS; i++) {
+	    if (plans[i].aos != 0 && plans[i].aos <= t && t <= plans[i].los) {
+		    return (&plans[i]);
+	    }
+	}
+	return (NULL);
+}
+
+/*! @brief hand the Gimbal back to the shortest way, between passes
+*/
+void Tracker::release()
+{
+	if (applied_aos != 0) {
+	    gimbal->endPlan();
+	    applied_aos = 0;
+	}
+}
+
+/*! @brief stop self-tracking, e.g. because the host has taken over
+ */
+void Tracker::stop()
+{
+	active = false;
+	restart();
+}
+
+/*! @brief store the first TLE line until the second arrives
+* @param line1 the TLE line starting with '1'
+* @return true if it looks like a TLE line
+*/
+bool Tracker::setTLE1 (const char *line1)
+{
+	if (line1[0] != '1' || strlen (line1) < 69) {
+	    return (false);
+	}
+	strncpy (tle1, line1, 69);
+	tle1[69] = '\0';
+	return (true);
+}
+
+/*! @brief complete the TLE and start self-tracking
+* @param line2 the TLE line starting with '2'
+* @return true if the element set is valid
+*/
+bool Tracker::setTLE2 (const char *line2)
+{
+	have_tle = sgp4.init (tle1, line2);
+	active = have_tle;
+	restart();
+	return (have_tle);
+}
+
+/*! @brief set station location from "lat lon alt", degrees N, degrees E, meters
+* @param qth the location
+* @return true if three sane numbers were found
+*/
+bool Tracker::setQTH (const char *qth)
+{
+	char *_end;
+	double _lat = strtod (qth, &_end);
+	double _lon = strtod (_end, &_end);
+	double _alt = strtod (_end, &_end) / 1000;
+	if (_lat < -90 || _lat > 90 || _lon < -180 || _lon > 360) {
+	    return (false);
+	}
+	st_lat = _lat * M_PI / 180;
+	st_lon = _lon * M_PI / 180;
+	//< WGS-84 geodetic to earth-fixed
+	const double _a = 6378.137;
+	const double _e2 = 0.00669437999014;
+	double _slat = sin (st_lat);
+	double _n = _a / sqrt (1 - _e2 * _slat * _slat);
+	st_ecef[0] = (_n + _alt) * cos (st_lat) * cos (st_lon);
+	st_ecef[1] = (_n + _alt) * cos (st_lat) * sin (st_lon);
+	st_ecef[2] = (_n * (1 - _e2) + _alt) * _slat;
+	have_qth = true;
+	restart();
+	return (true);
+}
+
+/*! @brief set the clock for stations that can't reach NTP_SERVER
+* @param secs UTC as seconds since 1970
+* @return true if the time looks plausible
+*/
+bool Tracker::setTime (const char *secs)
+{
+	struct timeval _tv;
+	_tv.tv_sec = strtol (secs, NULL, 10);
+	_tv.tv_usec = 0;
+	if (_tv.tv_sec < 1577836800L) {
+	    return (false);
+	}
+	settimeofday (&_tv, NULL);
+	restart();
+	return (true);
+}
+
+/*! @brief handle an Easycomm extension command
+*
+* TL1 and TL2 upload the two TLE lines, TLX stops self-tracking,
+* QTH sets the station "lat lon alt" and TIM sets UTC seconds.
+* @param cmd the whole command line
+* @return true if the command was accepted
+*/
+bool Tracker::command (char *cmd)
+{
+	if (!strncmp (cmd, "TL1 ", 4)) {
+	    return (setTLE1 (cmd + 4));
+	}
+	if (!strncmp (cmd, "TL2 ", 4)) {
+	    return (setTLE2 (cmd + 4));
+	}
+	if (!strncmp (cmd, "TLX", 3)) {
+	    stop();
+	    return (true);
+	}
+	if (!strncmp (cmd, "QTH ", 4)) {
+	    return (setQTH (cmd + 4));
+	}
+	if (!strncmp (cmd, "TIM ", 4)) {
+	    return (setTime (cmd + 4));
+	}
+	return (false);
+}
+
+/*! @brief process name = value pair
+*
+* @param name the web page id where value was entered
+* @param value a value to operate on, if needed
+* @return return true if Tracker handles this 'name' command, false if Tracker doesn't recognize it
+*/
+bool Tracker::overrideValue (char *name, char *value)
+{
+	if (!strcmp (name, "TLE1")) {
+	    if (setTLE1 (value)) {
+		    webpage->setUserMessage (F("TLE line 1 received+"));
+	    } else {
+		    webpage->setUserMessage (F("Bad TLE line 1!"));
+	    }
+	    return (true);
+	}
+	if (!strcmp (name, "TLE2")) {
+	    if (setTLE2 (value)) {
+		    webpage->setUserMessage (F("TLE loaded, self-tracking+"));
+	    } else {
+		    webpage->setUserMessage (F("Bad TLE!"));
+	    }
+	    return (true);
+	}
+	if (!strcmp (name, "QTH")) {
+	    if (setQTH (value)) {
+		    webpage->setUserMessage (F("Station location set+"));
+	    } else {
+		    webpage->setUserMessage (F("Bad station location!"));
+	    }
+	    return (true);
+	}
+	return (false);
+}
@@ -0,0 +1,102 @@
+/*!
+* @brief Class to track a satellite from an uploaded TLE without commands from the host
+*
+* A TLE and the station location arrive thru Easycomm extension commands or the Webpage.
+* The next pass is found and its az/el table precomputed into a ring buffer a few points at a
+* time from service(), so target() only interpolates between stored points.
+* Once a pass is in the table it is planned: the az wrap, and whether to go over the top, that
+* keep the whole pass within the Gimbal's reach, so it is tracked without a mid-pass swing.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _TRACKER_H
+#define _TRACKER_H
+
+#include <Arduino.h>
+#include "SGP4.h"
+
+#define NTP_SERVER "pool.ntp.org"	///< time source for propagation; TIM command sets time if unreachable
+
+class Tracker {
+
+    private:
+	const bool DEBUG_TRACKER = false;
+	SGP4 sgp4;
+	char tle1[70];						//< pending first TLE line, waiting for the second
+	bool have_tle, have_qth;
+	bool active;						//< self-tracking requested
+	double st_lat, st_lon;				//< station geodetic latitude, longitude, radians
+	double st_ecef[3];					//< station earth-fixed position, km
+
+	// pass table
+	typedef struct {
+	    uint32_t t;						// unix time, seconds
+	    float az, el;					// degrees
+	} PassPoint;
+	static const uint16_t N_POINTS = 512;		// ring buffer size
+	static const uint8_t POINT_STEP = 2;		// seconds between table points
+	static const uint8_t SEARCH_STEP = 30;		// seconds between points while looking for AOS
+	static const uint8_t CHUNK = 8;				// propagations per service()
+	static const uint32_t SEARCH_SPAN = 172800;	// look at most this far ahead, seconds
+	static constexpr float MIN_EL = 0.0;		// horizon, degrees
+	PassPoint points[N_POINTS];
+	uint16_t head, count;				//< next slot to fill, number of points held
+	enum { IDLE, SEARCH, FILL } state;
+	uint32_t search_t, fill_t;			//< next time to propagate in SEARCH and FILL
+	bool above;							//< FILL has seen the satellite above MIN_EL
+
+	// pass plans, made by service() as each pass is completed in the table and used by target()
+	typedef struct {
+	    uint32_t aos, los;				// first and last table point of the pass, unix time
+	    bool ok;						// the pass fits the Gimbal's reach from one start
+	    bool flip;						// over the top
+	    float az;						// mount az at aos, degrees, as Gimbal::setPlan()
+	} PassPlan;
+	static const uint8_t N_PLANS = 4;			// more passes than the table holds
+	static constexpr float PLAN_MARGIN = 5;		// degrees of az to keep clear of the motor limits
+	PassPlan plans[N_PLANS];
+	uint8_t plan_head;					//< next plans[] to fill
+	uint32_t pass_aos;					//< first point of the pass FILL is storing
+	bool plan_due;						//< that pass has not been planned yet
+	uint32_t applied_aos;				//< aos of the plan given to the Gimbal, 0 if none
+
+	double now();
+	bool look (uint32_t t, float *az, float *el);
+	void restart();
+	void planPass (uint32_t los);
+	bool fits (uint16_t first, uint16_t n, bool flip, float reach[4], float *az_start);
+	const PassPlan *planFor (uint32_t t);
+	void release();
+	bool setTLE1 (const char *line1);
+	bool setTLE2 (const char *line2);
+	bool setQTH (const char *qth);
+	bool setTime (const char *secs);
+
+    public:
+	Tracker();
+	void service();
+	bool target (float *az, float *el);
+	bool command (char *cmd);
+	bool overrideValue (char *name, char *value);
+	void stop();
+	bool isActive() { return (active); };
+	bool passWithin (uint32_t secs);
+};
+
+extern Tracker *tracker;
+
+#endif // _TRACKER_H
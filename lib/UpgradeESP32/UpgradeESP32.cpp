@@ -28,10 +28,28 @@
 #include <Arduino.h>
 
 #include <WebServer.h>
-#include <ESPmDNS.h>
 #include <Update.h>
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
 #include "UpgradeESP32.h"
-WebServer server(54310);
+#include "Tracker.h"
+#include "Easycomm.h"
+#include "Gimbal.h"
+#include "Webpage.h"
+#include "NV.h"
+WebServer server(OTA_PORT);
+bool UpgradeESP32::trial_boot = false;
+
+//< the upload in progress; only touched by whichever task serves the WebServer
+static mbedtls_sha256_context ota_sha;
+static char ota_expected[65];           //< lower case hex SHA-256 given with the upload, "" if none
+static char ota_result[120];            //< reply to the upload POST
+static bool ota_ok;                     //< no error so far
+static bool ota_now;                    //< reboot without waiting for the pass to end
+static volatile bool ota_ready;         //< image written and verified, reboot into it when idle
+static const char OTA_PREFS[] = "ota";  //< Preferences namespace for the trial boot bookkeeping
+
 const char *esp32loginIndex =
     "<form name='loginForm'>"
     "<table width='20%' bgcolor='A09F9F' align='center'>"
@@ -75,57 +93,42 @@ const char *esp32loginIndex =
 
 /*
         * Server Index Page
+        * plain XMLHttpRequest, so it works on a LAN with no way out to the internet
         */
 
 const char *espserverIndex =
-    "<script src='https://ajax.googleapis.com/ajax/libs/jquery/3.2.1/jquery.min.js'></script>"
-    "<form method='POST' action='#' enctype='multipart/form-data' id='upload_form'>"
-    "<input type='file' name='update'>"
+    "<form id='upload_form'>"
+    "<input type='file' id='file'><br>"
+    "SHA-256 (optional) <input type='text' size=64 id='sha'><br>"
+    "<label><input type='checkbox' id='now'>reboot now, even during a pass</label><br>"
     "<input type='submit' value='Update'>"
     "</form>"
     "<div id='prg'>progress: 0%</div>"
     "<script>"
-    "$('form').submit(function(e){"
+    "function byId(i){return document.getElementById(i);}"
+    "byId('upload_form').onsubmit=function(e){"
     "e.preventDefault();"
-    "var form = $('#upload_form')[0];"
-    "var data = new FormData(form);"
-    " $.ajax({"
-    "url: '/update',"
-    "type: 'POST',"
-    "data: data,"
-    "contentType: false,"
-    "processData:false,"
-    "xhr: function() {"
-    "var xhr = new window.XMLHttpRequest();"
-    "xhr.upload.addEventListener('progress', function(evt) {"
-    "if (evt.lengthComputable) {"
-    "var per = evt.loaded / evt.total;"
-    "$('#prg').html('progress: ' + Math.round(per*100) + '%');"
-    "}"
-    "}, false);"
-    "return xhr;"
-    "},"
-    "success:function(d, s) {"
-    "console.log('success!')"
-    "},"
-    "error: function (a, b, c) {"
-    "}"
-    "});"
-    "});"
+    "var data=new FormData();"
+    "data.append('update',byId('file').files[0]);"
+    "var url='/update?sha256='+encodeURIComponent(byId('sha').value.trim());"
+    "if(byId('now').checked)url+='&reboot=now';"
+    "var xhr=new XMLHttpRequest();"
+    "xhr.upload.onprogress=function(evt){"
+    "if(evt.lengthComputable)byId('prg').innerHTML='progress: '+Math.round(evt.loaded/evt.total*100)+'%';"
+    "};"
+    "xhr.onload=function(){byId('prg').innerHTML=xhr.responseText;};"
+    "xhr.onerror=function(){byId('prg').innerHTML='upload failed';};"
+    "xhr.open('POST',url);"
+    "xhr.send(data);"
+    "};"
     "</script>";
 /*! constructor
  */
 UpgradeESP32::UpgradeESP32()
 {
-    if (!MDNS.begin(host))
-    { //http://esp32.local
-        Serial.println("Error setting up MDNS responder!");
-        while (1)
-        {
-            delay(1000);
-        }
-    }
-    Serial.println("mDNS responder started");
+    task = NULL;
+    idle_since = 0;
+    announced = false;
     /*return index page which is stored in serverIndex */
     server.on("/", HTTP_GET, []() {
         server.sendHeader("Connection", "close");
@@ -136,37 +139,224 @@ UpgradeESP32::UpgradeESP32()
         server.send(200, "text/html", espserverIndex);
     });
     /*handling uploading firmware file */
-    server.on(
-        "/update", HTTP_POST, []() {
-    server.sendHeader("Connection", "close");
-    server.send(200, "text/plain", (Update.hasError()) ? "FAIL" : "OK");
-    ESP.restart(); }, []() {
-    HTTPUpload& upload = server.upload();
-    if (upload.status == UPLOAD_FILE_START) {
-      Serial.printf("Update: %s\n", upload.filename.c_str());
-      if (!Update.begin(UPDATE_SIZE_UNKNOWN)) { //start with max available size
-        Update.printError(Serial);
-      }
-    } else if (upload.status == UPLOAD_FILE_WRITE) {
-      /* flashing firmware to ESP*/
-      if (Update.write(upload.buf, upload.currentSize) != upload.currentSize) {
-        Update.printError(Serial);
-      }
-    } else if (upload.status == UPLOAD_FILE_END) {
-      if (Update.end(true)) { //true to set the size to the current progress
-        Serial.printf("Update Success: %u\nRebooting...\n", upload.totalSize);
-      } else {
-        Update.printError(Serial);
-      }
-    } });
+    server.on("/update", HTTP_POST, handleUpdateDone, handleUpload);
     server.begin();
 }
 
-/*! @brief record a brief F() message to inform the user
+/*! @brief roll back to the previous firmware if new firmware keeps failing to start
 *
-* Message will be sent on the next sendNewValues() sweep
+* Call first thing in setup(). Each boot of an image on trial is counted, and after MAX_TRIAL_BOOTS
+* the previous app partition is made the boot partition again. The stock 1.0.x bootloader has no
+* rollback of its own, so this is done by hand; confirmBoot() ends the trial.
 */
-void UpgradeESP32::checkPortServer()
+void UpgradeESP32::checkBoot()
+{
+    Preferences _p;
+    _p.begin(OTA_PREFS, false);
+    if (_p.getUChar("trial", 0))
+    {
+        char _next[17], _prev[17];
+        _p.getString("next", _next, sizeof(_next));
+        _p.getString("prev", _prev, sizeof(_prev));
+        const esp_partition_t *_running = esp_ota_get_running_partition();
+        uint8_t _boots = _p.getUChar("boots", 0) + 1;
+        if (strcmp(_running->label, _next) != 0)
+        {
+            _p.putUChar("trial", 0); // not running the new image at all, nothing to judge
+        }
+        else if (_boots > MAX_TRIAL_BOOTS)
+        {
+            _p.putUChar("trial", 0);
+            const esp_partition_t *_back = esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, _prev);
+            if (_back != NULL && esp_ota_set_boot_partition(_back) == ESP_OK)
+            {
+                Serial.printf("Firmware in %s did not start %u times, back to %s\n", _next, MAX_TRIAL_BOOTS, _prev);
+                _p.end();
+                ESP.restart();
+            }
+        }
+        else
+        {
+            _p.putUChar("boots", _boots);
+            trial_boot = true;
+        }
+    }
+    _p.end();
+}
+
+/*! @brief serve OTA requests from a task of their own, so an upload never stalls tracking
+*
+* @return true if the task is running, else checkPortServer() keeps serving from loop()
+*/
+bool UpgradeESP32::startTask()
+{
+    if (task == NULL && xTaskCreatePinnedToCore(otaTask, "OTA", TASK_STACK, this, TASK_PRIORITY, &task, TASK_CORE) != pdPASS)
+    {
+        task = NULL;
+    }
+    return (task != NULL);
+}
+
+/*! @brief OTA task body
+*/
+void UpgradeESP32::otaTask(void *arg)
+{
+    for (;;)
+    {
+        server.handleClient();
+        vTaskDelay(pdMS_TO_TICKS(TASK_INTERVAL));
+    }
+}
+
+/*! @brief receive one chunk of a firmware upload, hashing it on the way to flash
+*/
+void UpgradeESP32::handleUpload()
+{
+    HTTPUpload &upload = server.upload();
+    if (upload.status == UPLOAD_FILE_START)
+    {
+        Serial.printf("Update: %s\n", upload.filename.c_str());
+        strncpy(ota_expected, server.arg("sha256").c_str(), sizeof(ota_expected) - 1);
+        ota_expected[sizeof(ota_expected) - 1] = '\0';
+        for (char *_c = ota_expected; *_c; _c++)
+        {
+            *_c = tolower(*_c);
+        }
+        ota_now = strcmp(server.arg("reboot").c_str(), "now") == 0;
+        ota_ready = false;
+        mbedtls_sha256_init(&ota_sha);
+        mbedtls_sha256_starts_ret(&ota_sha, 0);
+        ota_ok = Update.begin(UPDATE_SIZE_UNKNOWN); //start with max available size
+        if (!ota_ok)
+        {
+            Update.printError(Serial);
+        }
+    }
+    else if (upload.status == UPLOAD_FILE_WRITE)
+    {
+        if (ota_ok)
+        {
+            mbedtls_sha256_update_ret(&ota_sha, upload.buf, upload.currentSize);
+            ota_ok = Update.write(upload.buf, upload.currentSize) == upload.currentSize;
+            if (!ota_ok)
+            {
+                Update.printError(Serial);
+            }
+        }
+        vTaskDelay(1); // each flash write stalls the caches on both cores; let loop() catch up
+    }
+    else if (upload.status == UPLOAD_FILE_END)
+    {
+        uint8_t _sum[32];
+        char _hex[65];
+        mbedtls_sha256_finish_ret(&ota_sha, _sum);
+        mbedtls_sha256_free(&ota_sha);
+        for (uint8_t i = 0; i < sizeof(_sum); i++)
+        {
+            sprintf(&_hex[2 * i], "%02x", _sum[i]);
+        }
+        if (ota_ok && ota_expected[0] != '\0' && strcmp(_hex, ota_expected) != 0)
+        {
+            Update.abort();
+            ota_ok = false;
+            snprintf(ota_result, sizeof(ota_result), "FAIL sha256 %s does not match", _hex);
+        }
+        else if (ota_ok && Update.end(true)) //true to set the size to the current progress
+        {
+            Preferences _p;
+            _p.begin(OTA_PREFS, false);
+            _p.putString("prev", esp_ota_get_running_partition()->label);
+            _p.putString("next", esp_ota_get_boot_partition()->label);
+            _p.putUChar("boots", 0);
+            _p.putUChar("trial", 1);
+            _p.end();
+            Serial.printf("Update Success: %u\n", upload.totalSize);
+            snprintf(ota_result, sizeof(ota_result), "OK sha256 %s, rebooting %s", _hex,
+                     ota_now ? "now" : "once no pass is being tracked");
+            ota_ready = true;
+        }
+        else
+        {
+            Update.printError(Serial);
+            ota_ok = false;
+            snprintf(ota_result, sizeof(ota_result), "FAIL");
+        }
+    }
+    else if (upload.status == UPLOAD_FILE_ABORTED)
+    {
+        mbedtls_sha256_free(&ota_sha);
+        Update.abort();
+        ota_ok = false;
+        snprintf(ota_result, sizeof(ota_result), "FAIL upload aborted");
+    }
+}
+
+/*! @brief answer the upload POST; the reboot itself waits for checkPortServer()
+*/
+void UpgradeESP32::handleUpdateDone()
 {
-  server.handleClient();
+    server.sendHeader("Connection", "close");
+    server.send(200, "text/plain", ota_result);
 }
+
+/*! @brief whether rebooting now would interrupt the rotator
+*/
+bool UpgradeESP32::busy()
+{
+    float _az, _el;
+    return (tracker->target(&_az, &_el) || easycomm->predict(millis(), &_az, &_el) || gimbal->isCalibrating);
+}
+
+/*! @brief keep the firmware on trial, it has run long enough
+*/
+void UpgradeESP32::confirmBoot()
+{
+    Preferences _p;
+    _p.begin(OTA_PREFS, false);
+    _p.putUChar("trial", 0);
+    _p.end();
+    trial_boot = false;
+    webpage->setUserMessage(F("New firmware confirmed+"));
+}
+
+/*! @brief serve OTA requests unless the task does, and reboot into new firmware when it is safe
+*
+* Call periodically from loop(). A verified upload reboots after IDLE_HOLD with no pass being
+* tracked, no host command trajectory and no calibration running, unless it asked for now.
+*/
+void UpgradeESP32::checkPortServer()
+{
+    if (task == NULL)
+    {
+        server.handleClient();
+    }
+    if (trial_boot && millis() >= CONFIRM_AFTER)
+    {
+        confirmBoot();
+    }
+    if (!ota_ready)
+    {
+        return;
+    }
+    if (!announced)
+    {
+        webpage->setUserMessage(F("New firmware loaded, rebooting once no pass is being tracked+"));
+        announced = true;
+    }
+    uint32_t _now = millis();
+    if (!ota_now && busy())
+    {
+        idle_since = 0;
+        return;
+    }
+    if (idle_since == 0)
+    {
+        idle_since = _now | 1;
+    }
+    if (ota_now || _now - idle_since >= IDLE_HOLD)
+    {
+        Serial.println("Rebooting...");
+        nv->flush();
+        ESP.restart();
+    }
+}
\ No newline at end of file
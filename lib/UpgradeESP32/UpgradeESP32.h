@@ -1,6 +1,9 @@
 /*!
-* @brief implement ftoa function following 
-* https://tutorialspoint.dev/language/c/convert-floating-point-number-string
+* @brief Class to receive new firmware over WiFi on OTA_PORT without disturbing tracking
+*
+* OTA runs in its own low priority task and hashes the image with SHA-256 as it streams in.
+* The new image boots on trial: if it does not stay up for CONFIRM_AFTER within MAX_TRIAL_BOOTS
+* tries, the previous one is booted again. The reboot into it waits until no pass is being tracked.
 *
 * @section license License
 *
@@ -21,18 +24,34 @@
 
 #ifndef _UPGRADEESP32_H
 #define _UPGRADEESP32_H
-#define host "esp32"
+#define OTA_PORT 54310
 
 class UpgradeESP32 {
 
 public:
     UpgradeESP32();
+    static void checkBoot();
+    bool startTask();
+    bool taskRunning() { return (task != NULL); };
     void checkPortServer();
 
 private:
-
-
-
+    static const uint8_t TASK_CORE = 0;             // with the WiFi stack, away from loop()
+    static const uint16_t TASK_STACK = 8192;        // bytes; WebServer and the SHA-256 context
+    static const uint8_t TASK_PRIORITY = 1;         // below sensorTask and serialTask
+    static const uint8_t TASK_INTERVAL = 5;         // ms between WebServer polls
+    static const uint32_t CONFIRM_AFTER = 60000;    // ms a trial boot must run for before it is kept
+    static const uint8_t MAX_TRIAL_BOOTS = 3;       // trial boots before rolling back
+    static const uint32_t IDLE_HOLD = 10000;        // ms without a pass before rebooting into new firmware
+    TaskHandle_t task;                              //< OTA task, NULL when polled from loop()
+    uint32_t idle_since;                            //< millis() since no pass was tracked, 0 while one is
+    bool announced;                                 //< user told the reboot is pending
+    static bool trial_boot;                         //< checkBoot() found new firmware on trial
+    static void otaTask(void *arg);
+    static void handleUpload();
+    static void handleUpdateDone();
+    bool busy();
+    void confirmBoot();
 };
 extern UpgradeESP32 *upgradeESP32;
 
@@ -0,0 +1,183 @@
+/*!
+* @brief main web page, gzip-compressed
+*
+* Generated from web/index.html by tools/make_page.py -- edit those, not this.
+* 10193 bytes of minified html, 2658 compressed.
+*/
+
+#ifndef _MAINPAGE_H
+#define _MAINPAGE_H
+
+#include <pgmspace.h>
+
+static const uint8_t MAIN_PAGE_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xc5, 0x5a, 0x7b, 0x6f, 0x13, 0xb9,
+    0x16, 0xff, 0x3f, 0x9f, 0xc2, 0x08, 0x81, 0x13, 0xd1, 0x3c, 0x4b, 0xa1, 0xb7, 0x69, 0x82, 0xba,
+    0x7d, 0x84, 0x5d, 0x51, 0xa8, 0x48, 0x61, 0xef, 0xd5, 0xb2, 0xaa, 0x26, 0x19, 0x27, 0xf1, 0x76,
+    0xc6, 0x1e, 0x3c, 0x4e, 0xd2, 0xb0, 0xea, 0x77, 0xbf, 0xe7, 0x78, 0xec, 0x79, 0xe4, 0xd1, 0x17,
+    0x05, 0x5a, 0xa9, 0x99, 0xd8, 0xc7, 0xe7, 0xf1, 0x3b, 0x4f, 0x8f, 0xba, 0xff, 0xe4, 0xe8, 0xc3,
+    0xe1, 0xf9, 0xff, 0xce, 0x8e, 0xc9, 0x44, 0x87, 0x41, 0xb7, 0xb4, 0xef, 0x3e, 0x98, 0xe7, 0xc3,
+    0x47, 0xc8, 0xb4, 0x07, 0x3b, 0x3a, 0xaa, 0xb2, 0xaf, 0x53, 0x3e, 0xeb, 0xd0, 0x43, 0x29, 0x34,
+    0x13, 0xba, 0x7a, 0xbe, 0x88, 0x18, 0x25, 0xc3, 0xe4, 0x5b, 0x87, 0x6a, 0x76, 0xa5, 0xeb, 0x78,
+    0xb4, 0x4d, 0x86, 0x13, 0x4f, 0xc5, 0x4c, 0x77, 0x3e, 0x9d, 0x9f, 0x54, 0x77, 0x29, 0xa9, 0x03,
+    0x97, 0x58, 0x2f, 0x02, 0xd6, 0x2d, 0x0d, 0xa4, 0xbf, 0x20, 0xff, 0x96, 0x06, 0xde, 0xf0, 0x72,
+    0xac, 0xe4, 0x54, 0xf8, 0xd5, 0xa1, 0x0c, 0xa4, 0xda, 0x7b, 0xba, 0xbb, 0xbb, 0xdb, 0x2e, 0x8d,
+    0x80, 0x57, 0x75, 0xe4, 0x85, 0x3c, 0x58, 0xec, 0xc5, 0x9e, 0x88, 0xab, 0x31, 0x53, 0x7c, 0x64,
+    0xd7, 0x63, 0xfe, 0x8d, 0xed, 0x35, 0xb7, 0xa3, 0xab, 0x76, 0xe9, 0xba, 0xa4, 0xbd, 0x41, 0xc0,
+    0x90, 0x91, 0x54, 0x3e, 0x53, 0xc8, 0x24, 0xf0, 0xa2, 0x98, 0xed, 0x11, 0xf7, 0xd4, 0xb6, 0x5b,
+    0x7b, 0x04, 0x4e, 0x90, 0x58, 0x06, 0xdc, 0x6f, 0xe7, 0xa8, 0x41, 0x24, 0x79, 0xda, 0x68, 0x6c,
+    0xbf, 0x3a, 0x3c, 0x6c, 0xaf, 0xd1, 0xe6, 0x64, 0x17, 0x7f, 0x41, 0x70, 0x20, 0x3d, 0xbd, 0x17,
+    0xb0, 0x91, 0x36, 0x42, 0x27, 0x20, 0x31, 0xf2, 0x7c, 0x9f, 0x8b, 0xf1, 0x1e, 0x79, 0x85, 0x9a,
+    0x38, 0x21, 0xcd, 0x5b, 0x85, 0x5c, 0x97, 0x6a, 0x6c, 0xc6, 0x44, 0x55, 0xc9, 0xf9, 0x5a, 0x00,
+    0x9c, 0x48, 0xa0, 0x93, 0xbe, 0xbf, 0x91, 0xec, 0x68, 0x17, 0x7f, 0x91, 0xec, 0xa9, 0xe6, 0x3a,
+    0x60, 0x96, 0x10, 0xc1, 0xaf, 0x7a, 0x01, 0x1f, 0x0b, 0x80, 0x00, 0xdc, 0xc1, 0x54, 0x3b, 0xd3,
+    0xb4, 0x95, 0x69, 0x5a, 0x1d, 0x48, 0xad, 0x65, 0x68, 0xb4, 0x27, 0xbe, 0x9c, 0x02, 0x8a, 0x37,
+    0x68, 0x6c, 0x45, 0x04, 0xde, 0x80, 0x05, 0x20, 0x24, 0x73, 0x03, 0x69, 0xee, 0x22, 0x4f, 0xb3,
+    0x30, 0x67, 0x7c, 0x3c, 0xd1, 0x7b, 0x64, 0x20, 0x03, 0xb0, 0x3e, 0x63, 0xf2, 0xca, 0x31, 0x91,
+    0xd1, 0x45, 0xc8, 0xe2, 0xd8, 0x1b, 0xb3, 0x02, 0x8f, 0xa6, 0x01, 0xd0, 0xe7, 0x71, 0x14, 0x78,
+    0x0b, 0x38, 0x1e, 0xc8, 0xe1, 0x65, 0x4e, 0xe9, 0x66, 0xc3, 0x7a, 0xda, 0x7f, 0x10, 0xe8, 0x4e,
+    0x7a, 0x2d, 0xf4, 0xfe, 0x91, 0x0a, 0x02, 0x69, 0xa8, 0xb9, 0x14, 0x59, 0xc4, 0x68, 0x19, 0xdd,
+    0x11, 0x84, 0x5a, 0xc8, 0xc5, 0x46, 0x0e, 0x2f, 0xef, 0xc4, 0x41, 0xce, 0x98, 0x52, 0xdc, 0x67,
+    0xeb, 0x1d, 0x7f, 0x72, 0x92, 0x33, 0xbb, 0x91, 0xe2, 0x6a, 0xf3, 0x20, 0x94, 0x42, 0xc6, 0x91,
+    0x37, 0x04, 0x01, 0x8a, 0x19, 0xe0, 0x84, 0x14, 0x2c, 0x9f, 0x13, 0x5c, 0x4c, 0x20, 0x4d, 0x20,
+    0x42, 0xe7, 0xdc, 0xd7, 0x93, 0xbd, 0xd7, 0x2c, 0x34, 0x42, 0x51, 0x4a, 0x54, 0xc5, 0x24, 0x2e,
+    0xc6, 0x87, 0x0b, 0x0f, 0xd0, 0x49, 0xf3, 0xa1, 0x17, 0xd8, 0x65, 0x30, 0x27, 0x35, 0x41, 0x25,
+    0x1e, 0xbd, 0x9b, 0x71, 0xbe, 0xa7, 0xa7, 0x61, 0x1a, 0x23, 0x39, 0x41, 0x49, 0xda, 0xac, 0x13,
+    0x93, 0x70, 0x19, 0x04, 0x1e, 0x7a, 0xdc, 0xb1, 0x70, 0xc1, 0xb1, 0x6a, 0x77, 0x8e, 0xa7, 0xd1,
+    0xac, 0xc0, 0xc0, 0x84, 0xa9, 0x82, 0x07, 0x80, 0x6f, 0x29, 0x46, 0x5f, 0x6e, 0x88, 0xd1, 0xeb,
+    0xd2, 0x7e, 0xdd, 0xd6, 0xa3, 0xfd, 0x78, 0xa8, 0x78, 0xa4, 0xbb, 0xa5, 0xd1, 0x54, 0x24, 0xfe,
+    0x1d, 0x2c, 0x7e, 0xf7, 0x49, 0x99, 0xfb, 0x15, 0x60, 0xa6, 0x98, 0x9e, 0x2a, 0x01, 0x18, 0x0c,
+    0xa7, 0x21, 0xa0, 0x56, 0x1b, 0x33, 0x7d, 0x1c, 0x30, 0x7c, 0xfc, 0x0d, 0xa8, 0x90, 0x08, 0x99,
+    0xcd, 0xb9, 0xf0, 0xe5, 0xbc, 0x26, 0x05, 0x14, 0x0b, 0x9f, 0x74, 0x88, 0x63, 0x55, 0x46, 0x16,
+    0x7c, 0x44, 0xca, 0x96, 0xe0, 0x18, 0xd2, 0x5f, 0xf7, 0xe5, 0x54, 0x0d, 0x59, 0xa5, 0x14, 0x6b,
+    0x4f, 0x69, 0xb3, 0x12, 0x97, 0x81, 0x0b, 0x0b, 0x62, 0x56, 0xfa, 0x3a, 0x65, 0x6a, 0xf1, 0x9e,
+    0xcd, 0x3f, 0x7b, 0xc1, 0x94, 0x99, 0xe5, 0xeb, 0x4c, 0xaf, 0x4f, 0x82, 0x7f, 0xfd, 0xf4, 0xf1,
+    0x1d, 0x29, 0x4f, 0x55, 0x90, 0xd3, 0x0d, 0xbf, 0x92, 0x17, 0x84, 0xbe, 0xa1, 0xf0, 0xb7, 0x2c,
+    0xd8, 0x9c, 0x1c, 0x79, 0x9a, 0x95, 0x2b, 0x15, 0x54, 0xf6, 0x9c, 0x87, 0xf8, 0x58, 0xe0, 0x73,
+    0xf6, 0xa1, 0x7f, 0xfe, 0xfe, 0x33, 0x90, 0x7a, 0x21, 0xdb, 0x22, 0x33, 0x14, 0x85, 0xec, 0x66,
+    0x9e, 0x22, 0x57, 0x13, 0x05, 0xea, 0x23, 0x8f, 0xff, 0x9e, 0xbe, 0x7b, 0x0b, 0x15, 0xff, 0x23,
+    0x54, 0x7c, 0x16, 0x6b, 0xd4, 0x04, 0xf6, 0x6a, 0x32, 0x62, 0xa2, 0x4c, 0x91, 0x01, 0xdd, 0x72,
+    0xfa, 0x94, 0x69, 0x9d, 0x56, 0xb6, 0x88, 0x56, 0xc0, 0x26, 0xa1, 0x8a, 0x99, 0xf0, 0x0d, 0x77,
+    0x54, 0xab, 0x83, 0x6a, 0xf5, 0xb5, 0x02, 0xe7, 0x94, 0xad, 0x2c, 0x58, 0xfd, 0xa2, 0xbe, 0x08,
+    0x5a, 0x54, 0x4b, 0x8a, 0x0f, 0x33, 0xbf, 0xec, 0x34, 0xc1, 0x4a, 0xa9, 0x41, 0x17, 0x3d, 0xe1,
+    0xb1, 0x29, 0x9b, 0xe0, 0x73, 0x44, 0xd2, 0x3c, 0xd6, 0x2e, 0xd9, 0xe2, 0x50, 0x42, 0x36, 0x75,
+    0x3a, 0xa4, 0xb9, 0xed, 0x8e, 0x48, 0x8e, 0xd8, 0x27, 0x04, 0x80, 0x2d, 0x58, 0x5f, 0xc3, 0xc2,
+    0x80, 0x5b, 0xa0, 0x0c, 0x6c, 0x01, 0x41, 0x4d, 0x31, 0x28, 0x36, 0x43, 0x46, 0xca, 0xf4, 0x02,
+    0xc4, 0x81, 0x15, 0x14, 0xd5, 0x40, 0x9a, 0x99, 0x39, 0x8e, 0xce, 0x47, 0xdd, 0x2b, 0x89, 0xb8,
+    0x59, 0x12, 0x06, 0x66, 0xdf, 0x0b, 0x96, 0xd9, 0x1b, 0x7b, 0x6a, 0x60, 0x5b, 0x88, 0x00, 0xe5,
+    0x70, 0x35, 0xb0, 0x1a, 0xf3, 0xae, 0x8b, 0x26, 0xf6, 0xfa, 0xde, 0x8c, 0x19, 0x23, 0x1d, 0x35,
+    0xed, 0x5d, 0xe0, 0x1a, 0x6a, 0x82, 0x10, 0xae, 0x80, 0xd2, 0xef, 0xaf, 0x1e, 0xe9, 0xf7, 0x6f,
+    0x3e, 0x73, 0xc4, 0x86, 0x41, 0xf9, 0xd2, 0x05, 0xdf, 0x25, 0x79, 0xfe, 0x3c, 0x87, 0x63, 0x0a,
+    0xde, 0x13, 0x03, 0x9e, 0x0d, 0xa3, 0x36, 0xb1, 0x3f, 0xf5, 0x3a, 0x99, 0x7b, 0x5c, 0x93, 0x91,
+    0x54, 0xe4, 0x18, 0xeb, 0x84, 0x31, 0xde, 0x07, 0x8e, 0x16, 0x1d, 0x90, 0x8f, 0xfc, 0x69, 0x65,
+    0x83, 0xf9, 0xc9, 0xee, 0x96, 0x39, 0x52, 0x54, 0x0c, 0x06, 0x02, 0x88, 0x6d, 0xa3, 0x9c, 0xd9,
+    0xb4, 0xc0, 0xe2, 0xf3, 0x05, 0x66, 0xb8, 0x83, 0xdf, 0xf2, 0x6f, 0x67, 0xbb, 0x70, 0x92, 0x14,
+    0x76, 0xa1, 0x18, 0x6b, 0x47, 0x31, 0x82, 0xe4, 0x8c, 0x61, 0x37, 0x4d, 0x52, 0x0f, 0xc4, 0xcd,
+    0x98, 0xcd, 0xd3, 0xc4, 0x8f, 0x09, 0x0d, 0x58, 0x9c, 0x09, 0x03, 0x50, 0x8a, 0xab, 0xc0, 0xb2,
+    0x52, 0x4a, 0xf7, 0x13, 0xeb, 0x48, 0xb2, 0xb7, 0x84, 0xef, 0x9f, 0xfc, 0x84, 0xa7, 0x91, 0x1a,
+    0xc7, 0x69, 0xe0, 0x80, 0xf1, 0x7f, 0x9e, 0x5d, 0xf4, 0xfb, 0xbf, 0x1f, 0xad, 0xa0, 0x83, 0x94,
+    0x91, 0x17, 0xc7, 0x05, 0xca, 0x33, 0x58, 0x70, 0x94, 0xed, 0xbb, 0x25, 0xe0, 0xba, 0x12, 0x93,
+    0x66, 0x74, 0xca, 0x73, 0xcb, 0xc8, 0xaa, 0xb4, 0xc9, 0xf5, 0xbd, 0xf3, 0xd6, 0x59, 0x60, 0xf2,
+    0xd6, 0xd8, 0xb6, 0x3e, 0x5d, 0x01, 0xad, 0x24, 0x34, 0xa1, 0xba, 0x4d, 0x98, 0x86, 0x06, 0x94,
+    0x02, 0x92, 0xc7, 0xc3, 0x85, 0x2a, 0x1c, 0x86, 0xf5, 0x9a, 0x29, 0xba, 0xb5, 0x19, 0x8f, 0xf9,
+    0x80, 0x07, 0x5c, 0x2f, 0x80, 0xd0, 0x1d, 0xc7, 0x64, 0xb6, 0xe1, 0x4c, 0xde, 0x10, 0x6a, 0x68,
+    0x02, 0x18, 0x2f, 0xf7, 0x08, 0x9d, 0x70, 0xdf, 0x67, 0x82, 0x2e, 0x79, 0xe1, 0x23, 0x1b, 0x48,
+    0xa9, 0xd3, 0x1a, 0x0b, 0x63, 0xe8, 0x88, 0xab, 0xb0, 0x4c, 0x0f, 0x14, 0x23, 0x0b, 0x39, 0x25,
+    0xf1, 0xd4, 0x3e, 0xcc, 0x3d, 0x28, 0x25, 0x5a, 0x12, 0x65, 0x0e, 0x40, 0x2a, 0x30, 0x72, 0xdc,
+    0x3f, 0xdb, 0x6e, 0xbd, 0xa1, 0x95, 0xfb, 0x14, 0x3e, 0xb2, 0x06, 0xc1, 0x84, 0xe5, 0x1a, 0x1c,
+    0x09, 0x9e, 0xb4, 0x18, 0x64, 0xe3, 0x0f, 0x38, 0x3b, 0x41, 0xc0, 0xb4, 0x2f, 0x90, 0x48, 0x15,
+    0xf3, 0xc1, 0xae, 0xd4, 0x2a, 0xc5, 0xd0, 0xbf, 0xa7, 0x76, 0x58, 0x2a, 0x0b, 0xa7, 0x5f, 0x18,
+    0x8f, 0x91, 0xfa, 0x1c, 0xb2, 0x18, 0x5c, 0x0b, 0x5b, 0x73, 0x1e, 0x04, 0x96, 0x9a, 0x70, 0x41,
+    0xd0, 0x59, 0x02, 0x3d, 0x05, 0x7e, 0x01, 0x20, 0x7c, 0xd3, 0x0b, 0xca, 0xc2, 0x14, 0x48, 0x03,
+    0xa7, 0xc1, 0x31, 0xa6, 0x1b, 0x94, 0xe2, 0x42, 0x30, 0xf5, 0xf6, 0xfc, 0xf4, 0x1d, 0x08, 0x01,
+    0x51, 0x49, 0xce, 0x98, 0xd3, 0x8d, 0x4a, 0x09, 0xc6, 0x32, 0x0f, 0x95, 0xab, 0x25, 0xe2, 0xd2,
+    0x66, 0x15, 0x27, 0xed, 0x45, 0x4e, 0x35, 0xe4, 0x57, 0x2e, 0x1c, 0x0b, 0x36, 0x94, 0x45, 0xb5,
+    0x59, 0x69, 0x5f, 0x6f, 0xc1, 0x34, 0xd7, 0x68, 0x98, 0x08, 0x2a, 0x6e, 0x37, 0x1b, 0xb6, 0x4c,
+    0xa6, 0x10, 0x78, 0x51, 0x14, 0x2c, 0x6c, 0x03, 0xc4, 0x44, 0x74, 0x10, 0x04, 0x5c, 0x30, 0x4c,
+    0x1f, 0x93, 0x9c, 0xb6, 0x8c, 0x97, 0xeb, 0x5f, 0x54, 0x7d, 0xbc, 0x45, 0x11, 0xd7, 0x08, 0xe2,
+    0xa9, 0x4c, 0x93, 0x38, 0xc5, 0xe2, 0x55, 0xc6, 0x43, 0x1c, 0x0e, 0x34, 0xda, 0xf0, 0xb1, 0x9f,
+    0x9c, 0xaf, 0x05, 0x4c, 0x8c, 0xf5, 0x04, 0x56, 0x5e, 0xbc, 0x70, 0x8c, 0xc5, 0x0c, 0x88, 0xcc,
+    0xee, 0x5f, 0xfc, 0x6f, 0x9b, 0xb0, 0x8e, 0x5d, 0x87, 0xda, 0x46, 0x20, 0x66, 0xf6, 0x28, 0x96,
+    0x8b, 0x56, 0xa5, 0x84, 0x97, 0x1e, 0x2e, 0x5c, 0xda, 0xe6, 0x22, 0x5e, 0xcc, 0xfe, 0x6a, 0xfc,
+    0x9d, 0x1e, 0x82, 0x67, 0x13, 0xd7, 0x69, 0x1a, 0x80, 0xcc, 0x34, 0x73, 0x70, 0xbf, 0x89, 0xb4,
+    0xd7, 0x04, 0x01, 0x25, 0xc5, 0x23, 0x49, 0x11, 0x4c, 0xe8, 0x5d, 0xd9, 0x5c, 0x73, 0x20, 0x6b,
+    0x50, 0x58, 0xa0, 0x0d, 0x81, 0x33, 0xd2, 0xe9, 0x00, 0x2b, 0xf1, 0x74, 0x10, 0x6b, 0x55, 0x0e,
+    0xc0, 0x19, 0x86, 0xf9, 0x13, 0xc3, 0x19, 0x12, 0x32, 0xef, 0xf9, 0x02, 0x69, 0x63, 0x0b, 0x89,
+    0xdb, 0xa5, 0x34, 0x69, 0x97, 0x42, 0xb6, 0xa8, 0xf3, 0x1a, 0x11, 0x2f, 0xbe, 0x43, 0xc4, 0xd3,
+    0xd6, 0x7f, 0x5e, 0x67, 0x32, 0xd6, 0x73, 0x59, 0x77, 0xce, 0xcc, 0x83, 0xd4, 0xf5, 0xdd, 0x7c,
+    0xb5, 0xca, 0x0f, 0x5b, 0x6e, 0xc4, 0x88, 0x6d, 0xca, 0xe7, 0xc6, 0x32, 0x48, 0x69, 0xd3, 0x24,
+    0x4d, 0xa6, 0x40, 0xb8, 0x48, 0xe1, 0x2e, 0x2e, 0xb9, 0x92, 0x6b, 0xc6, 0xa5, 0x7c, 0x98, 0x32,
+    0x9c, 0x5f, 0xbd, 0xe5, 0x40, 0x5e, 0x1e, 0xe6, 0xee, 0x5a, 0x6a, 0x84, 0x82, 0x89, 0x7d, 0x01,
+    0x1a, 0x6b, 0x06, 0xd7, 0x68, 0x51, 0x94, 0xed, 0xaa, 0x1d, 0x52, 0x1a, 0xba, 0x3e, 0xd2, 0x75,
+    0x3a, 0x2f, 0xb1, 0x9f, 0x99, 0xe2, 0x03, 0xdf, 0xa7, 0x71, 0xa7, 0xd3, 0x82, 0x74, 0x5b, 0x52,
+    0x33, 0x39, 0x13, 0x47, 0x52, 0xc4, 0xec, 0x1c, 0x33, 0xab, 0x5d, 0xc8, 0xe1, 0xa2, 0xbe, 0x5b,
+    0xe4, 0xf5, 0x8e, 0xcb, 0xcd, 0xac, 0x85, 0xf4, 0x8e, 0x8b, 0xf5, 0x0f, 0xa6, 0x20, 0xd3, 0xbd,
+    0xe2, 0x9a, 0xbe, 0x5a, 0x57, 0x06, 0x93, 0x11, 0x16, 0x86, 0x6d, 0x3b, 0x64, 0xef, 0xd7, 0xed,
+    0x3b, 0x05, 0x7c, 0x0d, 0x00, 0x1f, 0xe6, 0x16, 0x8f, 0x9f, 0x0a, 0xff, 0x40, 0x29, 0xf3, 0x3b,
+    0x34, 0xbd, 0xd5, 0xe2, 0xab, 0x85, 0x00, 0x6e, 0x00, 0xa2, 0x43, 0x5f, 0x53, 0xe2, 0xa8, 0x89,
+    0xf1, 0x79, 0x87, 0xda, 0x3b, 0xa0, 0xb9, 0x0b, 0x51, 0x62, 0x6e, 0x3e, 0x1d, 0x0a, 0x55, 0xe6,
+    0x19, 0xcd, 0xf1, 0xb3, 0xcb, 0xad, 0x9d, 0x67, 0xd4, 0x9d, 0x5b, 0xbe, 0x9f, 0x90, 0x1c, 0x23,
+    0x94, 0x72, 0xea, 0x8d, 0x05, 0x83, 0x0b, 0x0b, 0xc1, 0x8c, 0xe3, 0xc2, 0x94, 0xbe, 0xbd, 0xd2,
+    0x3e, 0x17, 0x11, 0x80, 0x84, 0xfa, 0x99, 0xc4, 0x24, 0x7a, 0x11, 0x59, 0x66, 0x14, 0x7a, 0x11,
+    0xcc, 0x54, 0x11, 0x40, 0x1b, 0x77, 0xa8, 0x9d, 0xbe, 0x9a, 0x15, 0x4a, 0xc8, 0x30, 0xf0, 0xcc,
+    0x92, 0xbd, 0xfc, 0x01, 0x77, 0xb2, 0x5f, 0x37, 0x8c, 0x10, 0x81, 0x29, 0xdc, 0xc3, 0x45, 0xca,
+    0xd1, 0x4c, 0x34, 0xc0, 0x09, 0x64, 0x0e, 0x2f, 0x53, 0x36, 0x8d, 0x0a, 0xed, 0xf6, 0x99, 0xde,
+    0xaf, 0x27, 0xd4, 0x08, 0xa0, 0xf6, 0x0b, 0xa6, 0xed, 0x34, 0x32, 0xd3, 0x96, 0x2c, 0xd9, 0x4f,
+    0xae, 0x64, 0x19, 0xa6, 0xe6, 0x3b, 0xa8, 0x8e, 0x5f, 0x3a, 0xf4, 0x33, 0x53, 0x31, 0xc6, 0x69,
+    0xab, 0x01, 0xb1, 0xb2, 0xd3, 0x42, 0x88, 0x7b, 0x3c, 0x1c, 0xc0, 0x98, 0x7b, 0xc4, 0x01, 0x03,
+    0x19, 0x03, 0x08, 0xf1, 0x7e, 0xdd, 0x1c, 0x5a, 0x23, 0x78, 0x03, 0xa6, 0xc9, 0xfd, 0x6c, 0x19,
+    0x54, 0x9c, 0x98, 0x0a, 0x20, 0xba, 0x39, 0xa9, 0x80, 0x23, 0xde, 0xda, 0xd0, 0x87, 0x94, 0x98,
+    0xea, 0x3e, 0x81, 0xbb, 0x1a, 0x53, 0x1d, 0x0a, 0xee, 0x98, 0x4b, 0x75, 0x59, 0x84, 0xaf, 0xc0,
+    0xca, 0x0c, 0x3d, 0x96, 0x15, 0x4e, 0x3e, 0x40, 0xee, 0x6f, 0x64, 0x97, 0x11, 0x6c, 0x70, 0x07,
+    0x30, 0xfc, 0x43, 0x72, 0x51, 0xf0, 0x46, 0x32, 0xf2, 0xd1, 0x2e, 0x6e, 0xe4, 0xbc, 0x91, 0x3b,
+    0x95, 0x8c, 0x02, 0x17, 0x83, 0xc2, 0x31, 0x37, 0xa3, 0xd0, 0x2e, 0x49, 0x1e, 0x93, 0xc9, 0x83,
+    0xe4, 0x59, 0xa8, 0x14, 0xdc, 0x7a, 0x12, 0xb6, 0x36, 0x76, 0xd3, 0xe0, 0xdf, 0x2e, 0x86, 0xf7,
+    0x1a, 0xd0, 0xed, 0x8d, 0xbe, 0x80, 0x7a, 0xc1, 0xff, 0x4a, 0xea, 0xa1, 0x0e, 0xd2, 0x8e, 0x0f,
+    0x96, 0xbf, 0x65, 0x41, 0x20, 0xc9, 0xb2, 0x7b, 0x13, 0x0d, 0xea, 0x2e, 0x2d, 0x6f, 0x54, 0xeb,
+    0xf5, 0xad, 0x29, 0x45, 0x4c, 0x72, 0x92, 0x2c, 0x77, 0x33, 0x36, 0x5d, 0x17, 0x4f, 0x93, 0x82,
+    0x9d, 0xf1, 0x50, 0xa2, 0x0f, 0x61, 0x89, 0x76, 0x4f, 0x99, 0x87, 0x23, 0x1c, 0x0e, 0xf1, 0x40,
+    0x3c, 0x59, 0x22, 0x6e, 0x15, 0x89, 0x0f, 0x21, 0x6c, 0xfb, 0xa6, 0xf4, 0x91, 0x46, 0xad, 0xb6,
+    0x7d, 0xfb, 0x81, 0x3e, 0x0b, 0x46, 0x55, 0x0d, 0x75, 0xd7, 0x92, 0x3a, 0x23, 0x5d, 0xd2, 0x16,
+    0xdf, 0xf9, 0xb8, 0x17, 0x77, 0x89, 0x29, 0x13, 0x02, 0x8f, 0x09, 0xd7, 0x97, 0xd4, 0x1d, 0xc8,
+    0xde, 0xb6, 0x20, 0x51, 0x3f, 0x82, 0xc2, 0x01, 0x3a, 0x41, 0x11, 0x8c, 0xa5, 0xb2, 0x5e, 0xce,
+    0xfc, 0x81, 0xf3, 0x80, 0xd1, 0x96, 0x76, 0x33, 0x17, 0x18, 0x9a, 0x5c, 0x44, 0xb9, 0xa1, 0x21,
+    0x1f, 0x50, 0xee, 0x3a, 0x88, 0x2e, 0x34, 0xd3, 0x37, 0x1a, 0x5e, 0x28, 0x0f, 0x13, 0xeb, 0xa6,
+    0x44, 0xab, 0xdc, 0xbb, 0x19, 0x3c, 0x72, 0xf0, 0x8d, 0x87, 0x53, 0x3d, 0xd9, 0x22, 0xcf, 0x7d,
+    0x36, 0x6e, 0x93, 0x63, 0x22, 0x47, 0xe4, 0x3d, 0xc9, 0x72, 0xdb, 0x8a, 0x3d, 0xf8, 0x46, 0x0b,
+    0x0c, 0x6c, 0x00, 0x42, 0x23, 0xda, 0x69, 0x98, 0xac, 0x29, 0xd4, 0x02, 0x58, 0x6e, 0x36, 0xba,
+    0xd9, 0xe2, 0x7a, 0xd1, 0x7d, 0x68, 0x69, 0x2c, 0x5c, 0x95, 0xd5, 0x07, 0x0b, 0x36, 0x49, 0x6b,
+    0x81, 0xb4, 0xea, 0xea, 0x89, 0xf3, 0xbe, 0x05, 0x6f, 0xe9, 0x58, 0xb7, 0x0a, 0x3f, 0x37, 0x29,
+    0xb7, 0xec, 0x64, 0xfb, 0x9e, 0x35, 0xf1, 0xea, 0x26, 0xc5, 0xe1, 0x22, 0x39, 0x33, 0x5d, 0xc0,
+    0xa1, 0xf6, 0x29, 0x5a, 0xb5, 0xe2, 0x78, 0xc5, 0x86, 0x1c, 0x64, 0x0f, 0x44, 0xac, 0xb7, 0x50,
+    0x72, 0x55, 0x52, 0xef, 0x01, 0x78, 0xf5, 0x1e, 0x09, 0xaf, 0x62, 0x1a, 0x6c, 0xd2, 0xfb, 0x9c,
+    0x85, 0x11, 0x53, 0xb0, 0xa6, 0x98, 0x85, 0xec, 0x70, 0xd5, 0x0c, 0x24, 0xda, 0x1c, 0x64, 0xdd,
+    0xea, 0x83, 0x10, 0x4b, 0x7a, 0xb7, 0x0c, 0x19, 0x54, 0xc3, 0x55, 0x91, 0xa7, 0x0f, 0x40, 0xee,
+    0xf4, 0x67, 0x46, 0x1a, 0x36, 0x19, 0xe8, 0x5a, 0x63, 0x01, 0x39, 0xfd, 0x11, 0xda, 0x23, 0x29,
+    0xfb, 0xbf, 0x85, 0x95, 0x55, 0x43, 0xe6, 0x7c, 0xc4, 0x6f, 0xc0, 0xee, 0x61, 0xd1, 0x76, 0x30,
+    0x1c, 0xb2, 0x80, 0xa9, 0x4d, 0xe0, 0x1d, 0x3c, 0x00, 0xbc, 0x83, 0x1f, 0x12, 0x76, 0xb9, 0xea,
+    0xdb, 0xdc, 0x50, 0x7d, 0x73, 0x65, 0xd0, 0x95, 0xff, 0x9d, 0x07, 0xf5, 0xcd, 0xdc, 0x2d, 0xf9,
+    0xd7, 0xf6, 0x4c, 0x92, 0xff, 0xd9, 0xd0, 0x3f, 0x57, 0x3a, 0x9c, 0x9a, 0xc9, 0xe6, 0x9a, 0x4e,
+    0xd8, 0x2c, 0xd2, 0xb9, 0xf1, 0xf4, 0x2e, 0x3d, 0x13, 0x38, 0xb6, 0xee, 0xcd, 0xf1, 0x6e, 0xad,
+    0x95, 0xac, 0x78, 0x77, 0x7b, 0x83, 0x77, 0x93, 0x29, 0x75, 0xa5, 0xa7, 0xf6, 0xee, 0xd0, 0x52,
+    0x7b, 0xab, 0x1d, 0xb5, 0x97, 0x35, 0xd4, 0xb7, 0x10, 0xfc, 0xf7, 0x68, 0xa6, 0xd1, 0x14, 0x6f,
+    0xa7, 0xc9, 0x65, 0x1b, 0x0a, 0x5d, 0xc8, 0x87, 0x4a, 0xb6, 0xe3, 0xa5, 0xd4, 0xe9, 0x5d, 0x9c,
+    0x4a, 0xdd, 0x3c, 0x93, 0xf1, 0xa6, 0xe4, 0xd9, 0xc6, 0x8e, 0x8a, 0x19, 0xb1, 0x26, 0x6d, 0x71,
+    0x2f, 0x3f, 0xea, 0xa6, 0xcc, 0xcc, 0xcb, 0x6b, 0x3b, 0xf0, 0x8a, 0x69, 0x38, 0x60, 0x6a, 0xf9,
+    0x16, 0x62, 0x5e, 0xa6, 0xd3, 0xd5, 0x2b, 0x08, 0x80, 0xdf, 0xa1, 0xaf, 0x1a, 0x30, 0x14, 0x87,
+    0xde, 0x15, 0x78, 0xf8, 0x25, 0x3e, 0xa2, 0xad, 0x6e, 0x10, 0xbe, 0xa5, 0x4c, 0xdc, 0xdd, 0xe8,
+    0xd6, 0x1a, 0xa3, 0x1f, 0x6e, 0x75, 0xeb, 0x67, 0x58, 0xfd, 0xa0, 0xaa, 0x0d, 0xbc, 0x61, 0xa8,
+    0x0a, 0x2d, 0x32, 0xeb, 0xbc, 0x7f, 0x8a, 0x97, 0x89, 0xc7, 0x02, 0x02, 0xb9, 0xfd, 0x3a, 0xf7,
+    0xdf, 0x6a, 0x6c, 0xeb, 0x51, 0x8d, 0x6d, 0xfd, 0x0c, 0x63, 0x1f, 0x36, 0xe5, 0x00, 0xcb, 0xdb,
+    0xdc, 0xee, 0x5d, 0x3d, 0xa6, 0xdb, 0xbd, 0xab, 0x5f, 0xe8, 0xf6, 0xdb, 0x8c, 0x6d, 0x3d, 0xaa,
+    0xb1, 0xad, 0x47, 0x37, 0xf6, 0xbe, 0xb9, 0x7e, 0x3b, 0x24, 0xde, 0x37, 0x32, 0x84, 0xfe, 0x3d,
+    0x50, 0xf9, 0xbb, 0x41, 0xfd, 0xc6, 0x2e, 0x70, 0xf0, 0x6d, 0xcd, 0x10, 0x75, 0x0f, 0x94, 0x1e,
+    0x5d, 0xa3, 0xd6, 0xe3, 0x68, 0x74, 0x4b, 0x02, 0xdd, 0xae, 0x39, 0x74, 0xf0, 0xfb, 0x62, 0x79,
+    0x1c, 0xfc, 0x50, 0x2c, 0xef, 0xaf, 0x51, 0xeb, 0x71, 0x34, 0xfa, 0xde, 0xb0, 0xcc, 0x69, 0x4d,
+    0x20, 0x21, 0xa4, 0xc2, 0xb0, 0xa8, 0x83, 0x3d, 0x5b, 0xe4, 0xd9, 0x5a, 0x20, 0x41, 0xe9, 0x63,
+    0xa5, 0x7e, 0x1c, 0x92, 0xf7, 0x55, 0xa8, 0xf5, 0x48, 0x0a, 0x7d, 0x77, 0x50, 0xe6, 0x15, 0x1f,
+    0x71, 0xbd, 0xa2, 0x2b, 0xe8, 0x79, 0xc2, 0xf5, 0x23, 0x00, 0x77, 0xcb, 0xe3, 0x0d, 0xf7, 0x8b,
+    0x6c, 0xd1, 0xbe, 0x4f, 0xaf, 0x27, 0xff, 0xb9, 0xf7, 0x7f, 0x33, 0x07, 0x51, 0xc7, 0xd1, 0x27,
+    0x00, 0x00,
+};
+
+#endif // _MAINPAGE_H
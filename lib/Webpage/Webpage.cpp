@@ -35,17 +35,32 @@
 
 #include "NV.h"
 #include "Webpage.h"
+#include "MainPage.h"
+#include "Status.h"
+#include "Telemetry.h"
+#include "Metrics.h"
 #include "Sensor.h"
 #include "Gimbal.h"
 #include "Easycomm.h"
+#include "Tracker.h"
+#include "Power.h"
 
-uint8_t wifi_time_out; //< time between checks for active WiFi
+uint32_t wifi_time_out; //< millis() of last attempt to join WiFi
 
 /*! constructor
  */
 Webpage::Webpage()
 {
-    wifi_time_out = 0;
+    wifi_time_out = millis();
+    use_builtin = false;
+    rejoin_at = 0;
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        conns[i].open = false;
+    }
+    push_interval = PUSH_INTERVAL;
+    last_push = last_heartbeat = millis();
+    cur_values = 0;
+    values[0][0] = values[1][0] = '\0';
     //< init user message mechanism
 	user_message_F = F("Hello+");		// <page welcome message
     memset (user_message_s, 0, sizeof(user_message_s));
@@ -53,11 +68,28 @@ Webpage::Webpage()
     //< start the Server on port 80
 	httpServer = new WiFiServer(80);
     delay(1000);
-	WiFi.begin (WIFI_SSID, WIFI_PASS);
+	beginWiFi();
     delay(1000);
 	httpServer->begin();
 }
 
+/*! @brief start joining the network saved in NV, or the built-in one if none is saved
+*
+* With a saved network, retries alternate with the built-in one, so a mistyped password
+* cannot leave the rotator unreachable.
+*/
+void Webpage::beginWiFi()
+{
+	nv->get();
+	bool _saved = nv->wifi_ssid[0] != '\0';
+	if (_saved && !use_builtin) {
+	    WiFi.begin (nv->wifi_ssid, nv->wifi_pass);
+	} else {
+	    WiFi.begin (WIFI_SSID, WIFI_PASS);
+	}
+	use_builtin = _saved && !use_builtin;
+}
+
 /*! @brief record a brief F() message to inform the user
 *
 * Message will be sent on the next sendNewValues() sweep
@@ -81,700 +113,514 @@ void Webpage::setUserMessage (const __FlashStringHelper *ifsh, const char *msg,
 	user_message_s[strlen(user_message_s)] = state;
 }
 
-/*! @brief call this occasionally to check for Ethernet activity
+/*! @brief call this often to service WiFi and the browser connections
+*
+* Never blocks waiting on a client: each connection reads whatever has arrived and picks up
+* where it left off next time.
  */
 void Webpage::checkEthernet()
 {
-    //< check WiFi if not connected and waited > 5 seconds
-    if (WiFi.status() != WL_CONNECTED && (wifi_time_out++ > 25)) {
-        WiFi.begin (WIFI_SSID, WIFI_PASS);
-        wifi_time_out = 0;
+	uint32_t _t0 = Metrics::start();
+    //< check WiFi if not connected and waited long enough
+    if (WiFi.status() != WL_CONNECTED && millis() - wifi_time_out > TIMEOUT_WIFI) {
+        beginWiFi();
+        wifi_time_out = millis();
     }
-	//< now check our page
-	WiFiClient client = httpServer->available();
-	if (!client) {
-	    return;
+    //< join the newly saved network, once this page has had its answer
+    if (rejoin_at != 0 && (int32_t)(millis() - rejoin_at) >= 0) {
+        rejoin_at = 0;
+        use_builtin = false;
+        WiFi.disconnect();
+        beginWiFi();
+        wifi_time_out = millis();
     }
-	uint32_t to = millis();	//< init timeout
-	char firstline[128];	//< first line
-	unsigned fll = 0;		//< firstline length
-	bool eoh = false;		//< set when see end of header
-	bool fldone = false;	//< set when finished collecting first line
-	char c, prevc = 0;		//< new and previous character read from client
+	//< accept new connections into free slots
+	WiFiClient client;
+	while ((client = httpServer->available())) {
+	    Connection *_cp = freeConnection();
+	    if (!_cp) {
+		    client.stop();		//< full; browser will retry
+		    break;
+	    }
+	    _cp->client = client;
+	    resetConnection (*_cp);
+	    _cp->open = true;
+	}
+	//< service the ones we have
+	for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+	    Connection &_c = conns[i];
+	    if (!_c.open) {
+		    continue;
+	    }
+	    if (_c.downloading) {
+		    serviceDownload (_c);
+	    } else if (!_c.streaming) {
+		    serviceConnection (_c);
+	    }
+	    uint32_t _idle = millis() - _c.last;
+	    if (!_c.client.connected() || (!_c.streaming && _idle > (_c.started ? REQUEST_TIMEOUT : KEEP_ALIVE))) {
+		    _c.client.stop();
+		    _c.open = false;
+	    }
+	}
+	pushValues();
+	metrics->stop (M_WEB, _t0);
+}
 
-	//< read header, collecting first line and discarding rest until find blank line
-	while (!eoh && (c = readNextClientChar (client, &to))) {
-	    if (c == '\n') {
-		    if (!fldone) {
-		        firstline[fll] = '\0';
-		        fldone = true;
-		    }
-		    if (prevc == '\n') {
-		        eoh = true;
-            }
-	    } else if (!fldone && fll < sizeof(firstline)-1) {
-		    firstline[fll++] = c;
+/*! @brief find a slot for a new connection, closing the longest idle one if all are in use
+*
+* @return the slot, or NULL if every connection is in the middle of a request
+*/
+Webpage::Connection *Webpage::freeConnection()
+{
+	Connection *_oldest = NULL;
+	for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+	    if (!conns[i].open) {
+		    return (&conns[i]);
+	    }
+	    if (!conns[i].started && !conns[i].streaming && (!_oldest || (int32_t)(conns[i].last - _oldest->last) < 0)) {
+		    _oldest = &conns[i];
 	    }
-	    prevc = c;
 	}
-	if (c == 0) {
-	    client.stop();
-	    return;
+	if (_oldest) {
+	    _oldest->client.stop();
+	    _oldest->open = false;
+	}
+	return (_oldest);
+}
+
+/*! @brief get a connection ready to read its next request
+* @param c the connection
+*/
+void Webpage::resetConnection (Connection &c)
+{
+	c.request[0] = '\0';
+	c.ll = 0;
+	c.nbody = 0;
+	c.body_left = 0;
+	c.reading_body = false;
+	c.started = false;
+	c.keep_alive = false;
+	c.streaming = false;
+	c.downloading = false;
+	c.last = millis();
+}
+
+/*! @brief read whatever the client has sent and answer once a whole request is in
+*
+* Collects the request line, notes Connection: and Content-Length:, discards the other headers,
+* then collects Content-Length bytes of body. '\r' is discarded completely.
+* @param c the connection
+*/
+void Webpage::serviceConnection (Connection &c)
+{
+	while (c.open && c.client.available()) {
+	    char _ch = c.client.read();
+	    c.last = millis();
+	    c.started = true;
+	    if (c.reading_body) {
+		    if (_ch != '\r' && _ch != '\n' && c.nbody < sizeof(c.body)-1) {
+		        c.body[c.nbody++] = _ch;
+		    }
+		    if (--c.body_left == 0) {
+		        c.body[c.nbody] = '\0';
+		        answerRequest (c);
+		    }
+		    continue;
+	    }
+	    if (_ch == '\r') {
+		    continue;
+	    }
+	    if (_ch != '\n') {
+		    if (c.ll < sizeof(c.line)-1) {
+		        c.line[c.ll++] = _ch;
+		    }
+		    continue;
+	    }
+	    c.line[c.ll] = '\0';
+	    if (c.ll == 0) {
+		    //< blank line: end of header
+		    if (c.body_left > 0) {
+		        c.reading_body = true;
+		    } else {
+		        c.body[0] = '\0';
+		        answerRequest (c);
+		    }
+	    } else if (c.request[0] == '\0') {
+		    //< first line; HTTP/1.1 connections stay open unless asked otherwise
+		    strcpy (c.request, c.line);
+		    c.keep_alive = strstr (c.line, "HTTP/1.1") != NULL;
+	    } else if (strncasecmp (c.line, "Connection:", 11) == 0) {
+		    if (strcasestr (c.line, "close")) {
+		        c.keep_alive = false;
+		    } else if (strcasestr (c.line, "keep-alive")) {
+		        c.keep_alive = true;
+		    }
+	    } else if (strncasecmp (c.line, "Content-Length:", 15) == 0) {
+		    c.body_left = atoi (c.line + 15);
+	    }
+	    c.ll = 0;
 	}
+}
 
-	//< client socket is now at first character after blank line
+/*! @brief act on a complete request then close or get ready for the next one
+* @param c the connection
+*/
+void Webpage::answerRequest (Connection &c)
+{
 	//< replace trailing ?time cache-buster with blank
-	char *q = strrchr (firstline, '?');
+	char *q = strrchr (c.request, '?');
 	if (q) {
 	    *q = ' ';
     }
 	//< what we do next depends on first line
-	if (strstr (firstline, "GET / ")) {
-	    sendMainPage (client);
-	} else if (strstr (firstline, "GET /getvalues.txt ")) {
-	    sendNewValues (client);
-	} else if (strstr (firstline, "POST / ")) {
-	    overrideValue (client);
-	    sendEmptyResponse (client);
-	} else if (strstr (firstline, "POST /reboot ")) {
-	    sendEmptyResponse (client);
+	if (strstr (c.request, "GET / ")) {
+	    sendMainPage (c.client, c.keep_alive);
+	} else if (strstr (c.request, "GET /events ")) {
+	    //< push channel: this connection now belongs to pushValues()
+	    sendHeader (c.client, "200 OK", "text/event-stream", -1, false, true);
+	    c.streaming = true;
+	    c.need_full = true;
+	    return;
+	} else if (strstr (c.request, "GET /status.bin ")) {
+	    StatusRecord _s;
+	    buildStatus (_s);
+	    sendHeader (c.client, "200 OK", "application/octet-stream", sizeof(_s), false, c.keep_alive,
+			    (const uint8_t *)&_s);
+	} else if (strstr (c.request, "GET /telemetry.bin ")) {
+	    //< header now, records a chunk per call from serviceDownload() so tracking carries on
+	    c.dl_next = telemetry->first();
+	    c.dl_end = telemetry->last();
+	    c.dl_sent = 0;
+	    TelemetryHeader _h;
+	    telemetry->header (_h, c.dl_end - c.dl_next);
+	    sendHeader (c.client, "200 OK", "application/octet-stream",
+			    sizeof(_h) + (c.dl_end - c.dl_next) * sizeof(TelemetryRecord), false, c.keep_alive);
+	    c.client.write ((const uint8_t *)&_h, sizeof(_h));
+	    c.downloading = true;
+	    return;
+	} else if (strstr (c.request, "GET /metrics ")) {
+	    sendMetrics (c.client);
+	    c.client.stop();
+	    c.open = false;
+	    return;
+	} else if (strstr (c.request, "GET /getvalues.txt ")) {
+	    sendNewValues (c.client, c.keep_alive);
+	} else if (strstr (c.request, "POST / ")) {
+	    overrideValue (c.body);
+	    sendEmptyResponse (c.client, c.keep_alive);
+	} else if (strstr (c.request, "POST /reboot ")) {
+	    sendEmptyResponse (c.client, false);
+	    c.client.stop();
 	    reboot();
 	} else {
-	    send404Page (client);
+	    send404Page (c.client, c.keep_alive);
+	}
+	if (c.keep_alive) {
+	    resetConnection (c);
+	} else {
+	    c.client.stop();
+	    c.open = false;
 	}
-	//< finished
-	client.stop();
 }
 
-/*! @brief read next character, return 0 if client disconnects or times out.
+/*! @brief send the next chunk of a /telemetry.bin download
 *
-* '\r' is discarded completely.
-* @param client a reference to the calling WiFi client
-* @param to time when we started reading
+* Recording carries on meanwhile; records added since the download started are left for next time.
+* If the ring laps the download, which takes minutes of a stalled client, the body is cut short.
+* Only what the socket has room for is written, so a full TCP window never holds up loop(), and
+* the download moves on by what was actually written, a part of a record included.
+* @param c the connection
 */
-char Webpage::readNextClientChar (WiFiClient client, uint32_t *to)
+void Webpage::serviceDownload (Connection &c)
 {
-	static const int timeout = 1000;		//< client socket timeout, ms
-	while (client.connected()) {
-	    if (millis() > *to + timeout ) {
-		    return (0);
+	if (c.dl_next < telemetry->first()) {
+	    c.client.stop();
+	    c.open = false;
+	    return;
+	}
+	int _room = c.client.availableForWrite();
+	if (_room <= 0) {
+	    return;
+	}
+	//< whole records to cover the room, starting with the rest of a part-written one
+	uint32_t _want = (c.dl_sent + _room + sizeof(TelemetryRecord) - 1) / sizeof(TelemetryRecord);
+	TelemetryRecord _chunk[DL_CHUNK];
+	uint16_t _n = telemetry->copy (c.dl_next, _chunk, min (min ((uint32_t)DL_CHUNK, _want), c.dl_end - c.dl_next));
+	if (_n > 0) {
+	    size_t _len = min ((size_t)_room, _n * sizeof(TelemetryRecord) - c.dl_sent);
+	    size_t _w = c.client.write ((const uint8_t *)_chunk + c.dl_sent, _len);
+	    c.dl_next += (c.dl_sent + _w) / sizeof(TelemetryRecord);
+	    c.dl_sent = (c.dl_sent + _w) % sizeof(TelemetryRecord);
+	    if (_w > 0) {
+		    c.last = millis();
 	    }
-	    if (!client.available()){
+	}
+	if (c.dl_next < c.dl_end) {
+	    return;
+	}
+	if (c.keep_alive) {
+	    resetConnection (c);
+	} else {
+	    c.client.stop();
+	    c.open = false;
+	}
+}
+
+/*! @brief send the event streams whatever values have changed, every push_interval
+*
+* Each frame is one SSE message whose data lines are the NAME=VALUE lines of getvalues.txt.
+* A stream gets every value in its first frame, then only the lines that differ from the
+* previous frame. A comment line every HEARTBEAT keeps idle streams checked.
+ */
+void Webpage::pushValues()
+{
+	bool _any = false;
+	for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+	    _any |= conns[i].open && conns[i].streaming;
+	}
+	if (!_any || millis() - last_push < push_interval) {
+	    return;
+	}
+	last_push = millis();
+
+	//< render the latest values, keeping the previous ones to compare against
+	char *_now = values[cur_values];
+	char *_prev = values[!cur_values];
+	Response _r (_now, VALUES_SIZE);
+	buildValues (_r);
+	cur_values = !cur_values;
+
+	uint16_t _delta_len = buildFrame (frame, _now, _prev);
+	uint16_t _full_len = 0;
+	bool _heartbeat = millis() - last_heartbeat > HEARTBEAT;
+	for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+	    Connection &_c = conns[i];
+	    if (!_c.open || !_c.streaming) {
 		    continue;
-        }
-        char c = client.read();
-	    *to = millis();
-	    if (c == '\r'){
+	    }
+	    if (_c.need_full) {
+		    //< a full frame would overwrite the delta, so send any delta first and build it last
 		    continue;
-        }
-        return (c);
+	    }
+	    if (_delta_len > 0) {
+		    _c.client.write ((const uint8_t *)frame, _delta_len);
+	    } else if (_heartbeat) {
+		    _c.client.write ((const uint8_t *)":\n\n", 3);
+	    }
+	}
+	for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+	    Connection &_c = conns[i];
+	    if (_c.open && _c.streaming && _c.need_full) {
+		    if (_full_len == 0) {
+		        _full_len = buildFrame (frame, _now, NULL);
+		    }
+		    _c.client.write ((const uint8_t *)frame, _full_len);
+		    _c.need_full = false;
+	    }
+	}
+	if (_heartbeat) {
+	    last_heartbeat = millis();
 	}
-	return (0);
 }
 
-/*! @brief operator has entered manually a value to be overridden.
+/*! @brief format an SSE message holding each line of now that is not also in prev
 *
-* client is at beginning of NAME=VALUE line, parse and send to each subsystem
-* N.B. a few are treated specially.
-* @param client a reference to the calling WiFi client
+* @param buf receives the message, FRAME_SIZE
+* @param now latest values, '\n' separated NAME=VALUE lines
+* @param prev previous values to leave out, or NULL for all of now
+* @return message length, 0 if nothing changed
 */
-void Webpage::overrideValue (WiFiClient client)
+uint16_t Webpage::buildFrame (char *buf, const char *now, const char *prev)
 {
-	char c, buf[200];			//< must be at least enough for a typical input
-	uint8_t nbuf = 0;			//< type must be large enough to count to sizeof(buf)
-
-	//< read next line into buf
-	uint32_t to = millis();		//< initalize timeout
-	while ((c = readNextClientChar (client, &to)) != 0) {
-	    if (c == '\n') {
-		    buf[nbuf++] = '\0';
+	uint16_t _n = 0;
+	const char *_line = now;
+	while (*_line) {
+	    const char *_eol = strchr (_line, '\n');
+	    size_t _ll = _eol ? _eol - _line : strlen (_line);
+	    if (_ll > 0 && !(prev && hasLine (prev, _line, _ll)) && _n + _ll + 8 < FRAME_SIZE) {
+		    memcpy (buf + _n, "data: ", 6);
+		    memcpy (buf + _n + 6, _line, _ll);
+		    _n += 6 + _ll;
+		    buf[_n++] = '\n';
+	    }
+	    if (!_eol) {
 		    break;
-	    } else if (nbuf < sizeof(buf)-1) {
-		    buf[nbuf++] = c;
-        }
+	    }
+	    _line = _eol + 1;
 	}
-	if (c == 0) {
-	    return;		//< bogus; let caller close
-    }
+	if (_n > 0) {
+	    buf[_n++] = '\n';		//< blank line ends the message
+	}
+	return (_n);
+}
+
+/*! @brief whether text contains exactly the given line
+*
+* @param text '\n' separated lines
+* @param line start of the line to look for
+* @param len its length, without the '\n'
+*/
+bool Webpage::hasLine (const char *text, const char *line, size_t len)
+{
+	while (*text) {
+	    const char *_eol = strchr (text, '\n');
+	    size_t _tl = _eol ? _eol - text : strlen (text);
+	    if (_tl == len && strncmp (text, line, len) == 0) {
+		    return (true);
+	    }
+	    if (!_eol) {
+		    return (false);
+	    }
+	    text = _eol + 1;
+	}
+	return (false);
+}
+
+/*! @brief operator has entered manually a value to be overridden.
+*
+* parse the NAME=VALUE body and send to each subsystem
+* N.B. a few are treated specially.
+* @param buf the request body, modified in place
+*/
+void Webpage::overrideValue (char *buf)
+{
 	//< break at = into name, value
 	char *valu = strchr (buf, '=');
 	if (!valu) {
-	    return;		//< bogus; let caller close
+	    return;		//< bogus
     }
     *valu++ = '\0';	//< replace = with 0 then valu starts at next char
+	power->activity();	//< someone is at the controls
 	//< now buf is NAME and valu is VALUE
-    if (strcmp (buf, "Decl") == 0) {
+    if (strcmp (buf, "WP_Push") == 0) {
+	    //< event stream rate, ms
+	    push_interval = constrain (atoi (valu), (int)MIN_PUSH_INTERVAL, 10000);
+	} else if (strcmp (buf, "WP_SSID") == 0) {
+	    //< saved now, joined once the password follows
+	    strncpy (nv->wifi_ssid, valu, NV::WIFI_SSID_LEN - 1);
+	    nv->wifi_ssid[NV::WIFI_SSID_LEN - 1] = '\0';
+	    nv->put();
+	    setUserMessage (F("Saved WiFi network, now set its password+"));
+	} else if (strcmp (buf, "WP_Pass") == 0) {
+	    strncpy (nv->wifi_pass, valu, NV::WIFI_PASS_LEN - 1);
+	    nv->wifi_pass[NV::WIFI_PASS_LEN - 1] = '\0';
+	    nv->put();
+	    nv->flush();
+	    setUserMessage (F("Saved WiFi password, rejoining+"));
+	    rejoin_at = millis() + REJOIN_DELAY;
+	} else if (strcmp (buf, "Decl") == 0) {
 		nv->mag_decl = (float) atof(valu);
 	    nv->put();
 	    setUserMessage (F("Saved new magnetic declination+"));
 	} else {
     //< not ours, give to each other subsystem in turn until one accepts
 	    if (!sensor->overrideValue (buf, valu)
-			    && !gimbal->overrideValue (buf, valu)) {
+			    && !gimbal->overrideValue (buf, valu)
+			    && !tracker->overrideValue (buf, valu)
+			    && !telemetry->overrideValue (buf, valu)) {
 		    setUserMessage (F("Bug: unknown override -- see Serial Monitor!"));
         }
     }
 }
 
-/*! @brief inform each subsystem to send its latest values, including ours
+/*! @brief answer getvalues.txt with the latest values
 * @param client a reference to the calling WiFi client
+* @param keep_alive whether the connection stays open afterwards
  */
-void Webpage::sendNewValues (WiFiClient client)
-{
-    sendPlainHeader(client);
-    // send user message
-    client.print ("op_message=");
-    if (user_message_F != NULL){
-        client.println(user_message_F);
-    }
-    if (user_message_s[0]){
-        client.println(user_message_s);
-    }
-    client.print ("Decl=");
-	client.println(nv->mag_decl);
-    client.print ("SS_wifi=");
-    client.println(WiFi.RSSI());
-    sensor->sendNewValues(client);
-    gimbal->sendNewValues(client);
-    easycomm->sendNewValues(client);
-}
-
-/*! @brief print the HTML style section of main page
-* @param client a reference to the calling WiFi client
-*/
-
-void Webpage::printHTMLStyle (WiFiClient client)
-{
-    client.print(F(
-        "    <style> \r\n\r\n"
-        "        body { \r\n"
-        "            background-color:#888; \r\n"
-        "            font-family:sans-serif; \r\n"
-        "            font-size:13px; \r\n"
-        "        } \r\n"
-        "        table { \r\n"
-        "            border-collapse: collapse; \r\n"
-        "            border: 3px solid; \r\n"
-        "            border-color: #0036CC; \r\n"
-        "            background-color:#F8F8F8; \r\n"
-        "            float:left; \r\n"
-        "        } \r\n"
-        "        th { \r\n"
-        "            padding: 6px; \r\n"
-        "            border: 1px solid; \r\n"
-        "            border-color: #0036CC; \r\n"
-        "        } \r\n"
-        "        .even-row { \r\n"
-        "            background-color:#F8F8F8; \r\n"
-        "        } \r\n"
-        "        .odd-row { \r\n"
-        "            background-color:#D8D8D8; \r\n"
-        "        } \r\n"
-        "        #title-row { \r\n"
-        "            text-align: center; \r\n"
-        "            padding: 2px; \r\n"
-        "            border-bottom: 6px double; \r\n"
-        "            border-color: #0036CC; \r\n"
-        "        } \r\n"
-        "        #title-label { \r\n"
-        "            font-size: 18px; \r\n"
-        "            font-weight: bold; \r\n"
-        "            color: #0066CC; \r\n"
-        "        } \r\n"
-    ));
-    client.print (F(
-        "        #op_message { \r\n"
-        "            font-size:16px; \r\n"
-        "            display: block; \r\n"
-        "            padding: 10px; \r\n"
-        "        } \r\n"
-        "        td { \r\n"
-        "            padding: 6px; \r\n"
-        "            border: 1px solid; \r\n"
-        "            border-color: #0066CC; \r\n"
-        "        } \r\n"
-        "        .major-section { \r\n"
-        "            border-top: 6px double; \r\n"
-        "            border-color: #0036CC; \r\n"
-        "        } \r\n"
-        "        .minor-section { \r\n"
-        "            border-top: 4px double; \r\n"
-        "            border-color: #0036CC; \r\n"
-        "        } \r\n"
-        "        .override { \r\n"
-        "            background-color:#FFF; \r\n"
-        "            padding: 0px; \r\n"
-        "            font-family:monospace; \r\n"
-        "            resize:none; \r\n"
-        "            font-size:inherit; \r\n"
-        "            width:7em; \r\n"
-        "        } \r\n"
-        "        .group-head { \r\n"
-        "            text-align:center; \r\n"
-        "            vertical-align:top; \r\n"
-        "            border-right: 4px double; \r\n"
-        "            border-color: #0036CC; \r\n"
-        "        } \r\n"
-        "        .datum-label { \r\n"
-        "            text-align:left; \r\n"
-        "            vertical-align:top; \r\n"
-        "            color:black; \r\n"
-        "        } \r\n"
-        "        .datum { \r\n"
-        "            font-family:monospace; \r\n"
-        "            text-align:right; \r\n"
-        "            color:black \r\n"
-        "        } \r\n"
-        "        #tracking { \r\n"
-        "            font-size: 14px; \r\n"
-        "            font-weight: bold; \r\n"
-        "        } \r\n"
-        "    </style> \r\n"
-        " \r\n"
-    ));
-}
-/*! @brief print the Scripts section of the HTML page header
-*
-* @param client a reference to the calling WiFi client
-*
-*/
-void Webpage::printHTMLScripts (WiFiClient client)
-{        
-    client.print (F(            
-        "    <script> \r\n"
-        " \r\n"
-        "        // handy shortcut \r\n"
-        "        function byId (id) { \r\n"
-        "            return document.getElementById(id); \r\n"
-        "        } \r\n"
-        " \r\n"
-        "        // called once after DOM is loaded \r\n"
-        "        window.onload = function() { \r\n"
-        "            queryNewValues(); \r\n"
-        "        } \r\n"
-        " \r\n"
-        "        // handy function that modifies a URL to be unique so it voids the cache \r\n"
-        "        function UniqURL (url) { \r\n"
-        "            return (url + '?' + (new Date()).getTime()); \r\n"
-        "        } \r\n"
-        " \r\n"
-        "        // handy function to POST a name=value pair \r\n"
-        "        function POSTNV (name, value) { \r\n"
-        "            var xhr = new XMLHttpRequest(); \r\n"
-        "            xhr.open('POST', UniqURL('/'), true); \r\n"
-        "            xhr.send(name + '=' + String(value) + '\\r\\n'); \r\n"
-        "        } \r\n"
-    ));
-    client.print (F(
-        "        // send new value in response to operator typing an override value. \r\n"
-        "        function onOvd() { \r\n"
-        "            var event = this.event; \r\n"
-        "            if (event.keyCode == 13) { \r\n"
-        "                var oid = event.target.id; \r\n"
-        "                var nam = oid.replace ('_Ovd', ''); \r\n"
-        "                var vid = byId(nam); \r\n"
-        "                if (vid) { \r\n"
-        "                    var val = event.target.value.trim(); \r\n"
-        "                    POSTNV (nam, val); \r\n"
-        "                } \r\n"
-        "            } \r\n"
-        "        } \r\n"
-        "        // called to perform Gimbal calibration \r\n"
-        "        function onGSave() { \r\n"
-        "            POSTNV ('G_Save', 'true'); \r\n"
-        "        } \r\n"
-        " \r\n"        
-        "        // called to save Sensor calibration to EEPROM \r\n"
-        "        function onSSSave() { \r\n"
-        "            POSTNV ('SS_Save', 'true'); \r\n"
-        "        } \r\n"
-        " \r\n"
-        "        // called to upload a new magnetic declination,"
-        "       // either with Set (k==0) or by typing Enter (k==1) \r\n"
-        "        function onDecl(k) { \r\n"
-        "            if (k && this.event.keyCode != 13) \r\n"
-        "                return;        // wait for Enter \r\n"
-        "            var decl = byId ('Decl').value.trim(); \r\n"
-        "            POSTNV ('Decl', decl); \r\n"
-        "        } \r\n"
-        " \r\n"
-    ));
-    client.print (F(
-        "        // called to display the current magnetic declination."  
-        "        // N.B. leave text alone if it or Set currently has focus \r\n"
-        "        function setNewDecl(decl) { \r\n"
-        "            var decl_text = byId('Decl'); \r\n"
-        "            var decl_set  = byId('Decl-set'); \r\n"
-        "            var focus = document.activeElement; \r\n"
-        "            if (focus != decl_text && focus != decl_set) \r\n"
-        "                decl_text.value = decl; \r\n"
-        "        } \r\n"
-        " \r\n"
-        "        // called to set visibility of SS_Save \r\n"
-        "        function setSSSave (whether) { \r\n"
-        "            var sid = byId ('SS_Save'); \r\n"
-        "            sid.style.visibility = (whether == 'true') ? 'visible' : 'hidden'; \r\n"
-        "        } \r\n"
-        " \r\n"
-        "        // send command to reboot the ESP32 then reload our page after a short while  \r\n"
-        "        function onReboot() { \r\n"
-        "            if (confirm('Are you sure you want to reboot the ESP32?')) { \r\n"
-        " \r\n"
-        "                var xhr = new XMLHttpRequest(); \r\n"
-        "                xhr.open ('POST', UniqURL('/reboot'), true); \r\n"
-        "                xhr.send (); \r\n"
-        " \r\n"
-        "                byId ('op_message').style.color = 'red'; \r\n"
-        " \r\n"
-        "                function reloadMessage (n) { \r\n"
-        "                    var msg = 'This page will reload in ' + n + ' second' + ((n == 1) ? '' : 's'); \r\n"
-        "                    byId ('op_message').innerHTML = msg; \r\n"
-        "                    if (n == 0) \r\n"
-        "                        location.reload(); \r\n"
-        "                    else \r\n"
-        "                        setTimeout (function() {reloadMessage(n-1);}, 1000); \r\n"
-        "                } \r\n"
-        "                reloadMessage(10); \r\n"
-        "            } \r\n"
-        "        } \r\n"
-        " \r\n"
-    ));
-    client.print (F(
-        "       // query for new values forever \r\n"
-        "       function queryNewValues() { \r\n"
-        "           var xhr = new XMLHttpRequest(); \r\n"
-        "           xhr.onreadystatechange = function() { \r\n"
-        "               if (xhr.readyState==4 && xhr.status==200) { \r\n"
-        "                   var lines = xhr.responseText.replace(/\\r/g,'').split('\\n'); \r\n"
-        "                   for (var i = 0; i < lines.length; i++) { \r\n"
-        "                       console.log('getvalues line ' + i + ': ' + lines[i]); \r\n"
-        "                       var nv = lines[i].trim().split('='); \r\n"
-        "                       if (nv.length != 2) \r\n"
-        "                           continue; \r\n"
-        "                       var id = byId (nv[0]); \r\n"
-        "                       if (nv[0] == 'SS_Save') { \r\n"
-        "                           setSSSave(nv[1]); \r\n"
-        "                       } else if (nv[0] == 'Decl') { \r\n"
-        "                           setNewDecl(nv[1]); \r\n"
-        "                       } else { \r\n"
-        "                           var l = nv[1].length; \r\n"
-        "                           if (nv[1].substr(l-1) == '!') { \r\n"
-        "                               id.innerHTML = nv[1].substr(0,l-1); \r\n"
-        "                               id.style.color = 'red'; \r\n"
-        "                           } else if (nv[1].substr(l-1) == '+') { \r\n"
-        "                               id.innerHTML = nv[1].substr(0,l-1); \r\n"
-        "                               id.style.color = '#297'; \r\n"
-        "                           } else { \r\n"
-        "                               // normal \r\n"
-        "                               id.innerHTML = nv[1]; \r\n"
-        "                               id.style.color = 'black'; \r\n"
-        "                           } \r\n"
-        "                       } \r\n"
-        "                   } \r\n"
-        " \r\n"
-        "                   // repeat after a short breather \r\n"
-        "                   setTimeout (queryNewValues, 750); \r\n"
-        "               } \r\n"
-        "           } \r\n"
-        "           xhr.open('GET', UniqURL('/getvalues.txt'), true); \r\n"
-        "           xhr.send(); \r\n"
-        "       } \r\n"
-        " \r\n"
-    ));
-    client.print (F(
-        "    </script>  \r\n"
-    ));
-}
-
-/*! @brief print the top table section of the HTML page
-*
-* @param client a reference to the calling WiFi client
-*
-*/
-void Webpage::printHTMLTopTable(WiFiClient client)
-{
-    client.print (F(
-        "   <table> \r\n"
-        "       <tr> \r\n"
-        "           <td id='title-row' colspan='7' > \r\n"
-        "               <table style='border:none;' width='100%'> \r\n"
-        "                   <tr> \r\n"
-        "                       <td width='25%' style='text-align:left; border:none' > \r\n"
-        "                           Magnetic Declination: \r\n"
-        "                           <input id='Decl' type='text' onkeypress='onDecl(1)'  class='override' > </input> \r\n"
-        "                           <button id='Decl-set' onclick='onDecl(0)'>Set</button> \r\n"
-        "                       </td> \r\n"
-        "                       <td width='50%' style='border:none' > \r\n"
-        "                           <label id='title-label' title='Version 20200527' >Gimbal Diagnostics</label> \r\n"
-        "                       </td> \r\n"
-        "                       <td width='25%' style='text-align:right; border:none' > \r\n"
-        "                           <button id='reboot_b' onclick='onReboot()'> Reboot ESP32 </button> \r\n"
-        "                           <br> \r\n"
-        "                       </td> \r\n"
-        "                   </tr> \r\n"
-        "                   <tr> \r\n"
-        "                       <td colspan='3' width='100%' style='text-align:center; border:none'> \r\n"
-        "                           <label id='rotctl_message' > Hello </label> \r\n"
-        "                       </td> \r\n"
-        "                   </tr> \r\n"
-        "               </table> \r\n"
-        "           </td> \r\n"
-        "       </tr> \r\n"
-        " \r\n"
-    ));
-}
-
-/*! @brief print the Sensor table section of the HTML page
-*
-* @param client a reference to the calling WiFi client
-*
-*/
-
-void Webpage::printHTMLSensorTable (WiFiClient client)
+void Webpage::sendNewValues (WiFiClient &client, bool keep_alive)
 {
-    client.print (F(
-        "   <tr> \r\n"
-        "   <td colspan='7' style='text-align:left; border: none; ' > \r\n"
-        "       <table> \r\n"
-        "           <tr> \r\n"
-        "               <td></td> \r\n"
-        "               <th colspan='3' scope='col'>Measurement</th> \r\n"
-        "               <th colspan='2' scope='col'>Cal Status 0..3</th> \r\n"
-        "               <th colspan='2' scope='col'>Self-test</th> \r\n"
-        "           </tr>"
-        " \r\n"
-        "           <tr class='minor-section even-row' > \r\n"
-        "               <th rowspan='4' class='group-head' > \r\n"
-        "                       Spatial sensor \r\n"
-        "                   <br> \r\n"
-        "                   <label id='SS_Status'></label> \r\n"
-        "                   <br> \r\n"
-        "                   <button id='SS_Save' onclick='onSSSave()' > Save Cal </button> \r\n"
-        "               </th> \r\n"
-        " \r\n"
-        "               <td class='datum-label' > Azimuth, &deg; E of N </td> \r\n"
-        "               <td id='SS_Az' class='datum' width = 50 > </td> \r\n"
-        "               <td width = 10></td> \r\n"
-        "               <td class='datum-label' > System </td> \r\n"
-        "               <td id='SS_SCal' class='datum' width = 20 >-</td> \r\n"
-        "               <td id='SS_STSStatus' class='datum' >----</td> \r\n"
-        "               <td width = 10></td> \r\n"
-        "           </tr> \r\n"
-        "           <tr class='odd-row' > \r\n"
-        "               <td class='datum-label' > Elevation, &deg; Up </td> \r\n"
-    ));
-    client.print (F(
-        "               <td id='SS_El' class='datum'  width = 50> </td> \r\n"
-        "               <td width = 10></td> \r\n"
-        "               <td class='datum-label' > Gyro </td> \r\n"
-        "               <td id='SS_GCal' class='datum' width = 20 >-</td> \r\n"
-        "               <td id='SS_STGStatus' class='datum' >----</td> \r\n"
-        "               <td width = 10></td> \r\n"
-        "           </tr> \r\n"
-        "           <tr class='even-row' > \r\n"
-        "               <td class='datum-label' > Temperature, &deg;C </td> \r\n"
-        "               <td id='SS_Temp' class='datum' width = 50>-</td> \r\n"
-        "               <td width = 10></td> \r\n"
-        "               <td class='datum-label' > Magnetometer </td> \r\n"
-        "               <td id='SS_MCal' class='datum' width = 20 >-</td> \r\n"
-        "               <td id='SS_STMStatus' class='datum' >----</td> \r\n"
-        "               <td width = 10></td> \r\n"
-        "          </tr> \r\n"
-        "          <tr class='odd-row' > \r\n"
-        "               <td class='datum-label' > WiFi signal RSSI (dBm) </td> \r\n"
-        "               <td id='SS_wifi' class='datum' width = 50> </td> \r\n"
-        "               <td width = 10></td> \r\n"
-        "               <td class='datum-label' > Accelerometer </td> \r\n"
-        "               <td id='SS_ACal' class='datum' width = 20 >-</td> \r\n"
-        "               <td id='SS_STAStatus' class='datum' >----</td> \r\n"
-        "               <td width = 10></td> \r\n"
-        "           </tr> \r\n"
-        "           <tr class='even-row' > \r\n"
-        "               <th rowspan='1' class='group-head' > \r\n"
-        "               </th> \r\n"
-        "               <td colspan='5' style='text-align:center; border:none'> \r\n"
-        "                   <label id='op_message' > Hello </label> \r\n"
-        "               </td> \r\n"
-        "           </tr> \r\n"
-        "       </table> \r\n"
-        "       </td> \r\n"
-        "   </tr> \r\n"
-        " \r\n"
-    ));
+    //< render into the buffer pushValues() renders into next, so its previous values stay put
+    Response _r (values[cur_values], VALUES_SIZE);
+    buildValues (_r);
+    sendHeader (client, "200 OK", "text/plain", _r.length(), false, keep_alive);
+    client.write ((const uint8_t *)_r.text(), _r.length());
 }
 
-/*! @brief print the Gimbal table section of the HTML page
-*
-* @param client a reference to the calling WiFi client
-*
-*/
-void Webpage::printHTMLGimbalTable (WiFiClient client)
+/*! @brief inform each subsystem to add its latest values as NAME=VALUE lines, including ours
+* @param r the response to add to
+ */
+void Webpage::buildValues (Response &r)
 {
-    client.print(F(
-        "   <!-- N.B. beware that some ID's are used in a match in onOvd() --> \r\n"
-        "   <tr> \r\n"
-        "   <td colspan='7' style='text-align:left; border: none; ' > \r\n"
-        "      <table> \r\n"
-        "          <tr>"
-        "             <td></td> \r\n"
-        "              <th colspan='2' scope='col'>Servo1</th> \r\n"
-        "              <th colspan='1' scope='col'>override</th> \r\n"
-        "              <th colspan='2' scope='col'>Servo2</th> \r\n"
-        "              <th colspan='1' scope='col'>override</th> \r\n"
-        "          </tr>"
-        " \r\n"
-        "           <tr class='minor-section even-row ' > \r\n"
-        "               <th rowspan='3' class='group-head' > \r\n"
-        "                      Gimbal \r\n"
-        "                  <br> \r\n"
-        "                  <label id='G_Status'></label> \r\n"
-        "                 <br> \r\n"
-        "                  <button id='G_Save' onclick='onGSave()' > Home </button> \r\n"
-        "               </th> \r\n"
-        " \r\n"
-        "               <td class='datum-label' > pulse length, &micro;s </td> \r\n"
-        "               <td id='G_Mot1Pos' class='datum' width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "                   <input id='G_Mot1Pos_Ovd' type='number' onkeypress='onOvd()' class='override' min='600' max='2400' > \r\n"
-        "                   </input> \r\n"
-        "               </td> \r\n"
-        " \r\n"
-        "               <td class='datum-label' > pulse length, &micro;s </td> \r\n"
-        "               <td id='G_Mot2Pos' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "                   <input id='G_Mot2Pos_Ovd' type='number' onkeypress='onOvd()' class='override' min='600' max='2400' > \r\n"
-        "                   </input> \r\n"
-        "               </td> \r\n"
-        "           </tr> \r\n"
-        "           <tr class='odd-row' > \r\n"
-        "               <td class='datum-label' > minimum pulse </td> \r\n"
-        "               <td id='G_Mot1Min' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "                   <input id='G_Mot1Min_Ovd' type='number' onkeypress='onOvd()' class='override' min='600' max='2400' > \r\n"
-        "                   </input> \r\n"
-        "               </td> \r\n"));
-    client.print(F(
-        "               <td class='datum-label' > minimum pulse </td> \r\n"
-        "               <td id='G_Mot2Min' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "                   <input id='G_Mot2Min_Ovd' type='number' onkeypress='onOvd()' class='override' min='600' max='2400' > \r\n"
-        "                   </input> \r\n"
-        "               </td> \r\n"
-        "           </tr> \r\n"
-        "           <tr class='even-row' > \r\n"
-        "               <td class='datum-label' > maximum pulse </td> \r\n"
-        "               <td id='G_Mot1Max' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "                   <input id='G_Mot1Max_Ovd' type='number' onkeypress='onOvd()' class='override' min='600' max='2400' > \r\n"
-        "                   </input> \r\n"
-        "               </td> \r\n"
-        "               <td class='datum-label' > maximum pulse </td> \r\n"
-        "               <td id='G_Mot2Max' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "                   <input id='G_Mot2Max_Ovd' type='number' onkeypress='onOvd()' class='override' min='600' max='2400'> \r\n"
-        "                   </input> \r\n"
-        "               </td> \r\n"
-        "           </tr> \r\n"
-        "           <tr class='odd-row' > \r\n"
-        "               <td> \r\n"
-        "               </td> \r\n"
-        "               <td class='datum-label' > az calibration, &deg;/&micro;s </td> \r\n"
-        "               <td id='G_Mot1AzCal' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "               </td> \r\n"
-        "               <td class='datum-label' > az calibration, &deg;/&micro;s </td> \r\n"
-        "               <td id='G_Mot2AzCal' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "               </td> \r\n"
-        "           </tr> \r\n"
-        "           <tr class='even-row' > \r\n"
-        "               <td> \r\n"
-        "               </td> \r\n"
-        "               <td class='datum-label' > el calibration, &deg;/&micro;s </td> \r\n"
-        "               <td id='G_Mot1ElCal' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "               </td> \r\n"
-        "               <td class='datum-label' > el calibration, &deg;/&micro;s </td> \r\n"
-        "               <td id='G_Mot2ElCal' class='datum'  width = 30 > ---- </td> \r\n"
-        "               <td width = 30 > \r\n"
-        "               </td> \r\n"
-        "           </tr> \r\n"
-        " \r\n"
-        "       </table> \r\n"
-        "   </td> \r\n"
-        " </tr> \r\n"
-        " </table> \r\n"));
+    // send user message
+    r.addf ("op_message", "%s%s", user_message_F ? (const char *)user_message_F : "", user_message_s);
+    r.add ("Decl", nv->mag_decl, 2);
+    r.add ("SS_wifi", (int32_t)WiFi.RSSI());
+    sensor->sendNewValues(r);
+    gimbal->sendNewValues(r);
+    easycomm->sendNewValues(r);
 }
 
 /*! @brief send the main page
 *
-* in turn it will send us commands using XMLHttpRequest
+* in turn it will send us commands using XMLHttpRequest.
+* The page is built into MainPage.h by tools/make_page.py from web/index.html.
 *
 * @param client a reference to the calling WiFi client
-*
+* @param keep_alive whether the connection stays open afterwards
  */
-void Webpage::sendMainPage (WiFiClient client)
+void Webpage::sendMainPage (WiFiClient &client, bool keep_alive)
 {
-    client.print (F(
-        "<!DOCTYPE html> \r\n"
-        "<html> \r\n"
-        "<head> \r\n"
-        "    <meta http-equiv='Content-Type' content='text/html; charset=UTF-8' /> \r\n"
-        " \r\n"
-    ));
-    printHTMLStyle(client);
-    printHTMLScripts(client);
-    client.print (F("</head> \r\n<body> \r\n"));
-    printHTMLTopTable (client);
-    printHTMLSensorTable (client);
-    printHTMLGimbalTable (client);
-    client.print (F("</body> \r\n</html> \r\n"));
+	sendHeader (client, "200 OK", "text/html", sizeof(MAIN_PAGE_GZ), true, keep_alive);
+	client.write (MAIN_PAGE_GZ, sizeof(MAIN_PAGE_GZ));
 }
 
-/*! @brief send HTTP header for plain text content
+/*! @brief send an HTTP response header
 *
 * @param client a reference to the calling WiFi client
-*
+* @param status e.g. "200 OK"
+* @param type content type
+* @param length content length, or -1 if the body runs until the connection closes
+* @param gzip whether the body is gzip-compressed
+* @param keep_alive whether the connection stays open afterwards
+* @param body if not NULL, length bytes to send after the header, in the same write if they fit
 */
-void Webpage::sendPlainHeader (WiFiClient client)
+void Webpage::sendHeader (WiFiClient &client, const char *status, const char *type, int32_t length,
+		bool gzip, bool keep_alive, const uint8_t *body)
 {
-	client.print (F(
-	    "HTTP/1.1 200 OK \r\n"
-	    "Content-Type: text/plain \r\n"
-	    "Connection: close \r\n"
-	    "\r\n"
-	));
+	char _h[256];
+	int _n = snprintf (_h, sizeof(_h), "HTTP/1.1 %s\r\nContent-Type: %s\r\n%s", status, type,
+			gzip ? "Content-Encoding: gzip\r\n" : "");
+	if (length >= 0) {
+	    _n += snprintf (_h + _n, sizeof(_h) - _n, "Content-Length: %d\r\n", length);
+	}
+	_n += snprintf (_h + _n, sizeof(_h) - _n, "Connection: %s\r\n\r\n", keep_alive ? "keep-alive" : "close");
+	if (body && length > 0 && _n + length <= (int32_t)sizeof(_h)) {
+	    memcpy (_h + _n, body, length);
+	    _n += length;
+	    body = NULL;
+	}
+	client.write ((const uint8_t *)_h, _n);
+	if (body && length > 0) {
+	    client.write (body, length);
+	}
 }
 
-/*! @brief send HTTP header for html content
+/*! @brief answer /metrics in Prometheus text format, one write per Metrics part
 *
+* The length is not known up front so the connection closes afterwards.
 * @param client a reference to the calling WiFi client
-*
 */
-void Webpage::sendHTMLHeader (WiFiClient client)
+void Webpage::sendMetrics (WiFiClient &client)
 {
-	client.print (F(
-	    "HTTP/1.1 200 OK \r\n"
-	    "Content-Type: text/html \r\n"
-	    "Connection: close \r\n"
-	    "\r\n"
-	));
+	sendHeader (client, "200 OK", "text/plain; version=0.0.4", -1, false, false);
+	char _buf[FRAME_SIZE];
+	Response _r (_buf, sizeof(_buf));
+	for (uint8_t i = 0; metrics->print (_r, i); i++) {
+	    client.write ((const uint8_t *)_r.text(), _r.length());
+	    _r.clear();
+	}
 }
 
 /*! @brief send empty response
 *
 * @param client a reference to the calling WiFi client
+* @param keep_alive whether the connection stays open afterwards
 *
 */
-void Webpage::sendEmptyResponse (WiFiClient client)
+void Webpage::sendEmptyResponse (WiFiClient &client, bool keep_alive)
 {
-	client.print (F(
-	    "HTTP/1.1 200 OK \r\n"
-	    "Content-Type: text/html \r\n"
-	    "Connection: close \r\n"
-	    "Content-Length: 0 \r\n"
-	    "\r\n"
-	));
+	sendHeader (client, "200 OK", "text/html", 0, false, keep_alive);
 }
 
 /*! @brief send back error 404 when requested page not found.
@@ -782,26 +628,19 @@ void Webpage::sendEmptyResponse (WiFiClient client)
 *  N.B. important for chrome otherwise it keeps asking for favicon.ico
 *
 * @param client a reference to the calling WiFi client
+* @param keep_alive whether the connection stays open afterwards
 *
 */
-void Webpage::send404Page (WiFiClient client)
+void Webpage::send404Page (WiFiClient &client, bool keep_alive)
 {
-	client.print (F(
-	    "HTTP/1.1 404 Not Found \r\n"
-	    "Content-Type: text/html \r\n"
-	    "Connection: close \r\n"
-	    "\r\n"
-	    "<html> \r\n"
-	    "<body> \r\n"
-	    "<h2>404: Not found</h2>\r\n \r\n"
-	    "</body> \r\n"
-	    "</html> \r\n"
-	));
+	static const char _page[] = "<html><body><h2>404: Not found</h2></body></html>\r\n";
+	sendHeader (client, "404 Not Found", "text/html", sizeof(_page)-1, false, keep_alive, (const uint8_t *)_page);
 }
 
 /*! @brief reboot the ESP32
  */
 void Webpage::reboot()
 {
+	nv->flush();
 	ESP.restart();
 }
\ No newline at end of file
@@ -32,11 +32,16 @@
 #define _WEBPAGE_H
 #include <ctype.h>
 #include <WiFi.h>
+#include "Response.h"
 
-#define WIFI_SSID "tigger"				//< WiFi SSID. Change this value
-#define WIFI_PASS "Belridge#117"		//< WiFi password. Change this value
-#define MAX_UNSIGNED_LONG 4294967295ULL	//< maximum value of unsigned long. correct for roll-over
+#ifndef WIFI_SSID
+#define WIFI_SSID "tigger"				//< built-in WiFi SSID, used until one is saved with WP_SSID and WP_Pass
+#endif
+#ifndef WIFI_PASS
+#define WIFI_PASS "Belridge#117"		//< built-in WiFi password
+#endif
 #define TIMEOUT_WIFI 10000				//< time, msec, to wait for WiFi to connect
+#define PUSH_INTERVAL 250				//< default time, msec, between /events frames; set with WP_Push
 
 class Webpage
 {
@@ -50,25 +55,69 @@ class Webpage
 
     private:
 
+	//< one browser connection, kept open between requests for HTTP/1.1 keep-alive
+	typedef struct {
+	    WiFiClient client;
+	    bool open;					// slot in use
+	    bool started;				// some of a request has arrived
+	    bool keep_alive;			// leave open after this request
+	    bool reading_body;			// header done, collecting body
+	    bool streaming;				// answered /events, now only written to by pushValues()
+	    bool need_full;				// stream has not had its first frame yet
+	    bool downloading;			// answering /telemetry.bin a chunk at a time
+	    uint32_t dl_next, dl_end;	// Telemetry sequence numbers still to send
+	    uint16_t dl_sent;			// bytes of record dl_next already written
+	    char request[128];			// first line, e.g. "GET / HTTP/1.1"
+	    char line[128];				// header line being collected
+	    uint8_t ll;					// line length
+	    char body[200];				// NAME=VALUE for POST, enough for a TLE line
+	    uint8_t nbody;
+	    uint16_t body_left;			// Content-Length still to read
+	    uint32_t last;				// millis() of last activity
+	} Connection;
+	static const uint8_t MAX_CLIENTS = 4;			// browsers typically open 2 per tab
+	static const uint16_t KEEP_ALIVE = 5000;		// ms an idle connection stays open
+	static const uint16_t REQUEST_TIMEOUT = 1000;	// ms to wait for the rest of a request
+	static const uint8_t DL_CHUNK = 64;				// most telemetry records written per checkEthernet()
+	Connection conns[MAX_CLIENTS];
+
+	//< event stream state
+	static const uint16_t VALUES_SIZE = 1024;		// room for all of getvalues.txt
+	static const uint16_t FRAME_SIZE = 1536;		// values plus "data: " on each line
+	static const uint16_t MIN_PUSH_INTERVAL = 50;	// ms
+	static const uint16_t HEARTBEAT = 15000;		// ms between comments on an idle stream
+	char values[2][VALUES_SIZE];					// latest and previous rendering
+	uint8_t cur_values;								// which of values[] to render into next
+	char frame[FRAME_SIZE];
+	uint16_t push_interval;
+	uint32_t last_push, last_heartbeat;
+
 	WiFiServer *httpServer;
+	bool use_builtin;								// next join attempt uses WIFI_SSID, not the saved network
+	static const uint16_t REJOIN_DELAY = 2000;		// ms from saving a WiFi password to joining with it
+	uint32_t rejoin_at;								// millis() to join the saved network, 0 if not pending
 	const __FlashStringHelper *user_message_F;
 	char user_message_s[100];
 	const bool DEBUG_WEBPAGE = true;
-    bool is_timed_out(uint32_t startTime_ms, uint32_t time_out_time);
-	void overrideValue (WiFiClient client);
-	void printHTMLStyle (WiFiClient client);
-	void printHTMLSensorTable(WiFiClient client);
-	void printHTMLScripts (WiFiClient client);
-	void printHTMLGimbalTable (WiFiClient client);
-	void printHTMLTopTable (WiFiClient client);
-	char readNextClientChar (WiFiClient client, uint32_t *to);
+	Connection *freeConnection();
+	void resetConnection (Connection &c);
+	void serviceConnection (Connection &c);
+	void answerRequest (Connection &c);
+	void serviceDownload (Connection &c);
+	void overrideValue (char *buf);
 	void reboot();
-	void sendMainPage (WiFiClient client);
-	void sendNewValues (WiFiClient client);
-	void sendPlainHeader (WiFiClient client);
-	void sendHTMLHeader (WiFiClient client);
-	void sendEmptyResponse (WiFiClient client);
-	void send404Page (WiFiClient client);
+	void beginWiFi();
+	void sendMainPage (WiFiClient &client, bool keep_alive);
+	void sendNewValues (WiFiClient &client, bool keep_alive);
+	void sendMetrics (WiFiClient &client);
+	void buildValues (Response &r);
+	void pushValues();
+	uint16_t buildFrame (char *buf, const char *now, const char *prev);
+	static bool hasLine (const char *text, const char *line, size_t len);
+	void sendHeader (WiFiClient &client, const char *status, const char *type, int32_t length,
+			bool gzip, bool keep_alive, const uint8_t *body = NULL);
+	void sendEmptyResponse (WiFiClient &client, bool keep_alive);
+	void send404Page (WiFiClient &client, bool keep_alive);
 
 };
 
@@ -0,0 +1,459 @@
+/*!
+* @brief Replay Easycomm command streams against the firmware and a simulated gimbal, off-target
+*
+* Builds with the native PlatformIO environment:
+*   pio run -e native && .pio/build/native/program [-v] [-s] [-q] stream...
+* -v echoes the firmware's serial replies, -s uses settle-then-step instead of closed-loop tracking,
+* -q makes the BNO055 noise-free, so it reads the same bit for bit whenever the gimbal is still.
+*
+* Each stream is a text file of "<ms> <command line>", ms from the start of the stream, as a
+* serial capture between hamlib's easycomm backend and the rotator would give; '#' starts a
+* comment. The reference path is the AZ/EL targets in the stream, interpolated between commands.
+* The gimbal calibrates first, then each stream runs in turn on simulated time, and the bench
+* reports settle time and pointing error from the plant's true attitude, and the host CPU time
+* of the firmware calls that matter on the target.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "Arduino.h"
+#include "Hal.h"
+#include "Plant.h"
+#include "NV.h"
+#include "Sensor.h"
+#include "Gimbal.h"
+#include "Webpage.h"
+#include "Easycomm.h"
+#include "Tracker.h"
+#include "Scheduler.h"
+#include "Telemetry.h"
+#include "Metrics.h"
+#include "I2CBus.h"
+#include "Power.h"
+
+//< job intervals and priorities as in src/main.cpp
+#define WP_INTERVAL      20
+#define EC_INTERVAL      10
+#define SENSOR_INTERVAL  233
+#define CHECK_SENSOR_INTERVAL   1009
+#define CHECK_PWM_INTERVAL      1009
+#define TRACKER_INTERVAL 101
+#define TRACK_INTERVAL   50
+#define LOOK_AHEAD       300
+#define EC_PRIORITY      5
+#define TRACK_PRIORITY   4
+#define SENSOR_PRIORITY  3
+#define TRACKER_PRIORITY 2
+#define WP_PRIORITY      1
+#define CHECK_SENSOR_PRIORITY   0
+#define CHECK_PWM_PRIORITY      0
+#define NV_INTERVAL      251
+#define NV_PRIORITY      0
+
+//< a configured unit: servo limits set, not yet calibrated
+#define MOT0_MIN         600	///<  pan, usec; about +-80 degrees
+#define MOT0_MAX         2400
+#define MOT1_MIN         1000	///<  tilt, usec; elevation 0..90
+#define MOT1_MAX         2000
+
+#define CAL_TIMEOUT      120000	///<  ms to wait for calibration
+#define LEAD_IN          2000	///<  ms of quiet before each stream
+#define TAIL             10000	///<  ms to keep running after the last command
+#define SETTLE_DEG       1.0	///<  pointing error counted as on target, degrees
+#define SETTLE_HOLD      2000	///<  ms the error must stay under SETTLE_DEG to count as settled
+#define JUMP_DEG         5.0	///<  a target this far from the previous one is a step, to settle on again
+
+Sensor *sensor;
+Webpage *webpage;
+NV *nv;
+Gimbal *gimbal;
+Easycomm *easycomm;
+Tracker *tracker;
+Scheduler *scheduler;
+Telemetry *telemetry;
+Metrics *metrics;
+I2CBus *i2cbus;
+Power *power;
+
+static Plant *plant;
+static bool verbose;
+
+//< host CPU time of one firmware call
+typedef struct {
+	const char *name;
+	uint64_t calls, total_ns, max_ns;
+} Cost;
+enum { COST_MOVE, COST_TRACK, COST_EASYCOMM, COST_READ, N_COSTS };
+static Cost costs[N_COSTS] = {
+	{ "moveToAzEl" }, { "track" }, { "easycomm_process" }, { "readAzElT" },
+};
+
+static uint64_t hostNs()
+{
+	using namespace std::chrono;
+	return (duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+#define TIMED(i, call) do { \
+	    uint64_t _t0 = hostNs(); \
+	    call; \
+	    uint64_t _ns = hostNs() - _t0; \
+	    costs[i].calls++; \
+	    costs[i].total_ns += _ns; \
+	    costs[i].max_ns = max (costs[i].max_ns, _ns); \
+	} while (0)
+
+//< the jobs of src/main.cpp, with the calls of interest timed
+static void serialJob()
+{
+	TIMED (COST_EASYCOMM, easycomm->easycomm_process());
+}
+
+static void trackJob()
+{
+	float _az, _el;
+	if (tracker->target (&_az, &_el) || easycomm->predict (millis() + LOOK_AHEAD, &_az, &_el)) {
+	    TIMED (COST_MOVE, gimbal->moveToAzEl (_az, _el));
+	}
+	TIMED (COST_TRACK, gimbal->track());
+	telemetry->record();
+	gimbal->serviceCalibration();
+}
+
+static void trackerJob()
+{
+	tracker->service();
+}
+
+static void webJob()
+{
+	webpage->checkEthernet();
+}
+
+static void sensorJob()
+{
+	TIMED (COST_READ, sensor->readAzElT());
+}
+
+static void checkSensorJob()
+{
+	sensor->checkSensor();
+}
+
+static void checkPwmJob()
+{
+	gimbal->checkOutputs();
+}
+
+static void nvJob()
+{
+	nv->service();
+}
+
+static void plantTick (uint32_t now_us)
+{
+	plant->step (0.001);
+}
+
+/*! @brief hand over whatever the firmware wrote to Serial
+ */
+static void drainSerial()
+{
+	if (verbose && !Serial.tx.empty()) {
+	    fputs (Serial.tx.c_str(), stdout);
+	}
+	Serial.tx.clear();
+}
+
+/*! @brief one millisecond of simulated time: the plant moves, then loop() runs
+ */
+static void tick()
+{
+	halAdvance (1000);
+	power->service();
+	scheduler->run();
+	drainSerial();
+}
+
+//< one line of a stream
+typedef struct {
+	uint32_t t;
+	std::string text;
+} Line;
+
+//< a point on the reference path
+typedef struct {
+	uint32_t t;
+	float az, el;
+	bool jump;							// a step from the point before, not a ramp into it
+} Point;
+
+/*! @brief read a stream file
+* @return false if it can't be read or holds nothing
+*/
+static bool loadStream (const char *path, std::vector<Line> &lines, std::vector<Point> &path_pts)
+{
+	FILE *_fp = fopen (path, "r");
+	if (!_fp) {
+	    perror (path);
+	    return (false);
+	}
+	char _buf[256];
+	while (fgets (_buf, sizeof(_buf), _fp)) {
+	    char *_end;
+	    unsigned long _t = strtoul (_buf, &_end, 10);
+	    if (_end == _buf || _buf[0] == '#') {
+		    continue;
+	    }
+	    while (*_end == ' ' || *_end == '\t') {
+		    _end++;
+	    }
+	    _end[strcspn (_end, "\r\n")] = '\0';
+	    Line _l = { (uint32_t)_t, _end };
+	    lines.push_back (_l);
+	    Point _p = { (uint32_t)_t };
+	    if (sscanf (_end, "AZ%f EL%f", &_p.az, &_p.el) == 2) {
+		    _p.jump = path_pts.empty() || Plant::separation (_p.az, _p.el, path_pts.back().az,
+				    path_pts.back().el) > JUMP_DEG;
+		    path_pts.push_back (_p);
+	    }
+	}
+	fclose (_fp);
+	return (!lines.empty());
+}
+
+/*! @brief the reference path at time t, linear between the commanded points except across a jump
+* @param i index of the point at or before t, kept by the caller as t increases
+*/
+static void reference (const std::vector<Point> &pts, size_t &i, uint32_t t, float *az, float *el)
+{
+	while (i + 1 < pts.size() && pts[i+1].t <= t) {
+	    i++;
+	}
+	if (i + 1 >= pts.size() || pts[i+1].jump) {
+	    *az = pts[i].az;
+	    *el = pts[i].el;
+	    return;
+	}
+	const Point &_a = pts[i], &_b = pts[i+1];
+	float _f = _b.t > _a.t ? (float)(t - _a.t) / (_b.t - _a.t) : 1;
+	if (_f < 0) {
+	    _f = 0;
+	}
+	float _az_a = _a.az, _az_b = _b.az;
+	*az = fmod (_az_a + _f * Gimbal::azDist (_az_a, _az_b) + 360, 360);
+	*el = _a.el + _f * (_b.el - _a.el);
+}
+
+/*! @brief replay one stream and report how the gimbal followed it
+ */
+static bool runStream (const char *name)
+{
+	std::vector<Line> _lines;
+	std::vector<Point> _pts;
+	if (!loadStream (name, _lines, _pts)) {
+	    return (false);
+	}
+	for (uint32_t i = 0; i < LEAD_IN; i++) {
+	    tick();
+	}
+	memset (costs, 0, sizeof(costs));
+	costs[COST_MOVE].name = "moveToAzEl";
+	costs[COST_TRACK].name = "track";
+	costs[COST_EASYCOMM].name = "easycomm_process";
+	costs[COST_READ].name = "readAzElT";
+	uint32_t _cmds0, _rate;
+	metrics->counter (C_EC_COMMANDS, &_cmds0, &_rate);
+	uint32_t _restarts0;
+	metrics->counter (C_SENSOR_RESTART, &_restarts0, &_rate);
+	uint32_t _i2c0 = halI2cTransactions();
+	Metrics::Site _nv0;
+	metrics->site (M_NV_COMMIT, _nv0);
+
+	uint32_t _start = millis();
+	uint32_t _end = _lines.back().t + TAIL;
+	size_t _next = 0;
+	size_t _ref = 0;
+	std::vector<float> _errs;			//< pointing error while tracking, each ms
+	std::vector<uint32_t> _settles;		//< ms to settle after each jump
+	uint32_t _jumps = 0;
+	bool _settling = false;
+	uint32_t _jump_t = 0;
+	int64_t _in_since = -1;
+	for (uint32_t _t = 0; _t <= _end; _t++) {
+	    while (_next < _lines.size() && _lines[_next].t <= _t) {
+		    const std::string &_s = _lines[_next++].text;
+		    Serial.rx.insert (Serial.rx.end(), _s.begin(), _s.end());
+		    Serial.rx.push_back ('\n');
+	    }
+	    tick();
+	    if (_pts.empty() || _t < _pts[0].t) {
+		    continue;
+	    }
+	    size_t _was = _ref;
+	    float _az, _el;
+	    reference (_pts, _ref, _t, &_az, &_el);
+	    if ((_ref != _was || _t == _pts[0].t) && _pts[_ref].jump) {
+		    //< a new step to settle on, abandoning any still settling
+		    _jumps++;
+		    _settling = true;
+		    _jump_t = _t;
+		    _in_since = -1;
+	    }
+	    float _err = Plant::separation (plant->az(), plant->el(), _az, _el);
+	    if (!_settling) {
+		    _errs.push_back (_err);
+	    } else if (_err < SETTLE_DEG) {
+		    if (_in_since < 0) {
+			    _in_since = _t;
+		    }
+		    if (_t - _in_since >= SETTLE_HOLD) {
+			    _settles.push_back (_in_since - _jump_t);
+			    _settling = false;
+		    }
+	    } else {
+		    _in_since = -1;
+	    }
+	}
+	uint32_t _cmds, _dropped, _restarts;
+	metrics->counter (C_EC_COMMANDS, &_cmds, &_rate);
+	metrics->counter (C_SENSOR_RESTART, &_restarts, &_rate);
+	_restarts -= _restarts0;
+	_cmds -= _cmds0;
+	metrics->counter (C_EC_DROPPED, &_dropped, &_rate);
+
+	printf ("%s: %u commands over %.0f s of simulated time\n", name, _cmds, (millis() - _start) / 1000.0);
+	if (_settles.empty()) {
+	    printf ("  never settled within %.1f deg\n", SETTLE_DEG);
+	} else {
+	    uint32_t _sum = 0;
+	    for (size_t i = 0; i < _settles.size(); i++) {
+		    _sum += _settles[i];
+	    }
+	    printf ("  settled on %u of %u steps within %.1f deg: mean %.1f s, worst %.1f s\n",
+			    (unsigned)_settles.size(), _jumps, SETTLE_DEG, _sum / 1000.0 / _settles.size(),
+			    *std::max_element (_settles.begin(), _settles.end()) / 1000.0);
+	}
+	if (!_errs.empty()) {
+	    double _sq = 0;
+	    for (size_t i = 0; i < _errs.size(); i++) {
+		    _sq += _errs[i] * _errs[i];
+	    }
+	    float _rms = sqrt (_sq / _errs.size());
+	    float _max = *std::max_element (_errs.begin(), _errs.end());
+	    std::nth_element (_errs.begin(), _errs.begin() + _errs.size() * 95 / 100, _errs.end());
+	    float _p95 = _errs[_errs.size() * 95 / 100];
+	    printf ("  error once settled: rms %.2f  p95 %.2f  max %.2f deg over %.0f s\n", _rms, _p95, _max,
+			    _errs.size() / 1000.0);
+	}
+	printf ("  %-18s %8s %10s %10s\n", "host cpu", "calls", "mean us", "max us");
+	for (uint8_t i = 0; i < N_COSTS; i++) {
+	    Cost &_c = costs[i];
+	    printf ("  %-18s %8llu %10.2f %10.2f\n", _c.name, (unsigned long long)_c.calls,
+			    _c.calls ? _c.total_ns / 1000.0 / _c.calls : 0, _c.max_ns / 1000.0);
+	}
+	if (_cmds) {
+	    printf ("  easycomm_process per command %.2f us\n", costs[COST_EASYCOMM].total_ns / 1000.0 / _cmds);
+	}
+	printf ("  I2C transactions %.1f per second\n", (halI2cTransactions() - _i2c0) * 1000.0 / (millis() - _start));
+	Metrics::Site _nv;
+	metrics->site (M_NV_COMMIT, _nv);
+	printf ("  NV commits %u\n", _nv.count - _nv0.count);
+	printf ("  sensor restarts %u\n", _restarts);
+	if (_dropped) {
+	    printf ("  %u commands dropped\n", _dropped);
+	}
+	return (true);
+}
+
+int main (int argc, char *argv[])
+{
+	bool _step = false;
+	bool _quiet = false;
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-'; i++) {
+	    if (strcmp (argv[i], "-v") == 0) {
+		    verbose = true;
+	    } else if (strcmp (argv[i], "-s") == 0) {
+		    _step = true;
+	    } else if (strcmp (argv[i], "-q") == 0) {
+		    _quiet = true;
+	    } else {
+		    fprintf (stderr, "usage: %s [-v] [-s] [-q] stream...\n", argv[0]);
+		    return (2);
+	    }
+	}
+	if (i >= argc) {
+	    fprintf (stderr, "usage: %s [-v] [-s] [-q] stream...\n", argv[0]);
+	    return (2);
+	}
+
+	//< bring up as setup() does, on a unit whose servo limits are already set
+	plant = new Plant (!_quiet);
+	halOnTick (plantTick);
+	Serial.begin (115200);
+	metrics = new Metrics();
+	i2cbus = new I2CBus();
+	nv = new NV();
+	nv->get();
+	nv->mot0min = MOT0_MIN;
+	nv->mot0max = MOT0_MAX;
+	nv->mot1min = MOT1_MIN;
+	nv->mot1max = MOT1_MAX;
+	nv->put();
+	sensor = new Sensor();
+	gimbal = new Gimbal();
+	webpage = new Webpage();
+	tracker = new Tracker();
+	easycomm = new Easycomm();
+	telemetry = new Telemetry();
+	power = new Power();
+	sensor->checkSensor();
+	gimbal->setClosedLoop (!_step);
+	scheduler = new Scheduler();
+	scheduler->add ("serial", serialJob, EC_INTERVAL, EC_PRIORITY);
+	scheduler->add ("track", trackJob, TRACK_INTERVAL, TRACK_PRIORITY);
+	scheduler->add ("sensor", sensorJob, SENSOR_INTERVAL, SENSOR_PRIORITY);
+	scheduler->add ("tracker", trackerJob, TRACKER_INTERVAL, TRACKER_PRIORITY);
+	scheduler->add ("web", webJob, WP_INTERVAL, WP_PRIORITY);
+	scheduler->add ("check", checkSensorJob, CHECK_SENSOR_INTERVAL, CHECK_SENSOR_PRIORITY);
+	scheduler->add ("pwm", checkPwmJob, CHECK_PWM_INTERVAL, CHECK_PWM_PRIORITY);
+	scheduler->add ("nv", nvJob, NV_INTERVAL, NV_PRIORITY);
+
+	//< the first target starts calibration
+	uint32_t _t0 = millis();
+	gimbal->moveToAzEl (180, 45);
+	while (gimbal->isCalibrating && millis() - _t0 < CAL_TIMEOUT) {
+	    tick();
+	}
+	if (!gimbal->calibrated() || gimbal->isCalibrating) {
+	    printf ("calibration did not finish in %u s\n", CAL_TIMEOUT / 1000);
+	    return (1);
+	}
+	printf ("calibrated in %.1f s, %s tracking\n", (millis() - _t0) / 1000.0, _step ? "settle-then-step" : "closed-loop");
+
+	int _rc = 0;
+	for (; i < argc; i++) {
+	    if (!runStream (argv[i])) {
+		    _rc = 1;
+	    }
+	}
+	return (_rc);
+}
@@ -0,0 +1,104 @@
+/*!
+* @brief Class to simulate the two-servo gimbal and its BNO055 for the native build
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <math.h>
+#include "Plant.h"
+#include "Hal.h"
+#include "Axis.h"
+
+static const float US_PER_BIT = Motor1::actuator::US_PER_COUNT;	//< PCA9685 at the Gimbal's frequency
+
+/*! @brief class constructor: both shafts centred, pointing south at 45 degrees
+* @param noisy whether the BNO055 adds NOISE
+ */
+Plant::Plant (bool noisy) : rng(1381), noise(0, NOISE), noisy(noisy)
+{
+	pan.channel = Motor1::unit;
+	pan.angle = 0;
+	pan.zero_az = 180;
+	tilt.channel = Motor2::unit;
+	tilt.angle = 0;
+	tilt.zero_el = 45;
+	pan_held = tilt_held = 0;
+	step (0);
+}
+
+/*! @brief move one servo towards its commanded angle
+*
+* An unpowered output (pulse 0) holds where it is.
+* @param s the servo
+* @param held the command the servo last settled on
+* @param dt seconds
+*/
+void Plant::move (Servo &s, float &held, float dt)
+{
+	uint16_t _off = halPwmOff (s.channel);
+	if (_off == 0) {
+	    return;
+	}
+	float _cmd = (_off * US_PER_BIT - CENTER_US) / US_PER_DEG;
+	if (fabs (_cmd - held) >= DEAD_BAND) {
+	    held = _cmd;
+	}
+	float _rate = (held - s.angle) / TAU;
+	if (_rate > MAX_RATE) {
+	    _rate = MAX_RATE;
+	} else if (_rate < -MAX_RATE) {
+	    _rate = -MAX_RATE;
+	}
+	s.angle += _rate * dt;
+}
+
+/*! @brief advance the gimbal and publish what the BNO055 sees
+* @param dt seconds
+*/
+void Plant::step (float dt)
+{
+	move (pan, pan_held, dt);
+	move (tilt, tilt_held, dt);
+	//< Sensor computes az as heading + 180 + declination
+	hal_imu.heading = fmod (az() + 180 + (noisy ? noise (rng) : 0) + 360, 360);
+	hal_imu.pitch = el() + (noisy ? noise (rng) : 0);
+	hal_imu.roll = 0;
+}
+
+/*! @brief true azimuth, degrees 0..360; tilted past the zenith the antenna looks the other way
+ */
+float Plant::az()
+{
+	float _flip = tilt.zero_el + tilt.angle > 90 ? 180 : 0;
+	return (fmod (pan.zero_az + pan.angle + _flip + 720, 360));
+}
+
+/*! @brief true elevation, degrees, never past 90
+ */
+float Plant::el()
+{
+	float _el = tilt.zero_el + tilt.angle;
+	return (_el > 90 ? 180 - _el : _el);
+}
+
+/*! @brief angle between two directions on the sky, degrees
+ */
+float Plant::separation (float az1, float el1, float az2, float el2)
+{
+	const float _r = M_PI / 180;
+	float _c = sin (el1 * _r) * sin (el2 * _r) + cos (el1 * _r) * cos (el2 * _r) * cos ((az1 - az2) * _r);
+	return (acos (_c > 1 ? 1 : (_c < -1 ? -1 : _c)) / _r);
+}
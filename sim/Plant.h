@@ -0,0 +1,60 @@
+/*!
+* @brief Class to simulate the two-servo gimbal and its BNO055 for the native build
+*
+* Motor 0 pans, motor 1 tilts. Each hobby servo follows its pulse width with a dead band,
+* a first-order lag and a slew limit. The BNO055 reports the resulting pointing, plus noise.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _PLANT_H
+#define _PLANT_H
+
+#include <stdint.h>
+#include <random>
+
+class Plant {
+
+    public:
+	//< one hobby servo
+	typedef struct {
+	    uint8_t channel;					// PCA9685 output
+	    float angle;						// shaft, degrees from centre
+	    float zero_az, zero_el;				// pointing with the shaft at centre
+	} Servo;
+	static constexpr float US_PER_DEG = 2000.0 / 180;	// 500..2500 usec is +-90 degrees
+	static const uint16_t CENTER_US = 1500;
+	static constexpr float DEAD_BAND = 0.4;		// degrees the command must move before the servo does
+	static constexpr float TAU = 0.08;			// servo lag, seconds
+	static constexpr float MAX_RATE = 90;		// loaded slew limit, degrees per second
+	static constexpr float NOISE = 0.05;		// BNO055 noise, degrees rms
+
+	Plant (bool noisy = true);
+	void step (float dt);
+	float az();
+	float el();
+	static float separation (float az1, float el1, float az2, float el2);
+
+    private:
+	Servo pan, tilt;
+	float pan_held, tilt_held;			//< command each servo is settled on, for the dead band
+	std::mt19937 rng;
+	std::normal_distribution<float> noise;
+	bool noisy;							//< false for a BNO055 that reads the true attitude exactly
+	void move (Servo &s, float &held, float dt);
+};
+
+#endif // _PLANT_H
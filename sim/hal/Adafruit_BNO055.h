@@ -0,0 +1,77 @@
+/*!
+* @brief Host stand-in for the Adafruit BNO055 library, reporting hal_imu
+*
+* Always fully calibrated, fusion running, self test passed.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _ADAFRUIT_BNO055_H
+#define _ADAFRUIT_BNO055_H
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "Hal.h"
+
+namespace imu {
+    template<uint8_t N> class Vector {
+	private:
+	    double v[N];
+	public:
+	    Vector() { memset (v, 0, sizeof(v)); };
+	    double x() const { return (v[0]); };
+	    double y() const { return (v[1]); };
+	    double z() const { return (v[2]); };
+	    double &operator[] (int i) { return (v[i]); };
+    };
+    class Quaternion {
+	private:
+	    double _w, _x, _y, _z;
+	public:
+	    Quaternion (double w = 1, double x = 0, double y = 0, double z = 0) : _w(w), _x(x), _y(y), _z(z) {};
+	    double w() const { return (_w); };
+	    double x() const { return (_x); };
+	    double y() const { return (_y); };
+	    double z() const { return (_z); };
+	    Quaternion operator* (const Quaternion &q) const {
+		return (Quaternion (_w*q._w - _x*q._x - _y*q._y - _z*q._z, _w*q._x + _x*q._w + _y*q._z - _z*q._y,
+			    _w*q._y - _x*q._z + _y*q._w + _z*q._x, _w*q._z + _x*q._y - _y*q._x + _z*q._w));
+	    };
+    };
+}
+
+class Adafruit_BNO055 {
+    public:
+	typedef enum {
+	    OPERATION_MODE_CONFIG = 0x00, OPERATION_MODE_IMUPLUS = 0x08, OPERATION_MODE_NDOF = 0x0C,
+	} adafruit_bno055_opmode_t;
+	typedef enum {
+	    VECTOR_ACCELEROMETER = 0x08, VECTOR_MAGNETOMETER = 0x0E, VECTOR_GYROSCOPE = 0x14,
+	    VECTOR_EULER = 0x1A, VECTOR_LINEARACCEL = 0x28, VECTOR_GRAVITY = 0x2E,
+	} adafruit_vector_type_t;
+	Adafruit_BNO055 (int32_t sensor_id = -1, uint8_t address = 0x28, TwoWire *wire = &Wire) {};
+	bool begin (adafruit_bno055_opmode_t mode = OPERATION_MODE_NDOF) { return (hal_imu.present); };
+	void setMode (adafruit_bno055_opmode_t mode) {};
+	imu::Vector<3> getVector (adafruit_vector_type_t type);
+	imu::Quaternion getQuat();
+	int8_t getTemp() { return (hal_imu.temperature); };
+	void getSystemStatus (uint8_t *status, uint8_t *self_test, uint8_t *error);
+	void getCalibration (uint8_t *sys, uint8_t *gyro, uint8_t *accel, uint8_t *mag);
+	bool getSensorOffsets (uint8_t *data) { memcpy (data, hal_imu.offsets, sizeof(hal_imu.offsets)); return (true); };
+	void setSensorOffsets (const uint8_t *data) { memcpy (hal_imu.offsets, data, sizeof(hal_imu.offsets)); };
+};
+
+#endif // _ADAFRUIT_BNO055_H
@@ -0,0 +1,40 @@
+/*!
+* @brief Host stand-in for the Adafruit PCA9685 library, writing the simulated PCA9685
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _ADAFRUIT_PWMSERVODRIVER_H
+#define _ADAFRUIT_PWMSERVODRIVER_H
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "Hal.h"
+
+#define PCA9685_MODE1 0x00
+#define MODE1_SLEEP 0x10
+#define MODE1_RESTART 0x80
+#define PCA9685_LED0_ON_L 0x06
+
+class Adafruit_PWMServoDriver {
+    public:
+	Adafruit_PWMServoDriver (uint8_t addr = 0x40, TwoWire &i2c = Wire) {};
+	void begin (uint8_t prescale = 0) {};
+	void setPWMFreq (float freq) {};
+	uint8_t setPWM (uint8_t num, uint16_t on, uint16_t off) { halSetPwm (num, on, off); return (0); };
+};
+
+#endif // _ADAFRUIT_PWMSERVODRIVER_H
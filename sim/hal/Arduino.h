@@ -0,0 +1,157 @@
+/*!
+* @brief Host stand-in for the parts of the Arduino ESP32 core this firmware uses, for the native build
+*
+* Time is simulated: millis(), micros() and delay() run on the clock in Hal.h, not the host's.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _ARDUINO_H
+#define _ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string>
+#include <deque>
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class __FlashStringHelper;
+#define F(x) (reinterpret_cast<const __FlashStringHelper *>(x))
+#define PROGMEM
+#define PSTR(x) (x)
+#define IRAM_ATTR
+
+#define DEC 10
+#define HEX 16
+#define INPUT 0x01
+#define OUTPUT 0x02
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define OPEN_DRAIN 0x10
+#define OUTPUT_OPEN_DRAIN 0x12
+#define HIGH 1
+#define LOW 0
+
+//< the featheresp32 variant's Wire pins, as its pins_arduino.h
+static const uint8_t SDA = 23;
+static const uint8_t SCL = 22;
+
+using std::min;
+using std::max;
+template<class T> T constrain (T a, T l, T h) { return (a < l ? l : (a > h ? h : a)); }
+
+uint32_t millis();
+uint32_t micros();
+void delay (uint32_t ms);
+void delayMicroseconds (uint32_t us);
+void pinMode (uint8_t pin, uint8_t mode);
+int digitalRead (uint8_t pin);
+void digitalWrite (uint8_t pin, uint8_t val);
+
+class String {
+    private:
+	std::string s;
+    public:
+	String (const char *c = "") : s(c) {};
+	String (int v, int base = DEC);
+	String (float v, int digits = 2);
+	String operator+ (const String &o) const { String r; r.s = s + o.s; return (r); };
+	String &operator+= (const String &o) { s += o.s; return (*this); };
+	const char *c_str() const { return (s.c_str()); };
+	unsigned length() const { return (s.length()); };
+};
+
+class Print {
+    public:
+	virtual ~Print() {};
+	virtual size_t write (uint8_t c) = 0;
+	virtual size_t write (const uint8_t *buf, size_t n);
+	size_t write (const char *s) { return (write ((const uint8_t *)s, strlen (s))); };
+	size_t write (const char *s, size_t n) { return (write ((const uint8_t *)s, n)); };
+	size_t printf (const char *fmt, ...);
+	size_t print (const __FlashStringHelper *s) { return (write ((const char *)s)); };
+	size_t print (const char *s) { return (write (s)); };
+	size_t print (const String &s) { return (write (s.c_str())); };
+	size_t print (char c) { return (write ((uint8_t)c)); };
+	size_t print (int v, int base = DEC) { return (print ((long)v, base)); };
+	size_t print (unsigned v, int base = DEC) { return (print ((unsigned long)v, base)); };
+	size_t print (long v, int base = DEC);
+	size_t print (unsigned long v, int base = DEC);
+	size_t print (double v, int digits = 2) { return (printf ("%.*f", digits, v)); };
+	size_t println() { return (write ("\r\n")); };
+	template<class T> size_t println (T v) { return (print (v) + println()); };
+	template<class T> size_t println (T v, int f) { return (print (v, f) + println()); };
+	virtual void flush() {};
+};
+
+class Stream : public Print {
+    public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() { return (-1); };
+	void setTimeout (unsigned long) {};
+};
+
+//< Serial: the bench feeds rx and collects tx
+class HardwareSerial : public Stream {
+    public:
+	std::deque<uint8_t> rx;
+	std::string tx;
+	void begin (unsigned long) {};
+	int available() { return (rx.size()); };
+	int read();
+	size_t write (uint8_t c) { tx += (char)c; return (1); };
+	size_t write (const uint8_t *buf, size_t n) { tx.append ((const char *)buf, n); return (n); };
+	using Print::write;
+	operator bool() { return (true); };
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+    public:
+	void restart();
+	uint32_t getCycleCount();
+	uint32_t getCpuFreqMHz() { return (240); };
+	uint32_t getFreeHeap() { return (200000); };
+	uint64_t getEfuseMac() { return (0x0000a1b2c3d4e5f6ULL); };
+	const char *getSdkVersion() { return ("native"); };
+};
+extern EspClass ESP;
+
+//< the CPU clock only changes what the firmware asks for; Metrics keeps counting host time
+bool setCpuFrequencyMhz (uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+
+#include <time.h>
+#include <sys/time.h>
+void configTime (long gmt_offset, int dst_offset, const char *server1, const char *server2 = NULL,
+		const char *server3 = NULL);
+#include "Hal.h"
+
+#endif // _ARDUINO_H
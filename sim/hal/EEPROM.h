@@ -0,0 +1,42 @@
+/*!
+* @brief Host stand-in for the ESP32 EEPROM library, kept in RAM
+*
+* Starts erased each run, like a new board, unless the bench writes it first.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _EEPROM_H
+#define _EEPROM_H
+
+#include "Arduino.h"
+
+class EEPROMClass {
+    private:
+	uint8_t data[512];
+    public:
+	EEPROMClass() { memset (data, 0xff, sizeof(data)); };
+	bool begin (size_t size) { return (size <= sizeof(data)); };
+	template<class T> T &get (int addr, T &t) { memcpy ((void *)&t, data + addr, sizeof(T)); return (t); };
+	template<class T> const T &put (int addr, const T &t) { memcpy (data + addr, (const void *)&t, sizeof(T)); return (t); };
+	bool commit() { return (true); };
+	uint8_t read (int addr) { return (data[addr]); };
+	void write (int addr, uint8_t v) { data[addr] = v; };
+	size_t length() { return (sizeof(data)); };
+};
+extern EEPROMClass EEPROM;
+
+#endif // _EEPROM_H
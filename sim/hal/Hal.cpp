@@ -0,0 +1,483 @@
+/*!
+* @brief Host implementations behind the native build's stand-in Arduino, FreeRTOS, Wire and device headers
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <vector>
+#include "Arduino.h"
+#include "Wire.h"
+#include "EEPROM.h"
+#include "WiFi.h"
+#include "Adafruit_BNO055.h"
+#include "Adafruit_PWMServoDriver.h"
+#include "Hal.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+TwoWire Wire;
+TwoWire Wire1 (1);
+EEPROMClass EEPROM;
+WiFiClass WiFi;
+HalImu hal_imu = { 0, 0, 0, 25, { 0 }, true };
+
+//< simulated clock
+static uint64_t now_us;
+static std::vector<HalTick> ticks;
+
+/*! @brief move the simulated clock on, running the tick functions at each whole millisecond
+ */
+void halAdvance (uint32_t us)
+{
+	uint64_t _end = now_us + us;
+	while (now_us < _end) {
+	    uint64_t _next = (now_us / 1000 + 1) * 1000;
+	    if (_next > _end) {
+		    now_us = _end;
+		    break;
+	    }
+	    now_us = _next;
+	    for (size_t i = 0; i < ticks.size(); i++) {
+		    ticks[i] (now_us);
+	    }
+	}
+}
+
+uint64_t halNow()
+{
+	return (now_us);
+}
+
+void halOnTick (HalTick fn)
+{
+	ticks.push_back (fn);
+}
+
+uint32_t millis()
+{
+	return ((uint32_t)(now_us / 1000));
+}
+
+uint32_t micros()
+{
+	return ((uint32_t)now_us);
+}
+
+int64_t esp_timer_get_time()
+{
+	return ((int64_t)now_us);
+}
+
+void delay (uint32_t ms)
+{
+	halAdvance (ms * 1000);
+}
+
+void delayMicroseconds (uint32_t us)
+{
+	halAdvance (us);
+}
+
+//< GPIO: outputs read back what was written, pulled up inputs read high, anything else low
+static uint8_t pin_mode[40], pin_level[40];
+
+void pinMode (uint8_t pin, uint8_t mode)
+{
+	pin_mode[pin] = mode;
+}
+
+//< so the PCA9685 OE reads low, outputs enabled, and an I2C line being cleared reads free
+int digitalRead (uint8_t pin)
+{
+	if (pin_mode[pin] & OUTPUT) {
+	    return (pin_level[pin]);
+	}
+	return ((pin_mode[pin] & PULLUP) ? HIGH : LOW);
+}
+
+void digitalWrite (uint8_t pin, uint8_t val)
+{
+	pin_level[pin] = val;
+}
+
+//< the host keeps its own wall clock
+void configTime (long gmt_offset, int dst_offset, const char *server1, const char *server2,
+		const char *server3)
+{
+}
+
+/*! @brief the host's own time, as cycles of a 240 MHz CPU, so Metrics reports host microseconds
+ */
+uint32_t EspClass::getCycleCount()
+{
+	using namespace std::chrono;
+	uint64_t _ns = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	return ((uint32_t)(_ns * 240 / 1000));
+}
+
+static uint32_t cpu_mhz = 240;
+
+bool setCpuFrequencyMhz (uint32_t mhz)
+{
+	cpu_mhz = mhz;
+	return (true);
+}
+
+uint32_t getCpuFrequencyMhz()
+{
+	return (cpu_mhz);
+}
+
+void EspClass::restart()
+{
+	fprintf (stderr, "ESP.restart() called\n");
+	exit (1);
+}
+
+String::String (int v, int base)
+{
+	char _b[16];
+	snprintf (_b, sizeof(_b), base == HEX ? "%x" : "%d", v);
+	s = _b;
+}
+
+String::String (float v, int digits)
+{
+	char _b[32];
+	snprintf (_b, sizeof(_b), "%.*f", digits, v);
+	s = _b;
+}
+
+String IPAddress::toString() const
+{
+	char _b[16];
+	snprintf (_b, sizeof(_b), "%u.%u.%u.%u", b[0], b[1], b[2], b[3]);
+	return (String (_b));
+}
+
+size_t Print::write (const uint8_t *buf, size_t n)
+{
+	size_t _n = 0;
+	while (n--) {
+	    _n += write (*buf++);
+	}
+	return (_n);
+}
+
+size_t Print::printf (const char *fmt, ...)
+{
+	char _b[256];
+	va_list _ap;
+	va_start (_ap, fmt);
+	int _n = vsnprintf (_b, sizeof(_b), fmt, _ap);
+	va_end (_ap);
+	if (_n < 0) {
+	    return (0);
+	}
+	return (write ((const uint8_t *)_b, min ((size_t)_n, sizeof(_b) - 1)));
+}
+
+size_t Print::print (long v, int base)
+{
+	return (base == HEX ? printf ("%lx", v) : printf ("%ld", v));
+}
+
+size_t Print::print (unsigned long v, int base)
+{
+	return (base == HEX ? printf ("%lx", v) : printf ("%lu", v));
+}
+
+int HardwareSerial::read()
+{
+	if (rx.empty()) {
+	    return (-1);
+	}
+	uint8_t _c = rx.front();
+	rx.pop_front();
+	return (_c);
+}
+
+//< I2C devices
+static const uint8_t PCA9685_ADDR = 0x40;
+static const uint8_t BNO055_ADDR = 0x28;
+static uint8_t pca9685[256];
+static const uint8_t BNO055_OFFSETS = 0x55;	//< where the calibration registers, hal_imu.offsets, start
+static uint32_t i2c_transactions;
+
+uint32_t halI2cTransactions()
+{
+	return (i2c_transactions);
+}
+
+void halSetPwm (uint8_t channel, uint16_t on, uint16_t off)
+{
+	uint8_t *_r = &pca9685[PCA9685_LED0_ON_L + 4 * channel];
+	_r[0] = on & 0xff;
+	_r[1] = on >> 8;
+	_r[2] = off & 0xff;
+	_r[3] = off >> 8;
+}
+
+//< no pulses at all while MODE1 has the oscillator asleep
+uint16_t halPwmOff (uint8_t channel)
+{
+	if (pca9685[PCA9685_MODE1] & MODE1_SLEEP) {
+	    return (0);
+	}
+	uint8_t *_r = &pca9685[PCA9685_LED0_ON_L + 4 * channel];
+	return (_r[2] | _r[3] << 8);
+}
+
+void TwoWire::beginTransmission (uint8_t address)
+{
+	addr = address;
+	have_reg = false;
+}
+
+size_t TwoWire::write (uint8_t c)
+{
+	if (!have_reg) {
+	    reg = c;
+	    have_reg = true;
+	} else if (addr == PCA9685_ADDR) {
+	    pca9685[reg++] = c;
+	} else if (addr == BNO055_ADDR) {
+	    if (reg >= BNO055_OFFSETS && reg < BNO055_OFFSETS + sizeof(hal_imu.offsets)) {
+		    hal_imu.offsets[reg - BNO055_OFFSETS] = c;
+	    }
+	    reg++;
+	}
+	return (1);
+}
+
+size_t TwoWire::write (const uint8_t *buf, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+	    write (buf[i]);
+	}
+	return (n);
+}
+
+//< 0 is success, 2 is address NACK
+uint8_t TwoWire::endTransmission (bool stop)
+{
+	i2c_transactions++;
+	return (addr == PCA9685_ADDR || (addr == BNO055_ADDR && hal_imu.present) ? 0 : 2);
+}
+
+//< what the BNO055 registers read directly, rather than thru the driver, would hold: fused, calibrated and well
+static uint8_t bno055Reg (uint8_t r)
+{
+	switch (r) {
+	case 0x00:					//< chip id
+	    return (0xa0);
+	case 0x36:					//< self test, all passed
+	    return (0x0f);
+	case 0x39:					//< system status, fusion running
+	    return (5);
+	default:
+	    if (r >= BNO055_OFFSETS && r < BNO055_OFFSETS + sizeof(hal_imu.offsets)) {
+		    return (hal_imu.offsets[r - BNO055_OFFSETS]);
+	    }
+	    return (0);
+	}
+}
+
+uint8_t TwoWire::requestFrom (int address, int n)
+{
+	i2c_transactions++;
+	rx.clear();
+	if (address != PCA9685_ADDR && !(address == BNO055_ADDR && hal_imu.present)) {
+	    return (0);
+	}
+	for (int i = 0; i < n; i++) {
+	    rx.push_back (address == PCA9685_ADDR ? pca9685[(uint8_t)(reg + i)] : bno055Reg ((uint8_t)(reg + i)));
+	}
+	return (n);
+}
+
+int TwoWire::read()
+{
+	if (rx.empty()) {
+	    return (-1);
+	}
+	uint8_t _c = rx.front();
+	rx.pop_front();
+	return (_c);
+}
+
+//< both at the BNO055's own resolution, so a still, noise-free mount reads the same bit for bit
+static const float EULER_LSB = 16;			//< per degree
+static const float QUAT_LSB = 16384;		//< per unit
+
+imu::Vector<3> Adafruit_BNO055::getVector (adafruit_vector_type_t type)
+{
+	imu::Vector<3> _v;
+	if (type == VECTOR_EULER) {
+	    _v[0] = roundf (hal_imu.heading * EULER_LSB) / EULER_LSB;
+	    _v[1] = roundf (hal_imu.roll * EULER_LSB) / EULER_LSB;
+	    _v[2] = roundf (hal_imu.pitch * EULER_LSB) / EULER_LSB;
+	}
+	return (_v);
+}
+
+//< the rotation that gives those Euler angles: heading clockwise about up, then pitch and roll
+imu::Quaternion Adafruit_BNO055::getQuat()
+{
+	const double _r = M_PI / 360;			//< half angle, radians
+	imu::Quaternion _h (cos (-hal_imu.heading * _r), 0, 0, sin (-hal_imu.heading * _r));
+	imu::Quaternion _p (cos (-hal_imu.pitch * _r), sin (-hal_imu.pitch * _r), 0, 0);
+	imu::Quaternion _ro (cos (hal_imu.roll * _r), 0, sin (hal_imu.roll * _r), 0);
+	imu::Quaternion _q = _h * _p * _ro;
+	return (imu::Quaternion (round (_q.w() * QUAT_LSB) / QUAT_LSB, round (_q.x() * QUAT_LSB) / QUAT_LSB,
+			round (_q.y() * QUAT_LSB) / QUAT_LSB, round (_q.z() * QUAT_LSB) / QUAT_LSB));
+}
+
+void Adafruit_BNO055::getSystemStatus (uint8_t *status, uint8_t *self_test, uint8_t *error)
+{
+	*status = hal_imu.present ? 5 : 1;		//< 5 is fusion running
+	*self_test = 0x0f;
+	*error = 0;
+}
+
+void Adafruit_BNO055::getCalibration (uint8_t *sys, uint8_t *gyro, uint8_t *accel, uint8_t *mag)
+{
+	*sys = *gyro = *accel = *mag = 3;
+}
+
+//< FreeRTOS: no tasks, so firmware polls from loop() instead
+BaseType_t xTaskCreatePinnedToCore (TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+		UBaseType_t priority, TaskHandle_t *task, BaseType_t core)
+{
+	return (pdFAIL);
+}
+
+BaseType_t xTaskCreate (TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+		UBaseType_t priority, TaskHandle_t *task)
+{
+	return (pdFAIL);
+}
+
+void vTaskDelay (TickType_t ticks)
+{
+	halAdvance (ticks * 1000);
+}
+
+void vTaskDelayUntil (TickType_t *wake, TickType_t period)
+{
+	*wake += period;
+	if ((int32_t)(*wake - millis()) > 0) {
+	    delay (*wake - millis());
+	}
+}
+
+TickType_t xTaskGetTickCount()
+{
+	return (millis());
+}
+
+void vTaskDelete (TaskHandle_t task)
+{
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+	return (NULL);
+}
+
+//< nothing else runs to give a notification, and the bench moves the clock itself, so never waits
+uint32_t ulTaskNotifyTake (BaseType_t clear, TickType_t wait)
+{
+	return (0);
+}
+
+void xTaskNotifyGive (TaskHandle_t task)
+{
+}
+
+BaseType_t xPortGetCoreID()
+{
+	return (1);
+}
+
+typedef struct {
+	UBaseType_t length, item_size;
+	std::deque<std::vector<uint8_t> > items;
+} Queue;
+
+QueueHandle_t xQueueCreate (UBaseType_t length, UBaseType_t item_size)
+{
+	Queue *_q = new Queue;
+	_q->length = length;
+	_q->item_size = item_size;
+	return (_q);
+}
+
+BaseType_t xQueueSend (QueueHandle_t q, const void *item, TickType_t wait)
+{
+	Queue *_q = (Queue *)q;
+	if (_q->items.size() >= _q->length) {
+	    return (pdFALSE);
+	}
+	const uint8_t *_b = (const uint8_t *)item;
+	_q->items.push_back (std::vector<uint8_t>(_b, _b + _q->item_size));
+	return (pdTRUE);
+}
+
+BaseType_t xQueueReceive (QueueHandle_t q, void *item, TickType_t wait)
+{
+	Queue *_q = (Queue *)q;
+	if (_q->items.empty()) {
+	    return (pdFALSE);
+	}
+	memcpy (item, _q->items.front().data(), _q->item_size);
+	_q->items.pop_front();
+	return (pdTRUE);
+}
+
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t q)
+{
+	return (((Queue *)q)->items.size());
+}
+
+BaseType_t xQueueReset (QueueHandle_t q)
+{
+	((Queue *)q)->items.clear();
+	return (pdPASS);
+}
+
+//< one thread, so a lock is always free
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+	static int _token;
+	return (&_token);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+	return (xSemaphoreCreateMutex());
+}
+
+BaseType_t xSemaphoreTake (SemaphoreHandle_t s, TickType_t wait)
+{
+	return (pdTRUE);
+}
+
+BaseType_t xSemaphoreGive (SemaphoreHandle_t s)
+{
+	return (pdTRUE);
+}
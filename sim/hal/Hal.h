@@ -0,0 +1,48 @@
+/*!
+* @brief Controls for the simulated hardware under the native build
+*
+* The bench owns the clock. Advancing it steps whatever is registered with halOnTick(),
+* a millisecond at a time, so delay() inside firmware code moves the plant too.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _HAL_H
+#define _HAL_H
+
+#include <stdint.h>
+
+typedef void (*HalTick)(uint32_t now_us);
+
+void halAdvance (uint32_t us);
+uint64_t halNow();
+void halOnTick (HalTick fn);
+
+//< PCA9685 at I2C 0x40: the bench reads outputs here, Wire and Adafruit_PWMServoDriver write them
+uint16_t halPwmOff (uint8_t channel);
+void halSetPwm (uint8_t channel, uint16_t on, uint16_t off);
+uint32_t halI2cTransactions();				// writes and reads addressed, since boot
+
+//< BNO055 at I2C 0x28: the bench decides what it reports
+typedef struct {
+    float heading, roll, pitch;			// Euler angles as VECTOR_EULER, degrees
+    int8_t temperature;
+    uint8_t offsets[22];				// calibration registers, as getSensorOffsets()
+    bool present;
+} HalImu;
+extern HalImu hal_imu;
+
+#endif // _HAL_H
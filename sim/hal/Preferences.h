@@ -0,0 +1,52 @@
+/*!
+* @brief Host stand-in for the ESP32 Preferences library, kept in RAM
+*
+* Starts erased each run, like a new board.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _PREFERENCES_H
+#define _PREFERENCES_H
+
+#include <map>
+#include <vector>
+#include "Arduino.h"
+
+class Preferences {
+    private:
+	std::map<std::string, std::vector<uint8_t> > keys;
+    public:
+	bool begin (const char *name, bool read_only = false) { return (true); };
+	void end() {};
+	size_t putBytes (const char *key, const void *value, size_t len) {
+	    keys[key].assign ((const uint8_t *)value, (const uint8_t *)value + len);
+	    return (len);
+	};
+	size_t getBytesLength (const char *key) { return (keys.count (key) ? keys[key].size() : 0); };
+	size_t getBytes (const char *key, void *buf, size_t max_len) {
+	    size_t _n = getBytesLength (key);
+	    if (_n == 0 || _n > max_len) {
+		    return (0);
+	    }
+	    memcpy (buf, keys[key].data(), _n);
+	    return (_n);
+	};
+	bool remove (const char *key) { return (keys.erase (key) > 0); };
+	bool clear() { keys.clear(); return (true); };
+};
+
+#endif // _PREFERENCES_H
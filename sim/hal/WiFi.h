@@ -0,0 +1,72 @@
+/*!
+* @brief Host stand-in for the ESP32 WiFi library: never connects, no clients arrive
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _WIFI_H
+#define _WIFI_H
+
+#include "Arduino.h"
+
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+class IPAddress {
+    private:
+	uint8_t b[4];
+    public:
+	IPAddress() { memset (b, 0, sizeof(b)); };
+	IPAddress (uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3) { b[0] = b0; b[1] = b1; b[2] = b2; b[3] = b3; };
+	uint8_t operator[] (int i) const { return (b[i]); };
+	String toString() const;
+};
+
+class WiFiClient : public Stream {
+    public:
+	uint8_t connected() { return (0); };
+	operator bool() { return (false); };
+	int available() { return (0); };
+	int read() { return (-1); };
+	size_t write (uint8_t) { return (1); };
+	size_t write (const uint8_t *, size_t n) { return (n); };
+	using Print::write;
+	int availableForWrite() { return (5744); };	//< lwIP's TCP_SND_BUF on the ESP32
+	void stop() {};
+	int setNoDelay (bool) { return (0); };
+	IPAddress remoteIP() { return (IPAddress()); };
+};
+
+class WiFiServer {
+    public:
+	WiFiServer (uint16_t port = 80, uint8_t max_clients = 4) {};
+	WiFiClient available() { return (WiFiClient()); };
+	void begin() {};
+	void setNoDelay (bool) {};
+};
+
+class WiFiClass {
+    public:
+	int begin (const char *ssid, const char *pass) { return (WL_DISCONNECTED); };
+	bool disconnect (bool wifioff = false) { return (true); };
+	int status() { return (WL_DISCONNECTED); };
+	int RSSI() { return (0); };
+	IPAddress localIP() { return (IPAddress()); };
+	bool setSleep (bool) { return (true); };
+};
+extern WiFiClass WiFi;
+
+#endif // _WIFI_H
@@ -0,0 +1,52 @@
+/*!
+* @brief Host stand-in for the ESP32 Wire library
+*
+* Only the PCA9685 (0x40) and BNO055 (0x28) answer, on either port. The PCA9685 registers
+* are readable so Gimbal::checkOutputs() sees what was written; the BNO055 answers the few
+* registers Sensor reads and writes directly, its status, chip id and calibration offsets.
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _WIRE_H
+#define _WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire : public Stream {
+    private:
+	uint8_t addr;						//< device of the transaction in progress
+	uint8_t reg;						//< register pointer
+	bool have_reg;						//< first byte written this transaction
+	std::deque<uint8_t> rx;
+    public:
+	TwoWire (uint8_t bus = 0) : addr(0), reg(0), have_reg(false) {};
+	bool begin (int sda = -1, int scl = -1, uint32_t freq = 0) { return (true); };
+	void setClock (uint32_t) {};
+	void setTimeOut (uint16_t) {};
+	void beginTransmission (uint8_t address);
+	uint8_t endTransmission (bool stop = true);
+	uint8_t requestFrom (int address, int n);
+	size_t write (uint8_t c);
+	size_t write (const uint8_t *buf, size_t n);
+	using Print::write;
+	int available() { return (rx.size()); };
+	int read();
+};
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif // _WIRE_H
@@ -0,0 +1,31 @@
+/*!
+* @brief Host stand-in for FreeRTOS queues, fixed size items copied in and out
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _QUEUE_H
+#define _QUEUE_H
+
+#include "FreeRTOS.h"
+
+QueueHandle_t xQueueCreate (UBaseType_t length, UBaseType_t item_size);
+BaseType_t xQueueSend (QueueHandle_t q, const void *item, TickType_t wait);
+BaseType_t xQueueReceive (QueueHandle_t q, void *item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t q);
+BaseType_t xQueueReset (QueueHandle_t q);
+
+#endif // _QUEUE_H
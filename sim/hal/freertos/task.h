@@ -0,0 +1,40 @@
+/*!
+* @brief Host stand-in for FreeRTOS tasks: none can be created
+*
+* @section license License
+* Copyright (c) 2020 Tom Driscoll. 
+* Based on code by Elwood Downey found on Clearskyinstitute.com and published in QEX Mar/Apr 2016.
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions: The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED "AS IS",
+* WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN 
+* ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+* OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _TASK_H
+#define _TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore (TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+		UBaseType_t priority, TaskHandle_t *task, BaseType_t core);
+BaseType_t xTaskCreate (TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+		UBaseType_t priority, TaskHandle_t *task);
+void vTaskDelay (TickType_t ticks);
+void vTaskDelayUntil (TickType_t *wake, TickType_t period);
+TickType_t xTaskGetTickCount();
+void vTaskDelete (TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+uint32_t ulTaskNotifyTake (BaseType_t clear, TickType_t wait);
+void xTaskNotifyGive (TaskHandle_t task);
+BaseType_t xPortGetCoreID();
+
+#endif // _TASK_H
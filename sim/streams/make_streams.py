@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Write the bench's sample Easycomm streams.
+
+Each is what the rotator's serial port sees from Gpredict through hamlib's easycomm
+backend: every 1000 ms cycle an "AZ EL" position query, then an "AZxxx.x ELyy.y" target
+20 ms later if the target has moved since the last one sent. Lines are "<ms> <command>".
+A serial capture in the same format replays the same way.
+"""
+
+import math
+import os
+
+R_EARTH = 6371.0
+CYCLE = 1000            # ms, Gpredict's default rotator cycle
+SET_DELAY = 20          # ms from query to target
+THRESHOLD = 0.5         # degrees the target must move before it is sent again
+
+
+def pass_az_el(t, alt, speed, offset, heading):
+    """Az, el of a satellite on a straight ground track, flat track over a round Earth.
+
+    t seconds from closest approach, alt km, ground speed km/s, offset km of closest
+    approach from the station (positive is right of track), heading degrees of travel.
+    """
+    along = speed * t
+    h = math.radians(heading)
+    north = along * math.cos(h) - offset * math.sin(h)
+    east = along * math.sin(h) + offset * math.cos(h)
+    ground = math.hypot(north, east)
+    gamma = ground / R_EARTH
+    el = math.degrees(math.atan2(math.cos(gamma) - R_EARTH / (R_EARTH + alt), math.sin(gamma)))
+    az = math.degrees(math.atan2(east, north)) % 360
+    return az, el
+
+
+def write_pass(name, comment, **orbit):
+    lines = ['# ' + comment]
+    t = -600.0
+    last = None
+    start = None
+    while t <= 600:
+        az, el = pass_az_el(t, **orbit)
+        if el >= 0:
+            if start is None:
+                start = t
+            ms = int(round((t - start) * 1000))
+            lines.append('%d AZ EL' % ms)
+            if last is None or abs(az - last[0]) >= THRESHOLD or abs(el - last[1]) >= THRESHOLD:
+                lines.append('%d AZ%.1f EL%.1f' % (ms + SET_DELAY, az, el))
+                last = (az, el)
+        t += CYCLE / 1000.0
+    save(name, lines)
+
+
+def write_steps(name, comment, targets, hold):
+    lines = ['# ' + comment]
+    ms = 0
+    for az, el in targets:
+        for _ in range(hold):
+            lines.append('%d AZ EL' % ms)
+            lines.append('%d AZ%.1f EL%.1f' % (ms + SET_DELAY, az, el))
+            ms += CYCLE
+    save(name, lines)
+
+
+def save(name, lines):
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), name)
+    with open(path, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+if __name__ == '__main__':
+    write_pass('south_pass.txt', 'LEO pass south of the station, west to east, max el about 50',
+               alt=550, speed=7.0, offset=450, heading=90)
+    write_pass('north_pass.txt', 'LEO pass north of the station, east to west, through az 0',
+               alt=550, speed=7.0, offset=300, heading=270)
+    write_steps('steps.txt', 'step changes held 15 s each, for settle time',
+                [(180, 45), (120, 20), (240, 70), (200, 10), (160, 60)], 15)
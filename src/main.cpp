@@ -37,12 +37,40 @@
 #include "Gimbal.h"
 #include "Easycomm.h"
 #include "UpgradeESP32.h"
+#include "Tracker.h"
+#include "Scheduler.h"
+#include "Telemetry.h"
+#include "Metrics.h"
+#include "I2CBus.h"
+#include "Discovery.h"
+#include "Power.h"
 
 #define BAUDRATE        115200  ///<  Baudrate of Easycomm II protocol
-#define WP_INTERVAL      401     ///<  milliseconds interval for checking WebPage
-#define EC_INTERVAL      50      ///<  milliseconds interval for checking Serial for Easycomm commands
+#define WP_INTERVAL      20      ///<  milliseconds interval for servicing WebPage connections
+#define EC_INTERVAL      10      ///<  milliseconds interval for checking Serial for Easycomm commands
 #define SENSOR_INTERVAL  233 ///<  milliseconds interval for reading Sensor
-#define CHECK_SENSOR_INTERVAL   30017 ///<  milliseconds interval for checking Sensor status
+#define CHECK_SENSOR_INTERVAL   1009 ///<  milliseconds interval for checking Sensor status
+#define CHECK_PWM_INTERVAL      1009  ///<  milliseconds interval for reading back the PCA9685 outputs
+#define NV_INTERVAL      251 ///<  milliseconds interval for committing NV changes once they stop
+#define DISCOVERY_INTERVAL      241 ///<  milliseconds interval for mDNS upkeep and the status beacon
+#define TRACKER_INTERVAL 101 ///<  milliseconds interval for extending the onboard Tracker pass table
+#define TRACK_INTERVAL   50  ///<  milliseconds interval for the closed-loop Gimbal controller
+#define LOOK_AHEAD       300 ///<  milliseconds of Gimbal mechanical latency to aim ahead of host commands
+#define USE_SENSOR_TASK  true  ///<  sample Sensor from its own task on core 0 instead of from loop()
+#define SENSOR_TASK_INTERVAL    50  ///<  milliseconds interval for sampling Sensor when USE_SENSOR_TASK
+#define USE_SERIAL_TASK  true  ///<  receive Easycomm commands in their own task instead of polling from loop()
+#define USE_OTA_TASK     true  ///<  serve firmware uploads from their own task instead of polling from loop()
+
+// Scheduler priorities, higher runs first when several jobs are due
+#define EC_PRIORITY      5  ///<  serial commands must never wait behind a web client
+#define TRACK_PRIORITY   4
+#define SENSOR_PRIORITY  3
+#define TRACKER_PRIORITY 2
+#define WP_PRIORITY      1
+#define CHECK_SENSOR_PRIORITY   0
+#define CHECK_PWM_PRIORITY      0
+#define NV_PRIORITY      0
+#define DISCOVERY_PRIORITY      0
 
 Sensor *sensor;
 Webpage *webpage;
@@ -50,63 +78,121 @@ NV *nv;
 Gimbal *gimbal;
 Easycomm *easycomm;
 UpgradeESP32 *upgradeESP32;
+Tracker *tracker;
+Scheduler *scheduler;
+Telemetry *telemetry;
+Metrics *metrics;
+I2CBus *i2cbus;
+Discovery *discovery;
+Power *power;
+#if GIMBAL_AZ_STEPPER
+Stepper *stepper;
+#endif
+
+// run rotctl commands received on Serial port
+void serialJob() {
+  easycomm->easycomm_process();
+}
+
+// drive the Gimbal towards the latest target, from the onboard Tracker if it is in a pass,
+// else extrapolated from the host's recent commands, and log the tick for post-mortems
+void trackJob() {
+  uint32_t t0 = Metrics::start();
+  float az_t, el_t;
+  if (tracker->target(&az_t, &el_t)) {
+    gimbal->moveToAzEl(az_t, el_t);
+  } else if (easycomm->predict(millis() + LOOK_AHEAD, &az_t, &el_t)) {
+    gimbal->moveToAzEl(az_t, el_t);
+  }
+  gimbal->track();
+  telemetry->record();
+  gimbal->serviceCalibration();
+  metrics->stop(M_TRACK, t0);
+}
+
+// precompute the onboard Tracker's pass table, off the control path
+void trackerJob() {
+  tracker->service();
+}
+
+// check for WiFi activity
+void webJob() {
+  webpage->checkEthernet();
+  upgradeESP32->checkPortServer();
+}
+
+// read Sensor position, Temperature, unless the Sensor task is doing it for us
+void sensorJob() {
+  if (!sensor->taskRunning()) {
+    sensor->readAzElT();
+  }
+}
+
+// read Sensor status
+void checkSensorJob() {
+  sensor->checkSensor();
+}
+
+// confirm the PCA9685 still holds the motor positions
+void checkPwmJob() {
+  gimbal->checkOutputs();
+}
 
-bool is_timed_out(uint32_t start_time, uint32_t time_interval);
-uint32_t previous_time_ec;
-uint32_t previous_time_wp;
-uint32_t previous_time_sensor;
-uint32_t previous_time_check_sensor;
+// write NV to flash once a burst of changes is over
+void nvJob() {
+  nv->service();
+}
+
+// advertise ourselves and beacon our status to the LAN
+void discoveryJob() {
+  discovery->service();
+}
 
 void setup() {
-  previous_time_ec = millis();
-  previous_time_wp = millis();
-  previous_time_sensor = millis();
-  previous_time_check_sensor = millis();
   Serial.begin(BAUDRATE);
   delay(1000);
+  UpgradeESP32::checkBoot();  // before anything new firmware might crash in
+  metrics = new Metrics();    // first, the others count into it from their constructors
+  i2cbus = new I2CBus();      // before the Sensor and Gimbal find their devices
   nv = new NV();
   sensor = new Sensor();
+#if GIMBAL_AZ_STEPPER
+  stepper = new Stepper();    // before the Gimbal, which drives az with it
+#endif
   gimbal = new Gimbal();
   webpage = new Webpage();
   upgradeESP32 = new UpgradeESP32();
+  discovery = new Discovery();
+  tracker = new Tracker();
+  easycomm = new Easycomm();
+  telemetry = new Telemetry();
+  power = new Power();        // after WiFi has started, and the modules it watches
 
   delay(1000);
   sensor->checkSensor();
+  if (USE_SENSOR_TASK) {
+    sensor->startTask(SENSOR_TASK_INTERVAL);
+  }
+  if (USE_SERIAL_TASK) {
+    easycomm->startTask();
+  }
+  if (USE_OTA_TASK) {
+    upgradeESP32->startTask();
+  }
+
+  scheduler = new Scheduler();
+  scheduler->add("serial", serialJob, EC_INTERVAL, EC_PRIORITY);
+  scheduler->add("track", trackJob, TRACK_INTERVAL, TRACK_PRIORITY);
+  scheduler->add("sensor", sensorJob, SENSOR_INTERVAL, SENSOR_PRIORITY);
+  scheduler->add("tracker", trackerJob, TRACKER_INTERVAL, TRACKER_PRIORITY);
+  scheduler->add("web", webJob, WP_INTERVAL, WP_PRIORITY);
+  scheduler->add("check", checkSensorJob, CHECK_SENSOR_INTERVAL, CHECK_SENSOR_PRIORITY);
+  scheduler->add("pwm", checkPwmJob, CHECK_PWM_INTERVAL, CHECK_PWM_PRIORITY);
+  scheduler->add("nv", nvJob, NV_INTERVAL, NV_PRIORITY);
+  scheduler->add("discovery", discoveryJob, DISCOVERY_INTERVAL, DISCOVERY_PRIORITY);
 }
 
 void loop() {
-  if (!gimbal->isCalibrating){
-    // check for rotctl activity on Serial port
-    if (is_timed_out(previous_time_ec, EC_INTERVAL)) {
-      previous_time_ec = millis();
-      easycomm->easycomm_process();
-    }
-    // check for WiFi activity
-    if (is_timed_out(previous_time_wp, WP_INTERVAL)) {
-      previous_time_wp = millis();
-      webpage->checkEthernet();
-      upgradeESP32->checkPortServer();
-    }
-
-    // read Sensor position, Temperature
-    if (is_timed_out(previous_time_sensor, SENSOR_INTERVAL)) {
-      previous_time_sensor = millis();
-      sensor->readAzElT();
-    }
-    // read Sensor status
-    if (is_timed_out(previous_time_check_sensor, CHECK_SENSOR_INTERVAL)) {
-      previous_time_check_sensor = millis();
-      sensor->checkSensor();
-    }
-  }
+  power->service();           // between passes, naps until a job is due
+  scheduler->run();
 }
-
-bool is_timed_out(uint32_t startTime_ms, uint32_t time_out_time) {
-  uint32_t delta_time = millis() - startTime_ms;
-  if (delta_time < 0) {
-    // rolled-over since we started! startTime_ms is really big, millis() is very small.
-    // delta_time is negative, have to add the maximum unsigned long
-    delta_time += MAX_UNSIGNED_LONG;
-  }
-  return (delta_time > time_out_time);
-}
\ No newline at end of file
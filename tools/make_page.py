@@ -0,0 +1,61 @@
+"""Build lib/Webpage/MainPage.h from web/index.html.
+
+The page is minified and gzip-compressed into a const array so Webpage can send it
+with one write and a Content-Encoding: gzip header.
+
+Runs before every PlatformIO build (extra_scripts = pre:tools/make_page.py) and only
+rewrites the header when index.html has changed. Can also be run by hand:
+    python tools/make_page.py
+"""
+
+import gzip
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821 -- provided by PlatformIO
+    PROJECT_DIR = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "web", "index.html")
+TARGET = os.path.join(PROJECT_DIR, "lib", "Webpage", "MainPage.h")
+
+
+def minify(html):
+    """Drop comments, indentation and blank lines; keep line breaks so the scripts stay valid."""
+    html = re.sub(r"<!--.*?-->", "", html, flags=re.S)
+    lines = []
+    for line in html.split("\n"):
+        line = line.strip()
+        if not line or line.startswith("//"):
+            continue
+        lines.append(line)
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    if os.path.exists(TARGET) and os.path.getmtime(TARGET) >= os.path.getmtime(SOURCE):
+        return
+    with open(SOURCE, "r", encoding="utf-8") as f:
+        page = minify(f.read()).encode("utf-8")
+    blob = gzip.compress(page, compresslevel=9, mtime=0)
+    rows = []
+    for i in range(0, len(blob), 16):
+        rows.append("    " + ", ".join("0x%02x" % b for b in blob[i:i + 16]) + ",")
+    with open(TARGET, "w", newline="\n") as f:
+        f.write("/*!\n"
+                "* @brief main web page, gzip-compressed\n"
+                "*\n"
+                "* Generated from web/index.html by tools/make_page.py -- edit those, not this.\n"
+                "* %d bytes of minified html, %d compressed.\n"
+                "*/\n\n"
+                "#ifndef _MAINPAGE_H\n"
+                "#define _MAINPAGE_H\n\n"
+                "#include <pgmspace.h>\n\n"
+                "static const uint8_t MAIN_PAGE_GZ[] PROGMEM = {\n" % (len(page), len(blob)))
+        f.write("\n".join(rows))
+        f.write("\n};\n\n#endif // _MAINPAGE_H\n")
+
+
+main()